@@ -8,6 +8,8 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
@@ -122,6 +124,62 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Blurs a 4K (3840x2160) raster image directly, so the whole image goes through the CPU blur no
+// matter the size of the bench canvas. 'approximate' turns on SkGraphics::SetApproximateLargeBlurs.
+class BlurImageFilter4KBench : public Benchmark {
+public:
+    BlurImageFilter4KBench(SkScalar sigma, bool approximate = false)
+        : fSigma(sigma)
+        , fApproximate(approximate) {
+        fName.printf("blur_image_filter_4k_%g%s", SkScalarToFloat(sigma),
+                     approximate ? "_approx" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (!fImage) {
+            fImage = SkImage::MakeFromBitmap(make_checkerboard(3840, 2160));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        sk_sp<SkImageFilter> filter = SkImageFilters::Blur(fSigma, fSigma, nullptr);
+        const SkIRect subset = SkIRect::MakeWH(fImage->width(), fImage->height());
+        SkIRect outSubset;
+        SkIPoint offset;
+        bool wasApproximate = SkGraphics::SetApproximateLargeBlurs(fApproximate);
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> blurred = fImage->makeWithFilter(filter.get(), subset, subset,
+                                                            &outSubset, &offset);
+        }
+        SkGraphics::SetApproximateLargeBlurs(wasApproximate);
+    }
+
+private:
+    SkString fName;
+    SkScalar fSigma;
+    bool fApproximate;
+    sk_sp<SkImage> fImage;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurImageFilter4KBench(1);)
+DEF_BENCH(return new BlurImageFilter4KBench(3);)
+DEF_BENCH(return new BlurImageFilter4KBench(10);)
+DEF_BENCH(return new BlurImageFilter4KBench(30);)
+DEF_BENCH(return new BlurImageFilter4KBench(100);)
+DEF_BENCH(return new BlurImageFilter4KBench(30, true);)
+DEF_BENCH(return new BlurImageFilter4KBench(100, true);)
+
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, 0, false, false, false);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_SMALL, 0, false, false, false);)
 DEF_BENCH(return new BlurImageFilterBench(0, BLUR_SIGMA_LARGE, false, false, false);)
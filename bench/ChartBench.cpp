@@ -9,6 +9,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkString.h"
 #include "include/private/SkTDArray.h"
 #include "include/utils/SkRandom.h"
 
@@ -88,20 +89,20 @@ static void gen_paths(const SkTDArray<SkScalar>& topData,
 // filling
 class ChartBench : public Benchmark {
 public:
-    ChartBench(bool aa) {
+    // A dense chart places a data point on every pixel column instead of every kPixelsPerTick,
+    // which is dominated by stroking the plot lines.
+    ChartBench(bool aa, bool dense = false) {
         fShift = 0;
         fAA = aa;
+        fPixelsPerTick = dense ? 1 : kPixelsPerTick;
         fSize.fWidth = -1;
         fSize.fHeight = -1;
+        fName.printf("chart_%s%s", aa ? "aa" : "bw", dense ? "_dense" : "");
     }
 
 protected:
     const char* onGetName() override {
-        if (fAA) {
-            return "chart_aa";
-        } else {
-            return "chart_bw";
-        }
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -115,7 +116,7 @@ protected:
 
         SkScalar height = SkIntToScalar(fSize.fHeight);
         if (sizeChanged) {
-            int dataPointCount = SkMax32(fSize.fWidth / kPixelsPerTick + 1, 2);
+            int dataPointCount = SkMax32(fSize.fWidth / fPixelsPerTick + 1, 2);
 
             SkRandom random;
             for (int i = 0; i < kNumGraphs; ++i) {
@@ -152,7 +153,7 @@ protected:
                           prevData,
                           height,
                           0,
-                          SkIntToScalar(kPixelsPerTick),
+                          SkIntToScalar(fPixelsPerTick),
                           fShift,
                           &plotPath,
                           &fillPath);
@@ -181,6 +182,8 @@ private:
     SkISize             fSize;
     SkTDArray<SkScalar> fData[kNumGraphs];
     bool                fAA;
+    int                 fPixelsPerTick;
+    SkString            fName;
 
     typedef Benchmark INHERITED;
 };
@@ -189,3 +192,5 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+DEF_BENCH( return new ChartBench(true, true); )
+DEF_BENCH( return new ChartBench(false, true); )
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkContourMeasure.h"
+#include "include/core/SkPath.h"
+#include "include/utils/SkRandom.h"
+
+// Samples the position and tangent at evenly spaced distances along a long curvy contour, as
+// text-on-path and motion-path clients do, either one getPosTan() at a time or as one batch.
+class ContourMeasurePosTanBench : public Benchmark {
+public:
+    ContourMeasurePosTanBench(bool batch) : fBatch(batch) {}
+
+protected:
+    const char* onGetName() override {
+        return fBatch ? "contour_measure_postan_batch" : "contour_measure_postan";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPath path;
+        path.moveTo(0, 0);
+        for (int i = 0; i < 200; ++i) {
+            SkPoint pts[3];
+            for (SkPoint& pt : pts) {
+                pt.set(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000));
+            }
+            if (i & 1) {
+                path.cubicTo(pts[0], pts[1], pts[2]);
+            } else {
+                path.quadTo(pts[0], pts[1]);
+            }
+        }
+        fMeasure = SkContourMeasureIter(path, false).next();
+
+        for (int i = 0; i < kSamples; ++i) {
+            fDistances[i] = fMeasure->length() * i / (kSamples - 1);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fBatch) {
+                (void)fMeasure->getPosTan(fDistances, kSamples, fPos, fTan);
+            } else {
+                for (int j = 0; j < kSamples; ++j) {
+                    (void)fMeasure->getPosTan(fDistances[j], &fPos[j], &fTan[j]);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int kSamples = 5000;
+
+    bool                    fBatch;
+    sk_sp<SkContourMeasure> fMeasure;
+    SkScalar                fDistances[kSamples];
+    SkPoint                 fPos[kSamples];
+    SkVector                fTan[kSamples];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ContourMeasurePosTanBench(false); )
+DEF_BENCH( return new ContourMeasurePosTanBench(true); )
@@ -436,6 +436,57 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Dashes a long, curvy path, so the dashed geometry runs to tens of thousands of dashes. Fine
+// patterns stress how the dashes are accumulated and stroked more than how they are found.
+class LongDashBench : public Benchmark {
+    SkString fName;
+    SkScalar fStrokeWidth;
+    bool     fDoAA;
+    SkPath   fPath;
+
+    sk_sp<SkPathEffect> fPathEffect;
+
+public:
+    LongDashBench(SkScalar on, SkScalar off, SkScalar strokeWidth, bool doAA) {
+        fName.printf("longdash_%g_%g_%g%s", on, off, strokeWidth, doAA ? "_aa" : "_bw");
+        fStrokeWidth = strokeWidth;
+        fDoAA = doAA;
+
+        const SkScalar intervals[] = { on, off };
+        fPathEffect = SkDashPathEffect::Make(intervals, SK_ARRAY_COUNT(intervals), 0);
+
+        // A spiral of cubics, wound from the middle of a 640x480 canvas outwards.
+        const SkScalar cx = 320, cy = 240;
+        fPath.moveTo(cx, cy);
+        for (int i = 1; i <= 200; ++i) {
+            SkScalar r = i * 1.1f;
+            fPath.cubicTo(cx + r, cy - r, cx + r, cy + r, cx, cy + r);
+            fPath.cubicTo(cx - r, cy + r, cx - r, cy - r, cx, cy - r);
+        }
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(fStrokeWidth);
+        p.setAntiAlias(fDoAA);
+        p.setPathEffect(fPathEffect);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, p);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -483,3 +534,15 @@ DEF_BENCH( return new DashGridBench(1, 1, false); )
 DEF_BENCH( return new DashGridBench(3, 1, true); )
 DEF_BENCH( return new DashGridBench(3, 1, false); )
 #endif
+
+// Aliased, opaque dashes are streamed to the blitter; antialiased ones are dashed in full first.
+DEF_BENCH( return new LongDashBench(1, 1, 0, false); )
+DEF_BENCH( return new LongDashBench(1, 1, 0, true); )
+DEF_BENCH( return new LongDashBench(1, 1, 2, false); )
+DEF_BENCH( return new LongDashBench(1, 1, 2, true); )
+DEF_BENCH( return new LongDashBench(0.5f, 0.5f, 1, false); )
+DEF_BENCH( return new LongDashBench(0.5f, 0.5f, 1, true); )
+DEF_BENCH( return new LongDashBench(20, 10, 0, false); )
+DEF_BENCH( return new LongDashBench(20, 10, 0, true); )
+DEF_BENCH( return new LongDashBench(20, 10, 4, false); )
+DEF_BENCH( return new LongDashBench(20, 10, 4, true); )
@@ -7,6 +7,8 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/effects/SkImageFilters.h"
 #include "tools/Resources.h"
@@ -160,7 +162,76 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Exercise a merge of independent branches (drop shadows, blurs and color filters), as UI layers
+// build them. With a thread pool installed as the default executor the raster backend filters the
+// branches concurrently, so comparing the two variants shows how evaluation scales.
+class ImageFilterWideDAGBench : public Benchmark {
+public:
+    ImageFilterWideDAGBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_wide_dag_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fThreads > 1) {
+            fPool = SkExecutor::MakeFIFOThreadPool(fThreads);
+            SkExecutor::SetDefault(fPool.get());
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fPool) {
+            SkExecutor::SetDefault(nullptr);
+            fPool.reset();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect rect = SkRect::Make(SkIRect::MakeWH(400, 400));
+        SkPaint paint;
+
+        for (int j = 0; j < loops; j++) {
+            // New filters each loop, so results are not served from the image filter cache.
+            sk_sp<SkImageFilter> inputs[kNumInputs];
+            for (int i = 0; i < kNumInputs; ++i) {
+                SkScalar sigma = 2.0f + 3 * i;
+                switch (i % 3) {
+                    case 0:
+                        inputs[i] = SkImageFilters::DropShadow(i, i, sigma, sigma, SK_ColorBLACK,
+                                                               nullptr);
+                        break;
+                    case 1:
+                        inputs[i] = SkImageFilters::Blur(sigma, sigma, nullptr);
+                        break;
+                    default:
+                        inputs[i] = SkImageFilters::ColorFilter(
+                                SkColorFilters::Blend(0x80FF0000, SkBlendMode::kSrcATop),
+                                SkImageFilters::Blur(sigma, sigma, nullptr));
+                        break;
+                }
+            }
+            paint.setImageFilter(SkImageFilters::Merge(inputs, kNumInputs));
+            canvas->drawRect(rect, paint);
+        }
+    }
+
+private:
+    static const int kNumInputs = 6;
+
+    int                         fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fPool;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
+DEF_BENCH(return new ImageFilterWideDAGBench(1);)
+DEF_BENCH(return new ImageFilterWideDAGBench(4);)
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColorFilter.h"
+#include "include/effects/SkImageFilters.h"
+#include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkSpecialImage.h"
+#include "tools/ProcStats.h"
+
+// Filters a huge layer through a blur -> color filter -> blur chain, either in one piece or a
+// tile at a time, and reports the process's peak resident set size afterwards. Peak RSS only
+// ever grows, so run each variant on its own (e.g. --match image_filter_tiling_tiled) to compare
+// them.
+class ImageFilterTilingBench : public Benchmark {
+public:
+    ImageFilterTilingBench(bool tiled) : fTiled(tiled) {}
+
+protected:
+    const char* onGetName() override {
+        return fTiled ? "image_filter_tiling_tiled" : "image_filter_tiling_untiled";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas.drawCircle(kSize / 2, kSize / 2, kSize / 3, paint);
+        fSource = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+
+        fFilter = SkImageFilters::Blur(8, 8,
+                  SkImageFilters::ColorFilter(
+                        SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kSrcIn),
+                        SkImageFilters::Blur(4, 4, nullptr)));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkImageFilter_Base::OutputProperties props(kN32_SkColorType, nullptr);
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                        props);
+        for (int i = 0; i < loops; ++i) {
+            if (fTiled) {
+                as_IFB(fFilter)->filterImageTiled(fSource.get(), ctx, kTileSize,
+                                                  [](SkSpecialImage*, const SkIPoint&,
+                                                     const SkIRect&) {});
+            } else {
+                SkIPoint offset;
+                (void)as_IFB(fFilter)->filterImage(fSource.get(), ctx, &offset);
+            }
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkDebugf("%s: peak RSS %d MB\n", this->getName(), sk_tools::getMaxResidentSetSizeMB());
+    }
+
+private:
+    static constexpr int kSize = 8192;
+    static constexpr int kTileSize = 1024;
+
+    bool                  fTiled;
+    sk_sp<SkSpecialImage> fSource;
+    sk_sp<SkImageFilter>  fFilter;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new ImageFilterTilingBench(true);)
+DEF_BENCH(return new ImageFilterTilingBench(false);)
@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPoint3.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/utils/SkRandom.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
@@ -207,6 +210,93 @@ private:
     typedef LightingBaseBench INHERITED;
 };
 
+// Lights a 1024x1024 raster image directly, so every pixel goes through the CPU lighting code no
+// matter the size of the bench canvas.
+class LightingRasterBench : public LightingBaseBench {
+public:
+    enum Light { kDistant, kPoint, kSpot };
+
+    LightingRasterBench(Light light, bool specular)
+            : INHERITED(false), fLight(light), fSpecular(specular) {
+        static const char* kNames[] = { "distant", "point", "spot" };
+        fName.printf("lighting_raster_%s_%s", kNames[light], specular ? "specular" : "diffuse");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (fImage) {
+            return;
+        }
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(1024, 1024);
+        SkRandom rand;
+        for (int y = 0; y < bitmap.height(); ++y) {
+            for (int x = 0; x < bitmap.width(); ++x) {
+                *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(rand.nextULessThan(256),
+                                                            255, 255, 255);
+            }
+        }
+        fImage = SkImage::MakeFromBitmap(bitmap);
+
+        switch (fLight) {
+            case kDistant:
+                fFilter = fSpecular
+                        ? SkImageFilters::DistantLitSpecular(GetDistantDirection(), GetWhite(),
+                                                             GetSurfaceScale(), GetKs(),
+                                                             GetShininess(), nullptr)
+                        : SkImageFilters::DistantLitDiffuse(GetDistantDirection(), GetWhite(),
+                                                            GetSurfaceScale(), GetKd(), nullptr);
+                break;
+            case kPoint:
+                fFilter = fSpecular
+                        ? SkImageFilters::PointLitSpecular(GetPointLocation(), GetWhite(),
+                                                           GetSurfaceScale(), GetKs(),
+                                                           GetShininess(), nullptr)
+                        : SkImageFilters::PointLitDiffuse(GetPointLocation(), GetWhite(),
+                                                          GetSurfaceScale(), GetKd(), nullptr);
+                break;
+            case kSpot:
+                fFilter = fSpecular
+                        ? SkImageFilters::SpotLitSpecular(GetSpotLocation(), GetSpotTarget(),
+                                                          GetSpotExponent(), GetCutoffAngle(),
+                                                          GetWhite(), GetSurfaceScale(), GetKs(),
+                                                          GetShininess(), nullptr)
+                        : SkImageFilters::SpotLitDiffuse(GetSpotLocation(), GetSpotTarget(),
+                                                         GetSpotExponent(), GetCutoffAngle(),
+                                                         GetWhite(), GetSurfaceScale(), GetKd(),
+                                                         nullptr);
+                break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeWH(fImage->width(), fImage->height());
+        SkIRect outSubset;
+        SkIPoint offset;
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> lit = fImage->makeWithFilter(fFilter.get(), subset, subset,
+                                                        &outSubset, &offset);
+        }
+    }
+
+private:
+    Light fLight;
+    bool fSpecular;
+    SkString fName;
+    sk_sp<SkImage> fImage;
+    sk_sp<SkImageFilter> fFilter;
+
+    typedef LightingBaseBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
@@ -221,3 +311,9 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kDistant, false); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kPoint, false); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kSpot, false); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kDistant, true); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kPoint, true); )
+DEF_BENCH( return new LightingRasterBench(LightingRasterBench::kSpot, true); )
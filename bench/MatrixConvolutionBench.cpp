@@ -5,11 +5,14 @@
  * found in the LICENSE file.
  */
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTileMode.h"
 #include "include/effects/SkImageFilters.h"
+#include "include/private/SkTemplates.h"
 #include "include/utils/SkRandom.h"
 
 #include "tools/ToolUtils.h"
@@ -63,3 +66,78 @@ DEF_BENCH( return new MatrixConvolutionBench(SkTileMode::kRepeat, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkTileMode::kMirror, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkTileMode::kDecal, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkTileMode::kDecal, false); )
+
+// Convolves a 1024x1024 raster image directly with an NxN kernel. A separable kernel (the outer
+// product of two vectors) is applied as a row pass and a column pass; the others tap every weight.
+class MatrixConvolutionSizeBench : public Benchmark {
+public:
+    MatrixConvolutionSizeBench(int size, bool separable) : fSize(size), fSeparable(separable) {
+        fName.printf("matrixconvolution_%dx%d%s", size, size, separable ? "_separable" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        if (fImage) {
+            return;
+        }
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(1024, 1024);
+        SkRandom rand;
+        for (int y = 0; y < bitmap.height(); ++y) {
+            for (int x = 0; x < bitmap.width(); ++x) {
+                *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+            }
+        }
+        fImage = SkImage::MakeFromBitmap(bitmap);
+
+        SkAutoTMalloc<SkScalar> kernel(fSize * fSize);
+        for (int y = 0; y < fSize; ++y) {
+            for (int x = 0; x < fSize; ++x) {
+                // A binomial-like bump, with one weight nudged to break separability.
+                kernel[y * fSize + x] = SkIntToScalar((1 + SkTMin(x, fSize - 1 - x)) *
+                                                      (1 + SkTMin(y, fSize - 1 - y)));
+            }
+        }
+        if (!fSeparable) {
+            kernel[0] += 1;
+        }
+        fFilter = SkImageFilters::MatrixConvolution(SkISize::Make(fSize, fSize), kernel.get(),
+                                                    1.0f / (fSize * fSize * fSize), 0,
+                                                    SkIPoint::Make(fSize / 2, fSize / 2),
+                                                    SkTileMode::kClamp, true, nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect subset = SkIRect::MakeWH(fImage->width(), fImage->height());
+        SkIRect outSubset;
+        SkIPoint offset;
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> filtered = fImage->makeWithFilter(fFilter.get(), subset, subset,
+                                                             &outSubset, &offset);
+        }
+    }
+
+private:
+    SkString fName;
+    int fSize;
+    bool fSeparable;
+    sk_sp<SkImage> fImage;
+    sk_sp<SkImageFilter> fFilter;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MatrixConvolutionSizeBench(3, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(3, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(7, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(7, true); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(15, false); )
+DEF_BENCH( return new MatrixConvolutionSizeBench(15, true); )
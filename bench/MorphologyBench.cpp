@@ -6,7 +6,9 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
@@ -94,3 +96,62 @@ DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
 DEF_BENCH( return new MorphologyBench(0, kErode_MT); )
+
+// Filters a 1024x1024 raster image directly, so the cost per pixel can be compared across radii.
+class MorphologyImageBench : public Benchmark {
+    int            fRadius;
+    MorphologyType fStyle;
+    SkString       fName;
+    sk_sp<SkImage> fImage;
+
+public:
+    MorphologyImageBench(int radius, MorphologyType style) : fRadius(radius), fStyle(style) {
+        fName.printf("morph_image_%d_%s", radius, gStyleName[style]);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bm;
+        bm.allocN32Pixels(1024, 1024);
+        SkRandom rand;
+        for (int y = 0; y < bm.height(); ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                *bm.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+            }
+        }
+        fImage = SkImage::MakeFromBitmap(bm);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        sk_sp<SkImageFilter> filter = kDilate_MT == fStyle
+                                    ? SkImageFilters::Dilate(fRadius, fRadius, nullptr)
+                                    : SkImageFilters::Erode(fRadius, fRadius, nullptr);
+        const SkIRect subset = SkIRect::MakeWH(fImage->width(), fImage->height());
+        SkIRect outSubset;
+        SkIPoint offset;
+        for (int i = 0; i < loops; i++) {
+            sk_sp<SkImage> result = fImage->makeWithFilter(filter.get(), subset, subset,
+                                                           &outSubset, &offset);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MorphologyImageBench(1, kErode_MT); )
+DEF_BENCH( return new MorphologyImageBench(1, kDilate_MT); )
+DEF_BENCH( return new MorphologyImageBench(16, kErode_MT); )
+DEF_BENCH( return new MorphologyImageBench(16, kDilate_MT); )
+DEF_BENCH( return new MorphologyImageBench(64, kErode_MT); )
+DEF_BENCH( return new MorphologyImageBench(64, kDilate_MT); )
+DEF_BENCH( return new MorphologyImageBench(256, kErode_MT); )
+DEF_BENCH( return new MorphologyImageBench(256, kDilate_MT); )
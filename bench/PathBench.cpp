@@ -1242,3 +1242,118 @@ DEF_BENCH( return new CommonConvexBench(200, 16, false, false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, false, true); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  true); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "include/core/SkData.h"
+#include "src/core/SkPathPriv.h"
+
+// Measures reading back a large serialized path, either copying it or referencing the SkData.
+class PathDeserializeBench : public Benchmark {
+    SkString                  fName;
+    SkPathPriv::PointEncoding fEncoding;
+    bool                      fBorrow;
+    sk_sp<SkData>             fData;
+
+public:
+    PathDeserializeBench(SkPathPriv::PointEncoding encoding, const char suffix[], bool borrow)
+            : fEncoding(encoding), fBorrow(borrow) {
+        fName.printf("path_deserialize_%s%s", suffix, borrow ? "_borrow" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkPath path;
+        SkRandom rand;
+        for (int i = 0; i < 1000; ++i) {
+            path.moveTo(rand.nextF()*1000, rand.nextF()*1000);
+            for (int j = 0; j < 10; ++j) {
+                path.lineTo(rand.nextF()*1000, rand.nextF()*1000);
+            }
+            path.quadTo(rand.nextF()*1000, rand.nextF()*1000, rand.nextF()*1000, rand.nextF()*1000);
+            path.close();
+        }
+        fData = SkPathPriv::Serialize(path, fEncoding);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPath path;
+        for (int i = 0; i < loops; ++i) {
+            if (fBorrow) {
+                SkPathPriv::ReadFromData(&path, fData);
+            } else {
+                path.readFromMemory(fData->data(), fData->size());
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathDeserializeBench(SkPathPriv::PointEncoding::kFloat, "float", false); )
+DEF_BENCH( return new PathDeserializeBench(SkPathPriv::PointEncoding::kFloat, "float", true); )
+DEF_BENCH( return new PathDeserializeBench(SkPathPriv::PointEncoding::kHalf, "half", false); )
+DEF_BENCH( return new PathDeserializeBench(SkPathPriv::PointEncoding::kQuantized, "quantized",
+                                           false); )
+
+// Hit-tests the same large path over and over, as an interactive editor would.
+class PathHitTestBench : public Benchmark {
+    SkString fName;
+    int      fContours;
+    SkPath   fPath;
+    SkPoint  fQueries[256];
+    int      fHits = 0;
+
+public:
+    PathHitTestBench(int contours) : fContours(contours) {
+        fName.printf("path_hittest_%d", contours);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < fContours; ++i) {
+            SkScalar cx = rand.nextF()*1000,
+                     cy = rand.nextF()*1000;
+            fPath.moveTo(cx + 20, cy);
+            for (int j = 1; j < 8; ++j) {
+                SkScalar r = j & 1 ? 10 : 20;
+                SkScalar angle = j * SK_ScalarPI / 4;
+                fPath.quadTo(cx + rand.nextF()*10, cy + rand.nextF()*10,
+                             cx + r * SkScalarCos(angle), cy + r * SkScalarSin(angle));
+            }
+            fPath.close();
+        }
+        for (SkPoint& pt : fQueries) {
+            pt.set(rand.nextF()*1000, rand.nextF()*1000);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            for (const SkPoint& pt : fQueries) {
+                fHits += fPath.contains(pt.fX, pt.fY);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathHitTestBench(10); )
+DEF_BENCH( return new PathHitTestBench(1000); )
+DEF_BENCH( return new PathHitTestBench(10000); )
@@ -7,23 +7,34 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 
 class PerlinNoiseBench : public Benchmark {
-    SkISize fSize;
+    SkISize  fSize;
+    int      fOctaves;
+    bool     fStitchTiles;
+    SkString fName;
 
 public:
-    PerlinNoiseBench()  {
+    PerlinNoiseBench(int octaves = 3, bool stitchTiles = false)
+        : fOctaves(octaves)
+        , fStitchTiles(stitchTiles) {
         fSize = SkISize::Make(80, 80);
+        if (3 == octaves && !stitchTiles) {
+            fName = "perlinnoise";
+        } else {
+            fName.printf("perlinnoise_%d%s", octaves, stitchTiles ? "_stitched" : "");
+        }
     }
 
 protected:
     const char* onGetName() override {
-        return "perlinnoise";
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
-        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, 3, 0, false);
+        this->test(loops, canvas, 0, 0, 0.1f, 0.1f, fOctaves, 0, fStitchTiles);
     }
 
 private:
@@ -56,3 +67,8 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PerlinNoiseBench(); )
+DEF_BENCH( return new PerlinNoiseBench(1); )
+DEF_BENCH( return new PerlinNoiseBench(2); )
+DEF_BENCH( return new PerlinNoiseBench(4); )
+DEF_BENCH( return new PerlinNoiseBench(8); )
+DEF_BENCH( return new PerlinNoiseBench(4, true); )
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRegion.h"
+#include "include/utils/SkPictureDamage.h"
+#include "include/utils/SkRandom.h"
+
+// A frame of an animation where a few sprites move over a detailed, still background. The new
+// frame is either drawn in full, or only where it differs from the frame before it.
+class PictureDamageBench final : public Benchmark {
+public:
+    PictureDamageBench(bool damage) : fDamage(damage) {
+        fName.printf("picture_damage_sprites_%s", damage ? "damage" : "full");
+    }
+
+protected:
+    static constexpr int kSize = 1024;
+    static constexpr int kBackgroundOps = 2000;
+    static constexpr int kSprites = 4;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return {kSize, kSize}; }
+
+    sk_sp<SkPicture> recordFrame(int frame) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize);
+        canvas->drawColor(SK_ColorWHITE);
+
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < kBackgroundOps; ++i) {
+            paint.setColor(rand.nextU() | 0xff000000);
+            const SkScalar x = rand.nextRangeScalar(0, kSize - 32),
+                           y = rand.nextRangeScalar(0, kSize - 32);
+            canvas->drawOval(SkRect::MakeXYWH(x, y, 32, 32), paint);
+        }
+
+        paint.setColor(SK_ColorBLACK);
+        for (int i = 0; i < kSprites; ++i) {
+            SkAutoCanvasRestore acr(canvas, true);
+            canvas->translate((frame * (i + 1) * 3) % (kSize - 64), 100 + i * 200);
+            canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(64, 64), 8, 8), paint);
+        }
+        return recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        sk_sp<SkPicture> last = this->recordFrame(fFrame);
+        canvas->clear(SK_ColorTRANSPARENT);
+        canvas->drawPicture(last);
+
+        for (int i = 0; i < loops; ++i) {
+            sk_sp<SkPicture> next = this->recordFrame(++fFrame);
+            if (fDamage) {
+                SkRegion damage;
+                SkPictureDamage::Compute(*last, *next, &damage);
+                SkPictureDamage::Replay(*next, damage, canvas);
+            } else {
+                canvas->clear(SK_ColorTRANSPARENT);
+                canvas->drawPicture(next);
+            }
+            last = std::move(next);
+        }
+    }
+
+private:
+    const bool fDamage;
+    SkString   fName;
+    int        fFrame = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PictureDamageBench(false);)
+DEF_BENCH(return new PictureDamageBench(true);)
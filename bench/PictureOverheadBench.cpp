@@ -6,9 +6,15 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRRect.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/utils/SkRandom.h"
 
 class ClipOverheadRecordingBench : public Benchmark {
 public:
@@ -40,3 +46,72 @@ private:
     }
 };
 DEF_BENCH( return new ClipOverheadRecordingBench; )
+
+// Serializes or deserializes a picture of noisy images, which takes long to encode, optionally
+// with an executor to encode or decode them on.
+class PictureSerializeBench : public Benchmark {
+public:
+    PictureSerializeBench(bool deserialize, bool threaded)
+        : fDeserialize(deserialize), fThreaded(threaded) {}
+
+private:
+    const char* onGetName() override {
+        fName.printf("picture_%s%s", fDeserialize ? "deserialize" : "serialize",
+                     fThreaded ? "_threaded" : "");
+        return fName.c_str();
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+            fSerialProcs.fExecutor = fExecutor.get();
+            fDeserialProcs.fExecutor = fExecutor.get();
+        }
+        // Decode each image fully, as a client drawing it soon would.
+        fDeserialProcs.fImageProc = [](const void* data, size_t size, void*) {
+            sk_sp<SkImage> image = SkImage::MakeFromEncoded(SkData::MakeWithCopy(data, size));
+            return image ? image->makeRasterImage() : nullptr;
+        };
+
+        SkRandom rand;
+        SkPictureRecorder rec;
+        SkCanvas* canvas = rec.beginRecording({0,0, 1024,1024});
+        for (int i = 0; i < 64; i++) {
+            SkBitmap bm;
+            bm.allocN32Pixels(128, 128, true);
+            for (int y = 0; y < bm.height(); y++) {
+                for (int x = 0; x < bm.width(); x++) {
+                    *bm.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+                }
+            }
+            bm.setImmutable();
+            canvas->drawImage(SkImage::MakeFromBitmap(bm), (i % 8) * 128, (i / 8) * 128);
+        }
+        fPicture = rec.finishRecordingAsPicture();
+        fData = fPicture->serialize(&fSerialProcs);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fDeserialize) {
+                (void)SkPicture::MakeFromData(fData.get(), &fDeserialProcs);
+            } else {
+                (void)fPicture->serialize(&fSerialProcs);
+            }
+        }
+    }
+
+    bool                        fDeserialize;
+    bool                        fThreaded;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkSerialProcs               fSerialProcs;
+    SkDeserialProcs             fDeserialProcs;
+    sk_sp<SkPicture>            fPicture;
+    sk_sp<SkData>               fData;
+};
+DEF_BENCH( return new PictureSerializeBench(false, false); )
+DEF_BENCH( return new PictureSerializeBench(false, true); )
+DEF_BENCH( return new PictureSerializeBench(true, false); )
+DEF_BENCH( return new PictureSerializeBench(true, true); )
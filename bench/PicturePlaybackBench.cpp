@@ -11,9 +11,13 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkString.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkRecordDraw.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -95,3 +99,100 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Small pictures like UI widgets get played back over and over.  Once they have been a few times,
+// SkBigPicture plays them with an SkRecordPlan; this compares that with SkRecordDraw() on the same
+// record, over the whole picture and clipped to a corner of it.
+class HotPlaybackBench : public Benchmark {
+public:
+    HotPlaybackBench(bool plan, bool clipped) : fPlan(plan), fClipped(clipped) {
+        fName.printf("hot_playback_%s%s", fPlan ? "plan" : "record", fClipped ? "_clipped" : "");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(256, 256); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(256, 256);
+            SkRandom rand;
+            SkPaint paint;
+            for (int i = 0; i < 50; i++) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->save();
+                    canvas->translate(rand.nextRangeScalar(0, 224), rand.nextRangeScalar(0, 224));
+                    canvas->clipRect(SkRect::MakeWH(32, 32));
+                    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(30, 30), 4, 4), paint);
+                canvas->restore();
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(fPic);
+        SkAutoCanvasRestore ar(canvas, true/*save now*/);
+        if (fClipped) {
+            canvas->clipRect(SkRect::MakeWH(64, 64));
+        }
+        for (int i = 0; i < loops; i++) {
+            if (fPlan) {
+                fPic->playback(canvas);
+            } else {
+                SkRecordDraw(*big->record(), canvas, big->drawablePicts(), nullptr,
+                             big->drawableCount(), nullptr, nullptr);
+            }
+        }
+    }
+
+private:
+    bool             fPlan;
+    bool             fClipped;
+    SkString         fName;
+    sk_sp<SkPicture> fPic;
+};
+
+DEF_BENCH( return new HotPlaybackBench(false, false); )
+DEF_BENCH( return new HotPlaybackBench(true,  false); )
+DEF_BENCH( return new HotPlaybackBench(false, true ); )
+DEF_BENCH( return new HotPlaybackBench(true,  true ); )
+
+// Records a picture of mostly small ops, and reports how much memory the result uses per op.
+// The timing is of recording; the figure to watch is the bytes per op, printed afterwards.
+class RecordBytesPerOpBench : public Benchmark {
+public:
+    const char* onGetName() override { return "record_bytes_per_op"; }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkPoint pts[] = { {0, 0}, {10, 10}, {20, 0}, {30, 10} };
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            SkPictureRecorder recorder;
+            SkCanvas* canvas = recorder.beginRecording(1024, 1024);
+            for (int j = 0; j < kOps / 5; j++) {
+                canvas->save();
+                    canvas->translate(j % 100, j % 97);
+                    canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+                    canvas->drawPoints(SkCanvas::kLines_PointMode, SK_ARRAY_COUNT(pts), pts,
+                                       paint);
+                canvas->restore();
+            }
+            fPic = recorder.finishRecordingAsPicture();
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (fPic) {
+            SkDebugf("%s: %.1f bytes per op over %d ops\n", this->getName(),
+                     (double)fPic->approximateBytesUsed() / fPic->approximateOpCount(),
+                     fPic->approximateOpCount());
+        }
+    }
+
+private:
+    static constexpr int kOps = 10000;
+
+    sk_sp<SkPicture> fPic;
+};
+
+DEF_BENCH( return new RecordBytesPerOpBench; )
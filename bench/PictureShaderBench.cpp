@@ -0,0 +1,78 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkShader.h"
+
+// Draws a picture shader zooming in smoothly, so that nearly every frame is at a new scale, with
+// and without a tile executor. Each zoom uses a new shader, so starts with nothing cached.
+class PictureShaderZoomBench final : public Benchmark {
+public:
+    PictureShaderZoomBench(bool async) : fAsync(async) {
+        fName.printf("picture_shader_zoom%s", async ? "_async" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(128, 128);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 16; ++i) {
+            paint.setColor(0xff000000 | (i * 0x0f1f3f));
+            canvas->drawCircle(8 + (i % 4) * 32.f, 8 + (i / 4) * 32.f, 14, paint);
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+        if (fAsync) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(2);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fPrevExecutor = SkGraphics::SetPictureShaderTileExecutor(fExecutor.get());
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkGraphics::SetPictureShaderTileExecutor(fPrevExecutor);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        static constexpr int kSteps = 64;
+
+        SkPaint paint;
+        for (int i = 0; i < loops; ++i) {
+            if (i % kSteps == 0) {
+                paint.setShader(fPicture->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat));
+            }
+            SkAutoCanvasRestore acr(canvas, true);
+            const SkScalar scale = 1 + 3.f * (i % kSteps) / kSteps;
+            canvas->scale(scale, scale);
+            canvas->drawRect(SkRect::MakeWH(256 / scale, 256 / scale), paint);
+        }
+    }
+
+private:
+    const bool                  fAsync;
+    SkString                    fName;
+    sk_sp<SkPicture>            fPicture;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkExecutor*                 fPrevExecutor = nullptr;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PictureShaderZoomBench(false);)
+DEF_BENCH(return new PictureShaderZoomBench(true);)
@@ -7,6 +7,7 @@
 
 #include "bench/RecordingBench.h"
 #include "include/core/SkBBHFactory.h"
+#include "include/core/SkData.h"
 #include "include/core/SkPictureRecorder.h"
 
 PictureCentricBench::PictureCentricBench(const char* name, const SkPicture* pic) : fName(name) {
@@ -32,20 +33,95 @@ SkIPoint PictureCentricBench::onGetSize() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH)
+RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH,
+                               bool internPaths)
     : INHERITED(name, pic)
     , fUseBBH(useBBH)
-{}
+    , fRecordFlags(internPaths ? SkPictureRecorder::kInternPaths_RecordFlag : 0)
+{
+    if (internPaths) {
+        fName.append("_intern");
+    }
+}
+
+size_t RecordingBench::serializedBytes() const {
+    SkPictureRecorder recorder;
+    fSrc->playback(recorder.beginRecording(fSrc->cullRect(), nullptr, fRecordFlags));
+    return recorder.finishRecordingAsPicture()->serialize()->size();
+}
 
 void RecordingBench::onDraw(int loops, SkCanvas*) {
     SkRTreeFactory factory;
     SkPictureRecorder recorder;
     while (loops --> 0) {
-        fSrc->playback(recorder.beginRecording(fSrc->cullRect(), fUseBBH ? &factory : nullptr));
+        fSrc->playback(recorder.beginRecording(fSrc->cullRect(), fUseBBH ? &factory : nullptr,
+                                               fRecordFlags));
         (void)recorder.finishRecordingAsPicture();
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+
+static const char* pass_name(RecordOptsBench::Pass pass) {
+    switch (pass) {
+        case RecordOptsBench::kNone_Pass:                   return "none";
+        case RecordOptsBench::kNoopRedundantClipRects_Pass: return "clips";
+        case RecordOptsBench::kNoopOverdrawnDraws_Pass:     return "overdraw";
+        case RecordOptsBench::kMergeDrawImageRects_Pass:    return "imagerects";
+        case RecordOptsBench::kOptimize2_Pass:              return "optimize2";
+    }
+    return "";
+}
+
+RecordOptsBench::RecordOptsBench(const char* name, const SkPicture* pic, Pass pass, bool playback)
+    : INHERITED(name, pic)
+    , fPass(pass)
+    , fPlayback(playback)
+{
+    fName.appendf("_opts_%s", pass_name(pass));
+}
+
+RecordOptsBench::~RecordOptsBench() {}
+
+bool RecordOptsBench::isSuitableFor(Backend backend) {
+    return fPlayback ? backend != kNonRendering_Backend : backend == kNonRendering_Backend;
+}
+
+void RecordOptsBench::record(SkRecord* record) const {
+    SkRecorder recorder(record, fSrc->cullRect());
+    fSrc->playback(&recorder);
+    switch (fPass) {
+        case kNone_Pass:                                                   break;
+        case kNoopRedundantClipRects_Pass: SkRecordNoopRedundantClipRects(record); break;
+        case kNoopOverdrawnDraws_Pass:     SkRecordNoopOverdrawnDraws(record);     break;
+        case kMergeDrawImageRects_Pass:    SkRecordMergeDrawImageRects(record);    break;
+        case kOptimize2_Pass:              SkRecordOptimize2(record);              break;
+    }
+    record->defrag();
+}
+
+void RecordOptsBench::onDelayedSetup() {
+    if (fPlayback) {
+        fRecord = sk_make_sp<SkRecord>();
+        this->record(fRecord.get());
+    }
+}
+
+void RecordOptsBench::onDraw(int loops, SkCanvas* canvas) {
+    while (loops --> 0) {
+        if (fPlayback) {
+            SkRecordDraw(*fRecord, canvas, nullptr, nullptr, 0, nullptr, nullptr);
+        } else {
+            SkRecord record;
+            this->record(&record);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "include/core/SkSerialProcs.h"
 
@@ -29,13 +29,51 @@ protected:
 
 class RecordingBench : public PictureCentricBench {
 public:
-    RecordingBench(const char* name, const SkPicture*, bool useBBH);
+    RecordingBench(const char* name, const SkPicture*, bool useBBH, bool internPaths = false);
+
+    // The size of the picture this records, serialized.
+    size_t serializedBytes() const;
+
+protected:
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    bool     fUseBBH;
+    uint32_t fRecordFlags;
+
+    typedef PictureCentricBench INHERITED;
+};
+
+class SkRecord;
+
+// Times an SkRecordOptimize2 pass over the SKP's ops, either along with recording them again or by
+// playing back what's left after it.
+class RecordOptsBench : public PictureCentricBench {
+public:
+    enum Pass {
+        kNone_Pass,
+        kNoopRedundantClipRects_Pass,
+        kNoopOverdrawnDraws_Pass,
+        kMergeDrawImageRects_Pass,
+        kOptimize2_Pass,
+
+        kLast_Pass = kOptimize2_Pass,
+    };
+
+    RecordOptsBench(const char* name, const SkPicture*, Pass, bool playback);
+    ~RecordOptsBench() override;
 
 protected:
+    bool isSuitableFor(Backend) override;
+    void onDelayedSetup() override;
     void onDraw(int loops, SkCanvas*) override;
 
 private:
-    bool fUseBBH;
+    void record(SkRecord*) const;
+
+    Pass            fPass;
+    bool            fPlayback;
+    sk_sp<SkRecord> fRecord;
 
     typedef PictureCentricBench INHERITED;
 };
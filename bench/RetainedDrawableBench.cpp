@@ -0,0 +1,111 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/utils/SkRandom.h"
+#include "include/utils/SkRetainedDrawable.h"
+
+// A frame of an editor making a small edit to a large document: one of many blocks of content
+// changes, and the document is recorded and drawn again. Either the whole document is recorded
+// again and drawn, or only the changed block is recorded again and the area it dirtied is drawn.
+class RetainedDrawableBench final : public Benchmark {
+public:
+    RetainedDrawableBench(bool retained) : fRetained(retained) {
+        fName.printf("retained_drawable_edit_%s", retained ? "retained" : "rerecord");
+    }
+
+protected:
+    static constexpr int kBlocks = 32;  // per side
+    static constexpr int kBlockSize = 32;
+    static constexpr int kOpsPerBlock = 32;
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    SkIPoint onGetSize() override { return {kBlocks * kBlockSize, kBlocks * kBlockSize}; }
+
+    void recordBlock(SkCanvas* canvas, int block) {
+        SkRandom rand(block + 1000 * fEdits[block]);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < kOpsPerBlock; ++i) {
+            paint.setColor(rand.nextU() | 0xff000000);
+            const SkScalar x = rand.nextRangeScalar(0, kBlockSize - 4),
+                           y = rand.nextRangeScalar(0, kBlockSize - 4);
+            canvas->drawOval(SkRect::MakeXYWH(x, y, 4, 4), paint);
+        }
+    }
+
+    void recordDocument(SkCanvas* canvas) {
+        for (int i = 0; i < kBlocks * kBlocks; ++i) {
+            SkAutoCanvasRestore acr(canvas, true);
+            canvas->translate(i % kBlocks * kBlockSize, i / kBlocks * kBlockSize);
+            if (fRetained) {
+                canvas->drawDrawable(fBlocks[i].get());
+            } else {
+                this->recordBlock(canvas, i);
+            }
+        }
+    }
+
+    void onDelayedSetup() override {
+        const SkRect bounds = SkRect::MakeWH(kBlocks * kBlockSize, kBlocks * kBlockSize);
+        fEdits.reset(kBlocks * kBlocks);
+        sk_bzero(fEdits.get(), kBlocks * kBlocks * sizeof(int));
+        if (fRetained) {
+            fBlocks.reset(kBlocks * kBlocks);
+            for (int i = 0; i < kBlocks * kBlocks; ++i) {
+                fBlocks[i] = SkRetainedDrawable::Make(SkRect::MakeWH(kBlockSize, kBlockSize));
+                this->recordBlock(fBlocks[i]->beginRecording(), i);
+                fBlocks[i]->finishRecording();
+            }
+            fDocument = SkRetainedDrawable::Make(bounds);
+            this->recordDocument(fDocument->beginRecording());
+            fDocument->finishRecording();
+            fDocument->detachDirtyRect();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRandom rand;
+        for (int i = 0; i < loops; ++i) {
+            const int block = rand.nextULessThan(kBlocks * kBlocks);
+            fEdits[block]++;
+
+            SkAutoCanvasRestore acr(canvas, true);
+            if (fRetained) {
+                this->recordBlock(fBlocks[block]->beginRecording(), block);
+                fBlocks[block]->finishRecording();
+                canvas->clipRect(fDocument->detachDirtyRect());
+                canvas->drawDrawable(fDocument.get());
+            } else {
+                SkRTreeFactory factory;
+                SkPictureRecorder recorder;
+                this->recordDocument(recorder.beginRecording(kBlocks * kBlockSize,
+                                                             kBlocks * kBlockSize, &factory));
+                canvas->clipRect(SkRect::MakeXYWH(block % kBlocks * kBlockSize,
+                                                  block / kBlocks * kBlockSize,
+                                                  kBlockSize, kBlockSize));
+                canvas->drawPicture(recorder.finishRecordingAsPicture());
+            }
+        }
+    }
+
+private:
+    const bool                                   fRetained;
+    SkString                                     fName;
+    SkAutoTMalloc<int>                           fEdits;
+    SkAutoTArray<sk_sp<SkRetainedDrawable>>      fBlocks;
+    sk_sp<SkRetainedDrawable>                    fDocument;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RetainedDrawableBench(false);)
+DEF_BENCH(return new RetainedDrawableBench(true);)
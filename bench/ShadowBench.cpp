@@ -15,11 +15,13 @@ class ShadowBench : public Benchmark {
 // Draws a set of shadowed rrects filling the canvas, in various modes:
 // * opaque or transparent
 // * use analytic fast path or geometric tessellation
+// * with the rrects placed by their coordinates, or identical rrects placed by a translate
 public:
-    ShadowBench(bool transparent, bool forceGeometric)
+    ShadowBench(bool transparent, bool forceGeometric, bool translated = false)
         : fTransparent(transparent)
-        , fForceGeometric(forceGeometric) {
-        computeName("shadows");
+        , fForceGeometric(forceGeometric)
+        , fTranslated(translated) {
+        computeName(translated ? "shadows_translated" : "shadows");
     }
 
 protected:
@@ -49,8 +51,10 @@ protected:
         int i = 0;
         for (int x = kRRSpace; x < kWidth - kRRStep; x += kRRStep) {
             for (int y = kRRSpace; y < kHeight - kRRStep; y += kRRStep) {
-                SkRect rect = SkRect::MakeXYWH(x, y, kRRSize, kRRSize);
+                SkRect rect = SkRect::MakeXYWH(fTranslated ? 0 : x, fTranslated ? 0 : y,
+                                               kRRSize, kRRSize);
                 fRRects[i].addRRect(SkRRect::MakeRectXY(rect, kRRRadius, kRRRadius));
+                fOffsets[i] = fTranslated ? SkPoint::Make(x, y) : SkPoint::Make(0, 0);
                 ++i;
             }
         }
@@ -82,8 +86,12 @@ protected:
         this->setupPaint(&paint);
 
         for (int i = 0; i < loops; ++i) {
+            const SkPoint& offset = fOffsets[i % kNumRRects];
+            canvas->save();
+            canvas->translate(offset.fX, offset.fY);
             // use the private canvas call so we don't include the time to stuff data in the Rec
             canvas->private_draw_shadow_rec(fRRects[i % kNumRRects], fRec);
+            canvas->restore();
         }
     }
 
@@ -91,9 +99,11 @@ private:
     SkString fBaseName;
 
     SkPath  fRRects[kNumRRects];
+    SkPoint fOffsets[kNumRRects];
     SkDrawShadowRec fRec;
     int    fTransparent;
     int    fForceGeometric;
+    bool   fTranslated;
 
     typedef Benchmark INHERITED;
 };
@@ -102,4 +112,6 @@ DEF_BENCH(return new ShadowBench(false, false);)
 DEF_BENCH(return new ShadowBench(false, true);)
 DEF_BENCH(return new ShadowBench(true, false);)
 DEF_BENCH(return new ShadowBench(true, true);)
+DEF_BENCH(return new ShadowBench(false, false, true);)
+DEF_BENCH(return new ShadowBench(true, false, true);)
 
@@ -94,6 +94,18 @@ static SkPath cubic_path_maker() {
     return path;
 }
 
+// A long, dense polyline, as a chart or data plot would produce.
+static SkPath polyline_path_maker() {
+    const int kCount = 10000;
+    SkPath path;
+    SkRandom rand;
+    path.moveTo(0, rand.nextUScalar1() * Y);
+    for (int i = 1; i <= kCount; ++i) {
+        path.lineTo(i * X / kCount, rand.nextUScalar1() * Y);
+    }
+    return path;
+}
+
 static SkPaint paint_maker() {
     SkPaint paint;
     paint.setStyle(SkPaint::kStroke_Style);
@@ -103,6 +115,15 @@ static SkPaint paint_maker() {
     return paint;
 }
 
+static SkPaint polyline_paint_maker(SkPaint::Join join) {
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setStrokeJoin(join);
+    paint.setStrokeCap(SkPaint::kRound_Cap);
+    return paint;
+}
+
 DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_1", 1);)
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_1", 1);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_1", 1);)
@@ -117,3 +138,10 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+DEF_BENCH(return new StrokeBench(polyline_path_maker(),
+                                 polyline_paint_maker(SkPaint::kMiter_Join), "polyline", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(),
+                                 polyline_paint_maker(SkPaint::kRound_Join), "polyline", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(),
+                                 polyline_paint_maker(SkPaint::kBevel_Join), "polyline", 1);)
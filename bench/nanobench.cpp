@@ -114,6 +114,10 @@ static DEFINE_string(zoom, "1.0,0",
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 static DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+static DEFINE_bool(recordOpts, false,
+                   "Also time each SkRecordOptimize2 pass over the SKPs, recording and playing back?");
+static DEFINE_bool(internSKPs, false,
+                   "Also time recording the SKPs with path interning, reporting serialized bytes?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
@@ -628,6 +632,8 @@ public:
     BenchmarkStream() : fBenches(BenchRegistry::Head())
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
+                      , fCurrentRecordOpts(0)
+                      , fCurrentInternRecording(0)
                       , fCurrentDeserialPicture(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
@@ -773,6 +779,42 @@ public:
             return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
         }
 
+        // With --recordOpts, each .skp again for every pass, first recording, then playing back.
+        const int recordOptsBenches = (RecordOptsBench::kLast_Pass + 1) * 2;
+        while (FLAGS_recordOpts && fCurrentRecordOpts < fSKPs.count() * recordOptsBenches) {
+            const int index = fCurrentRecordOpts++;
+            const SkString& path = fSKPs[index / recordOptsBenches];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            const auto pass = (RecordOptsBench::Pass)(index % recordOptsBenches / 2);
+            const bool playback = index % 2 == 1;
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = playback ? "playback" : "recording";
+            fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
+            fSKPOps   = pic->approximateOpCount();
+            return new RecordOptsBench(name.c_str(), pic.get(), pass, playback);
+        }
+
+        // With --internSKPs, each .skp again recorded with interning. These report the size of what
+        // they record serialized, to compare with the .skp's own size from DeserializePictureBench.
+        while (FLAGS_internSKPs && fCurrentInternRecording < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentInternRecording++];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            auto bench = new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh, true);
+            fSourceType = "skp";
+            fBenchType  = "recording";
+            fSKPBytes = static_cast<double>(bench->serializedBytes());
+            fSKPOps   = pic->approximateOpCount();
+            return bench;
+        }
+
         // Add all .skps as DeserializePictureBenchs.
         while (fCurrentDeserialPicture < fSKPs.count()) {
             const SkString& path = fSKPs[fCurrentDeserialPicture++];
@@ -1102,6 +1144,8 @@ private:
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
+    int fCurrentRecordOpts;
+    int fCurrentInternRecording;
     int fCurrentDeserialPicture;
     int fCurrentScale;
     int fCurrentSKP;
@@ -26,6 +26,15 @@ public:
     bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent) const;
 
+    /** Computes the position and/or tangent at each of count distances, which must be sorted in
+     *  increasing order. Each distance is pinned as in getPosTan(). This walks the contour once,
+     *  so it is much faster than calling getPosTan() for each distance.
+     *  positions and/or tangents may be null. Returns false if any distance is NaN or any
+     *  position could not be computed, in which case the outputs are undefined.
+     */
+    bool SK_WARN_UNUSED_RESULT getPosTan(const SkScalar distances[], int count,
+                                         SkPoint positions[], SkVector tangents[]) const;
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -84,6 +93,7 @@ private:
     ~SkContourMeasure() override {}
 
     const Segment* distanceToSegment(SkScalar distance, SkScalar* t) const;
+    SkScalar segmentT(const Segment* seg, SkScalar distance) const;
 
     friend class SkContourMeasureIter;
 };
@@ -11,6 +11,7 @@
 #include "include/core/SkRefCnt.h"
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkTraceMemoryDump;
 
@@ -145,6 +146,28 @@ public:
      */
     static void PurgeAllCaches();
 
+    /**
+     *  Raster blurs (blur mask filters, and blur image filters drawn on the CPU) with a large
+     *  sigma normally run at full resolution. When enabled, they are instead approximated by
+     *  blurring a copy of the source reduced by a power of two and scaling the result back up.
+     *  This is much faster for large shadows and backdrops, and each channel is within a few
+     *  units of the full resolution result. Off by default.
+     *
+     *  Returns the previous setting.
+     */
+    static bool SetApproximateLargeBlurs(bool enabled);
+
+    /**
+     *  Picture shaders rasterize a tile of their picture for every new scale they are drawn at,
+     *  which stalls zooming and animated draws. When an executor is set, a picture shader that has
+     *  a tile cached at a nearby power-of-two scale draws with that instead, while the tile for the
+     *  exact scale (and its mipmaps) is rasterized on the executor and used once it is ready.
+     *  Null (the default) rasterizes every tile synchronously. The executor must outlive its use.
+     *
+     *  Returns the previous executor.
+     */
+    static SkExecutor* SetPictureShaderTileExecutor(SkExecutor*);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
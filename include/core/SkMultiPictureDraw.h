@@ -47,6 +47,12 @@ public:
      *  Perform all the previously added draws. This will reset the state
      *  of this object. If flush is true, all canvases are flushed after
      *  draw.
+     *
+     *  Draws into raster canvases whose pixels don't overlap run concurrently
+     *  on the default SkExecutor, and draws into the same pixels run in the
+     *  order they were added. Draws into other non-GPU canvases run in add
+     *  order too, after the raster draws added before them and before those
+     *  added after them. Either way, they have all finished when this returns.
      */
     void draw(bool flush = false);
 
@@ -1698,6 +1698,7 @@ private:
     size_t readAsRRect(const void*, size_t);
     size_t readFromMemory_LE3(const void*, size_t);
     size_t readFromMemory_EQ4(const void*, size_t);
+    size_t readFromMemory_EQ5(const void*, size_t, SkData* backingData);
 
     friend class Iter;
     friend class SkPathPriv;
@@ -80,6 +80,23 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, keeping a reference to data. If data
+        was written with SkSerialProcs::fIndexPictureOps set, returned SkPicture reads drawing
+        commands, SkPath and SkImage from data only when playback() needs them, and skips the
+        commands that draw outside the SkCanvas clip without reading them. This makes drawing a
+        small part of a large SkPicture cheap; data may be mapped from a file with
+        SkData::MakeFromFileName(). Otherwise, data is read as MakeFromData() does.
+
+        procs must remain valid for as long as the returned SkPicture. An SkImage that cannot
+        be decoded when it is first drawn is skipped.
+
+        @param data   container for serial data
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromDataLazily(sk_sp<SkData> data,
+                                               const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -218,13 +235,17 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkLazyPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces,
-        bool textBlobsOnly=false) const;
+        bool textBlobsOnly=false, const struct SkPreparedPicture* prepared=nullptr) const;
+    void prepareSerialize(const SkSerialProcs&, struct SkPreparedPicture*,
+                          class SkTaskGroup*) const;
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           const SkData* lazySource = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -250,7 +271,7 @@ private:
                                         class SkReadBuffer* buffer);
 
     struct SkPictInfo createHeader() const;
-    class SkPictureData* backport() const;
+    class SkPictureData* backport(bool indexOps = false) const;
 
     uint32_t fUniqueID;
 };
@@ -35,6 +35,10 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+        // Paths with the same contents as one drawn or clipped to earlier are recorded as copies
+        // of that one, sharing its storage. This costs a hash of each path recorded, and saves
+        // memory and serialized size for content that repeats the same path many times.
+        kInternPaths_RecordFlag             = 1 << 1,
     };
 
     enum FinishFlags {
@@ -12,6 +12,8 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkTypeface.h"
 
+class SkExecutor;
+
 /**
  *  A serial-proc is asked to serialize the specified object (e.g. picture or image).
  *  If a data object is returned, it will be used (even if it is zero-length).
@@ -56,6 +58,20 @@ struct SK_API SkSerialProcs {
 
     SkSerialTypefaceProc fTypefaceProc = nullptr;
     void*                fTypefaceCtx = nullptr;
+
+    /**
+     *  If true, pictures are written with an index of where each of their drawing commands is and
+     *  the area it draws to, which lets SkPicture::MakeFromDataLazily() read only the commands,
+     *  paths and images a playback needs.
+     */
+    bool                 fIndexPictureOps = false;
+
+    /**
+     *  If set, images and sub-pictures are encoded on this executor concurrently, and the calling
+     *  thread waits for them before writing them out in order. The result is the same as without
+     *  an executor, but fImageProc and fPictureProc may be called from several threads at once.
+     */
+    SkExecutor*          fExecutor = nullptr;
 };
 
 struct SK_API SkDeserialProcs {
@@ -67,6 +83,12 @@ struct SK_API SkDeserialProcs {
 
     SkDeserialTypefaceProc  fTypefaceProc = nullptr;
     void*                   fTypefaceCtx = nullptr;
+
+    /**
+     *  If set, the images of a picture are decoded (or handed to fImageProc) on this executor
+     *  concurrently, so fImageProc may be called from several threads at once.
+     */
+    SkExecutor*             fExecutor = nullptr;
 };
 
 #endif
@@ -499,6 +499,7 @@ public:
     AI SkNx operator & (const SkNx& o) const { return vandq_u8(fVec, o.fVec); }
 
     AI static SkNx Min(const SkNx& a, const SkNx& b) { return vminq_u8(a.fVec, b.fVec); }
+    AI static SkNx Max(const SkNx& a, const SkNx& b) { return vmaxq_u8(a.fVec, b.fVec); }
     AI SkNx operator < (const SkNx& o) const { return vcltq_u8(fVec, o.fVec); }
 
     AI uint8_t operator[](int k) const {
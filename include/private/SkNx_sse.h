@@ -671,6 +671,7 @@ public:
     AI SkNx operator & (const SkNx& o) const { return _mm_and_si128(fVec, o.fVec); }
 
     AI static SkNx Min(const SkNx& a, const SkNx& b) { return _mm_min_epu8(a.fVec, b.fVec); }
+    AI static SkNx Max(const SkNx& a, const SkNx& b) { return _mm_max_epu8(a.fVec, b.fVec); }
     AI SkNx operator < (const SkNx& o) const {
         // There's no unsigned _mm_cmplt_epu8, so we flip the sign bits then use a signed compare.
         auto flip = _mm_set1_epi8(char(0x80));
@@ -8,6 +8,7 @@
 #ifndef SkPathRef_DEFINED
 #define SkPathRef_DEFINED
 
+#include "include/core/SkData.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
@@ -20,6 +21,7 @@
 #include <atomic>
 #include <limits>
 
+class SkPathAccel;
 class SkRBuffer;
 class SkWBuffer;
 
@@ -36,6 +38,10 @@ class SkWBuffer;
  * and verbs both grow into the middle of the allocation until the meet. To access verb i in the
  * verb array use ref.verbs()[~i] (because verbs() returns a pointer just beyond the first
  * logical verb or the last verb in memory).
+ *
+ * A path ref created by CreateFromData() may instead reference points and verbs that live inside
+ * an immutable SkData (e.g. a memory-mapped file). Such a path ref is never edited in place; the
+ * Editor copies it first, just as if it were shared.
  */
 
 class SK_API SkPathRef final : public SkNVRefCnt<SkPathRef> {
@@ -240,6 +246,17 @@ public:
 
     static SkPathRef* CreateFromBuffer(SkRBuffer* buffer);
 
+    /**
+     * Creates a path ref from verbs (in memory order, i.e. last logical verb first), points and
+     * conic weights. Returns nullptr if they do not describe a valid path. If data is not null,
+     * the points are aligned, and the verbs immediately follow the points inside data, then the
+     * path ref references the points and verbs in place (keeping data alive) instead of copying.
+     */
+    static SkPathRef* CreateFromData(sk_sp<SkData> data,
+                                     const SkPoint points[], int pointCount,
+                                     const uint8_t verbs[], int verbCount,
+                                     const SkScalar weights[], int weightCount);
+
     /**
      * Rollsback a path ref to zero verbs and points with the assumption that the path ref will be
      * repopulated with approximately the same number of verbs and points. A new path ref is created
@@ -350,6 +367,7 @@ private:
         fVerbs = nullptr;
         fPoints = nullptr;
         fFreeSpace = 0;
+        fAccel = nullptr;
         fGenerationID = kEmptyGenID;
         fSegmentMask = 0;
         fIsOval = false;
@@ -547,6 +565,7 @@ private:
 
     mutable SkRect   fBounds;
 
+    sk_sp<SkData>       fBackingData; // if set, owns fPoints/fVerbs, which are read-only
     SkPoint*            fPoints; // points to begining of the allocation
     uint8_t*            fVerbs; // points just past the end of the allocation (verbs grow backwards)
     int                 fVerbCnt;
@@ -560,6 +579,8 @@ private:
     mutable uint32_t    fGenerationID;
     SkDEBUGCODE(std::atomic<int> fEditorsAttached;) // assert only one editor in use at any time.
 
+    mutable std::atomic<SkPathAccel*> fAccel;   // lazily created, see SkPathPriv::Accel()
+
     SkMutex                         fGenIDChangeListenersMutex;
     SkTDArray<GenIDChangeListener*> fGenIDChangeListeners;  // pointers are reffed
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureDamage_DEFINED
+#define SkPictureDamage_DEFINED
+
+#include "include/core/SkColor.h"
+#include "include/core/SkTypes.h"
+
+class SkCanvas;
+class SkPicture;
+class SkRegion;
+
+/**
+ *  Incremental repaint: when a surface that kept the last frame's pixels is to show a new frame,
+ *  only the pixels the two frames' pictures draw differently need to be drawn again.
+ */
+class SK_API SkPictureDamage {
+public:
+    /**
+     *  Sets damage to the pixels, in the pictures' coordinates, that drawing after may change from
+     *  drawing before. This compares the pictures' ops: those that are the same, in the same
+     *  state, and at the same place in both can be skipped, and the rest damage their bounds.
+     *  Ops are the same when their arguments are equal, and images, pictures, text blobs and
+     *  effects are compared by identity. This is conservative: it can find damage where the
+     *  pixels are the same, but never misses a change.
+     *
+     *  damage is kept to at most maxRects rectangles, merging them into their bounds if there
+     *  would be more.
+     */
+    static void Compute(const SkPicture& before, const SkPicture& after, SkRegion* damage,
+                        int maxRects = 16);
+
+    /**
+     *  Adds to damage the pixels the ops [start, stop) of picture draw to, in its coordinates.
+     *  These are the indices of the ops in picture's playback, starting from 0, up to its
+     *  approximateOpCount().
+     */
+    static void AddOps(const SkPicture& picture, int start, int stop, SkRegion* damage);
+
+    /**
+     *  Draws picture into canvas one damage rectangle at a time, clipped to it, after filling it
+     *  with background, the color the canvas was cleared to before the previous frame was drawn.
+     */
+    static void Replay(const SkPicture& picture, const SkRegion& damage, SkCanvas* canvas,
+                       SkColor background = SK_ColorTRANSPARENT);
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRetainedDrawable_DEFINED
+#define SkRetainedDrawable_DEFINED
+
+#include "include/core/SkDrawable.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkTArray.h"
+
+#include <memory>
+
+class SkBBoxHierarchy;
+class SkCanvas;
+class SkDrawableList;
+class SkRecord;
+class SkRecorder;
+
+/**
+ *  A node of a retained scene: a drawable whose content is recorded, and may be recorded again, on
+ *  its own. Drawables it draws with SkCanvas::drawDrawable() are recorded by reference, so one node
+ *  of a tree of these can change without recording its parent or siblings again, and each keeps
+ *  the optimized ops and bounding box hierarchy it built until its own content changes.
+ *
+ *  Each node also tracks the area, in its own coordinates, that has changed since it was last
+ *  asked, including the changes to the drawables it draws, so a host only needs to repaint that.
+ *
+ *  Like drawables from SkPictureRecorder::finishRecordingAsDrawable(), the generation ID of a node
+ *  only changes with its own content, not with the drawables it draws. Nodes are not thread safe.
+ */
+class SK_API SkRetainedDrawable : public SkDrawable {
+public:
+    /**
+     *  Returns an empty node. bounds must hold everything it will ever draw, including what the
+     *  drawables it draws draw.
+     */
+    static sk_sp<SkRetainedDrawable> Make(const SkRect& bounds);
+
+    ~SkRetainedDrawable() override;
+
+    /**
+     *  Returns a canvas recording new content for the node, which keeps drawing its current
+     *  content until finishRecording() is called. The canvas is valid until then.
+     */
+    SkCanvas* beginRecording();
+
+    /**
+     *  Replaces the node's content with what was recorded since beginRecording(), and marks the
+     *  area both the old and the new content cover as changed.
+     */
+    void finishRecording();
+
+    /**
+     *  Marks an area, in the node's coordinates, as changed without recording the node again, for
+     *  instance when an image it draws has changed.
+     */
+    void invalidate(const SkRect&);
+
+    /**
+     *  Returns the area, in the node's coordinates, that has changed since this was last called,
+     *  and starts tracking changes afresh. This includes the changes reported by the nodes the
+     *  node draws, mapped through the matrices they are drawn with, and the whole bounds of any
+     *  other drawable it draws whose generation ID has changed. A node drawn by several nodes
+     *  only reports its changes to the first to ask.
+     */
+    SkRect detachDirtyRect();
+
+    const char* getTypeName() const override { return "SkRetainedDrawable"; }
+
+protected:
+    SkRect onGetBounds() override { return fBounds; }
+    void onDraw(SkCanvas*) override;
+    SkPicture* onNewPictureSnapshot() override;
+
+private:
+    explicit SkRetainedDrawable(const SkRect& bounds);
+
+    void findChildren();
+
+    // A drawable drawn by the node, the matrix it is drawn with, and its generation ID when its
+    // changes were last collected.
+    struct Child {
+        SkDrawable* fDrawable;
+        SkMatrix    fMatrix;
+        uint32_t    fGenerationID;
+    };
+
+    const SkRect                    fBounds;
+    sk_sp<SkRecord>                 fRecord;
+    sk_sp<SkBBoxHierarchy>          fBBH;
+    std::unique_ptr<SkDrawableList> fDrawableList;
+    SkTArray<Child>                 fChildren;
+    SkRect                          fContentBounds = SkRect::MakeEmpty();
+    SkRect                          fDirty = SkRect::MakeEmpty();
+
+    // While recording.
+    std::unique_ptr<SkRecorder>     fRecorder;
+    sk_sp<SkRecord>                 fPendingRecord;
+
+    typedef SkDrawable INHERITED;
+};
+
+#endif
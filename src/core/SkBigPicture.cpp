@@ -10,6 +10,7 @@
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordPlan.h"
 #include "src/core/SkTraceEvent.h"
 
 SkBigPicture::SkBigPicture(const SkRect& cull,
@@ -24,11 +25,36 @@ SkBigPicture::SkBigPicture(const SkRect& cull,
     , fBBH(bbh)                     // Take ownership of caller's ref.
 {}
 
+SkBigPicture::~SkBigPicture() {}
+
+const SkRecordPlan* SkBigPicture::plan() const {
+    if (fPlaybacks.load(std::memory_order_relaxed) < kMinPlaybacksForPlan) {
+        fPlaybacks.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    fPlanOnce([this] {
+        fPlan.reset(new SkRecordPlan(*fRecord));
+        fPlanBytes.store(fPlan->bytesUsed(), std::memory_order_relaxed);
+    });
+    return fPlan.get();
+}
+
 void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
     SkASSERT(canvas);
 
     // If the query contains the whole picture, don't bother with the BBH.
-    const bool useBBH = !canvas->getLocalClipBounds().contains(this->cullRect());
+    const SkRect query = canvas->getLocalClipBounds();
+    const bool useBBH = !query.contains(this->cullRect());
+
+    // Only a BBH culls. Without one every op is drawn, however often the picture has been drawn
+    // before: recording canvases like the one SkPicture::backport() uses may have clips that
+    // don't match the picture's coordinates.
+    if (!useBBH || !fBBH) {
+        if (const SkRecordPlan* plan = this->plan()) {
+            plan->playback(canvas, this->drawablePicts(), this->drawableCount(), callback);
+            return;
+        }
+    }
 
     SkRecordDraw(*fRecord,
                  canvas,
@@ -58,6 +84,7 @@ int    SkBigPicture::approximateOpCount()   const { return fRecord->count(); }
 size_t SkBigPicture::approximateBytesUsed() const {
     size_t bytes = sizeof(*this) + fRecord->bytesUsed() + fApproxBytesUsedBySubPictures;
     if (fBBH) { bytes += fBBH->bytesUsed(); }
+    bytes += fPlanBytes.load(std::memory_order_relaxed);
     return bytes;
 }
 
@@ -14,9 +14,13 @@
 #include "include/private/SkOnce.h"
 #include "include/private/SkTemplates.h"
 
+#include <atomic>
+#include <memory>
+
 class SkBBoxHierarchy;
 class SkMatrix;
 class SkRecord;
+class SkRecordPlan;
 
 // An implementation of SkPicture supporting an arbitrary number of drawing commands.
 class SkBigPicture final : public SkPicture {
@@ -39,6 +43,7 @@ public:
                  SnapshotArray*,       // We take exclusive ownership.
                  SkBBoxHierarchy*,     // We take ownership of the caller's ref.
                  size_t approxBytesUsedBySubPictures);
+    ~SkBigPicture() override;
 
 
 // SkPicture overrides
@@ -56,16 +61,27 @@ public:
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
-
-private:
+// Used by SkPicture::backport()
     int drawableCount() const;
     SkPicture const* const* drawablePicts() const;
 
+private:
+    // Pictures played back this many times get an SkRecordPlan for the playbacks after.
+    static constexpr int kMinPlaybacksForPlan = 2;
+
+    // Returns the plan for this picture, or null if it hasn't been played back enough yet.
+    const SkRecordPlan* plan() const;
+
     const SkRect                         fCullRect;
     const size_t                         fApproxBytesUsedBySubPictures;
     sk_sp<const SkRecord>                fRecord;
     std::unique_ptr<const SnapshotArray> fDrawablePicts;
     sk_sp<const SkBBoxHierarchy>         fBBH;
+
+    mutable std::atomic<int>             fPlaybacks{0};
+    mutable SkOnce                       fPlanOnce;
+    mutable std::unique_ptr<const SkRecordPlan> fPlan;
+    mutable std::atomic<size_t>          fPlanBytes{0};  // Set once fPlan is built.
 };
 
 #endif//SkBigPicture_DEFINED
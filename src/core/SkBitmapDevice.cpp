@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -610,6 +611,11 @@ private:
     const SkMatrix fPrevCTM;
 };
 
+// Filtered layers larger than this many pixels are filtered a tile at a time, so that huge
+// layers don't need several full size intermediates.
+static constexpr int     kFilterTileSize = 1024;
+static constexpr int64_t kMaxUntiledFilterPixels = 4 * kFilterTileSize * kFilterTileSize;
+
 }  // anonymous ns
 
 void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPaint& origPaint,
@@ -627,7 +633,26 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPain
         sk_sp<SkImageFilterCache> cache(this->getImageFilterCache());
         SkImageFilter_Base::OutputProperties outputProperties(fBitmap.colorType(),
                                                               fBitmap.colorSpace());
-        SkImageFilter_Base::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
+        // Independent filter inputs run on the default executor, which is serial unless the
+        // client installed a thread pool with SkExecutor::SetDefault().
+        SkImageFilter_Base::Context ctx(matrix, clipBounds, cache.get(), outputProperties,
+                                        &SkExecutor::GetDefault());
+
+        // A mask filter or clip image would need the whole filtered image at once.
+        if (!clipImage && !paint->getMaskFilter() &&
+            sk_64_mul(clipBounds.width(), clipBounds.height()) > kMaxUntiledFilterPixels) {
+            SkPaint tilePaint(*paint);
+            tilePaint.setImageFilter(nullptr);
+            as_IFB(filter)->filterImageTiled(src, ctx, kFilterTileSize,
+                    [&](SkSpecialImage* tileImage, const SkIPoint& offset, const SkIRect& tile) {
+                SkBitmap resultBM;
+                if (tileImage->getROPixels(&resultBM)) {
+                    SkAutoDeviceClipRestore acr(this, tile.makeOffset(x, y));
+                    this->drawSprite(resultBM, x + offset.x(), y + offset.y(), tilePaint);
+                }
+            });
+            return;
+        }
 
         filteredImage = as_IFB(filter)->filterImage(src, ctx, &offset);
         if (!filteredImage) {
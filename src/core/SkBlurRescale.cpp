@@ -0,0 +1,173 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkBlurRescale.h"
+
+#include "include/private/SkNx.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkTo.h"
+
+#include <algorithm>
+#include <cmath>
+
+std::atomic<bool> gSkApproximateLargeBlurs{false};
+
+int SkBlurRescale::Plan(double sigma, double* reducedSigma) {
+    int k = 0;
+    while (sigma / (2 << k) >= kMinReducedSigma) {
+        k++;
+    }
+    // The box filter down has a variance of (s^2 - 1) / 12 and the bilinear filter back up one of
+    // about s^2 / 6, in full resolution pixels; together s^2 / 4, or 1/4 of a reduced pixel.
+    *reducedSigma = k == 0 ? sigma : sqrt(sigma * sigma / (1 << 2 * k) - 0.25);
+    return k;
+}
+
+template <int kBpp>
+static void downsample(int kx, int ky,
+                       const uint8_t* src, size_t srcRowBytes, int srcW, int srcH,
+                       uint8_t* dst, size_t dstRowBytes) {
+    using Pixel = SkNx<kBpp, uint8_t>;
+    using Sum   = SkNx<kBpp, uint32_t>;
+
+    const int lowW = SkBlurRescale::ReducedSize(srcW, kx),
+              lowH = SkBlurRescale::ReducedSize(srcH, ky),
+              shift = kx + ky;
+    const uint32_t half = (1u << shift) >> 1;
+
+    SkAutoTMalloc<Sum> sums(lowW);
+    for (int j = 0; j < lowH; ++j) {
+        std::fill(sums.get(), sums.get() + lowW, Sum(half));
+        for (int y = j << ky; y < std::min((j + 1) << ky, srcH); ++y) {
+            const uint8_t* row = src + y * srcRowBytes;
+            for (int i = 0; i < lowW; ++i) {
+                Sum sum = sums[i];
+                for (int x = i << kx; x < std::min((i + 1) << kx, srcW); ++x) {
+                    sum = sum + SkNx_cast<uint32_t>(Pixel::Load(row + x * kBpp));
+                }
+                sums[i] = sum;
+            }
+        }
+        uint8_t* lowRow = dst + j * dstRowBytes;
+        for (int i = 0; i < lowW; ++i) {
+            SkNx_cast<uint8_t>(sums[i] >> shift).store(lowRow + i * kBpp);
+        }
+    }
+}
+
+void SkBlurRescale::Downsample(int bpp, int kx, int ky,
+                               const uint8_t* src, size_t srcRowBytes, int srcW, int srcH,
+                               uint8_t* dst, size_t dstRowBytes) {
+    switch (bpp) {
+        case 1: downsample<1>(kx, ky, src, srcRowBytes, srcW, srcH, dst, dstRowBytes); break;
+        case 4: downsample<4>(kx, ky, src, srcRowBytes, srcW, srcH, dst, dstRowBytes); break;
+        default: SK_ABORT("Unsupported pixel size.");
+    }
+}
+
+// Maps full resolution pixel x onto the reduced grid, whose cells are 1 << k pixels wide: its
+// center lands between cells *cell and *cell + 1, *weight / (2 << k) of the way along.
+static void map_to_grid(int k, int x, int* cell, int* weight) {
+    const int twice = 2 * x + 1 - (1 << k);     // twice the offset of x's center from cell 0's
+    *cell = twice >> (k + 1);                   // arithmetic shift, so this floors
+    *weight = twice - (*cell << (k + 1));
+}
+
+void SkBlurRescale::UpsampleRange(int k, int dstSize, int origin, int* first, int* end) {
+    int weight;
+    map_to_grid(k, 0 - origin, first, &weight);
+    map_to_grid(k, dstSize - 1 - origin, end, &weight);
+    *end += 2;
+}
+
+template <int kBpp>
+static void upsample(int kx, int ky,
+                     const uint8_t* low, size_t lowRowBytes, int lowW, int lowH, int lowX, int lowY,
+                     uint8_t* dst, size_t dstRowBytes, int dstW, int dstH, int originX, int originY) {
+    int first, end;
+    SkBlurRescale::UpsampleRange(kx, dstW, originX, &first, &end);
+
+    // The columns each dst pixel reads from, relative to first, and how far along it is.
+    SkAutoTMalloc<int> cells(dstW), weights(dstW);
+    for (int x = 0; x < dstW; ++x) {
+        map_to_grid(kx, x - originX, &cells[x], &weights[x]);
+        cells[x] -= first;
+    }
+
+    // Columns of the grid between first and end that low covers, relative to first.
+    const int coveredStart = SkTPin(lowX - first, 0, end - first),
+              coveredEnd   = SkTPin(lowX + lowW - first, 0, end - first);
+    const uint8_t* lowStart = low + (first + coveredStart - lowX) * kBpp;
+
+    const int dx = 2 << kx,
+              dy = 2 << ky,
+              shift = kx + ky + 2;
+    const int half = 1 << (shift - 1);
+
+    using Value = SkNx<kBpp, int32_t>;
+    SkAutoTMalloc<int32_t> column((end - first) * kBpp);
+    for (int y = 0; y < dstH; ++y) {
+        int cell, wy;
+        map_to_grid(ky, y - originY, &cell, &wy);
+        auto lowRow = [&](int row) -> const uint8_t* {
+            row -= lowY;
+            return 0 <= row && row < lowH && coveredStart < coveredEnd
+                   ? lowStart + row * lowRowBytes : nullptr;
+        };
+        const uint8_t* top    = lowRow(cell);
+        const uint8_t* bottom = lowRow(cell + 1);
+
+        // Filter vertically into column, then horizontally into dst.
+        std::fill(column.get(), column.get() + (end - first) * kBpp, 0);
+        int32_t* covered = &column[coveredStart * kBpp];
+        const int coveredCount = (coveredEnd - coveredStart) * kBpp;
+        if (top) {
+            for (int i = 0; i < coveredCount; ++i) {
+                covered[i] = top[i] * (dy - wy);
+            }
+        }
+        if (bottom) {
+            for (int i = 0; i < coveredCount; ++i) {
+                covered[i] += bottom[i] * wy;
+            }
+        }
+
+        // Between the same two columns the weight grows by 2 a pixel, so step the filtered value
+        // along rather than recomputing it.
+        uint8_t* dstRow = dst + y * dstRowBytes;
+        for (int x = 0; x < dstW;) {
+            const int left = cells[x];
+            const Value l = Value::Load(&column[ left      * kBpp]),
+                        r = Value::Load(&column[(left + 1) * kBpp]),
+                        step = (r - l) * 2;
+            Value v = l * (dx - weights[x]) + r * weights[x] + half;
+            for (; x < dstW && cells[x] == left; ++x) {
+                SkNx_cast<uint8_t>(v >> shift).store(dstRow + x * kBpp);
+                v = v + step;
+            }
+        }
+    }
+}
+
+void SkBlurRescale::Upsample(int bpp, int kx, int ky,
+                             const uint8_t* low, size_t lowRowBytes, int lowW, int lowH,
+                             int lowX, int lowY,
+                             uint8_t* dst, size_t dstRowBytes, int dstW, int dstH,
+                             int originX, int originY) {
+    switch (bpp) {
+        case 1:
+            upsample<1>(kx, ky, low, lowRowBytes, lowW, lowH, lowX, lowY,
+                        dst, dstRowBytes, dstW, dstH, originX, originY);
+            break;
+        case 4:
+            upsample<4>(kx, ky, low, lowRowBytes, lowW, lowH, lowX, lowY,
+                        dst, dstRowBytes, dstW, dstH, originX, originY);
+            break;
+        default:
+            SK_ABORT("Unsupported pixel size.");
+    }
+}
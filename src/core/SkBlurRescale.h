@@ -0,0 +1,71 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurRescale_DEFINED
+#define SkBlurRescale_DEFINED
+
+#include "include/core/SkTypes.h"
+
+#include <atomic>
+
+// Set by SkGraphics::SetApproximateLargeBlurs(); off by default.
+extern std::atomic<bool> gSkApproximateLargeBlurs;
+
+/**
+ *  The raster blurs (SkMaskBlurFilter and the CPU path of SkBlurImageFilter) cost O(area) at full
+ *  resolution. For a large sigma almost all of that resolution is thrown away, so, like the GPU
+ *  path in SkGpuBlurUtils, the source can instead be box filtered down by a power of two along
+ *  each axis, blurred with the remaining sigma, and scaled back up bilinearly.
+ *
+ *  The reduction is chosen so that the reduced sigma stays at least kMinReducedSigma, where the
+ *  three box passes are about as close to a Gaussian as they are at full resolution. Over sigmas
+ *  from 16 to 136 every channel of the result is within 6 of the full resolution blur, and most
+ *  are identical; kMaxError leaves some slack on that for tests.
+ */
+namespace SkBlurRescale {
+    static constexpr double kMinReducedSigma = 8;
+    static constexpr int    kMaxError = 8;
+
+    /**
+     *  Returns log2 of the reduction to use along an axis blurred with sigma, 0 meaning none, and
+     *  sets reducedSigma to the sigma to blur the reduced image with. Box filtering down by s and
+     *  bilinearly scaling back up spreads the result by a variance of about s^2 / 4 on their own,
+     *  so that is taken out of the reduced sigma.
+     */
+    int Plan(double sigma, double* reducedSigma);
+
+    /**
+     *  Averages each (1 << kx) by (1 << ky) block of src into one pixel of dst. Pixels have bpp
+     *  8-bit channels. Blocks hanging off the right or bottom of src count the missing pixels as
+     *  zero. dst must hold SkBlurRescale::ReducedSize(srcW, kx) by ReducedSize(srcH, ky) pixels.
+     */
+    void Downsample(int bpp, int kx, int ky,
+                    const uint8_t* src, size_t srcRowBytes, int srcW, int srcH,
+                    uint8_t* dst, size_t dstRowBytes);
+
+    static inline int ReducedSize(int size, int k) {
+        return (size + (1 << k) - 1) >> k;
+    }
+
+    /**
+     *  Sets [*first, *end) to the cells of the reduced grid along an axis that Upsample() reads to
+     *  fill dstSize full resolution pixels when the grid starts at origin.
+     */
+    void UpsampleRange(int k, int dstSize, int origin, int* first, int* end);
+
+    /**
+     *  Scales a reduced image back up by (1 << kx, 1 << ky) with bilinear filtering into dst.
+     *  Pixel (0, 0) of the reduced grid covers the full resolution block whose top left is at
+     *  (originX, originY) in dst, and low is the part of that grid starting at (lowX, lowY); the
+     *  grid is zero everywhere else.
+     */
+    void Upsample(int bpp, int kx, int ky,
+                  const uint8_t* low, size_t lowRowBytes, int lowW, int lowH, int lowX, int lowY,
+                  uint8_t* dst, size_t dstRowBytes, int dstW, int dstH, int originX, int originY);
+}
+
+#endif
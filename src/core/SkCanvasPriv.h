@@ -48,6 +48,11 @@ public:
         canvas->drawClippedToSaveBehind(paint);
     }
 
+    // The device the canvas was made with, beneath any layers.
+    static SkBaseDevice* BaseDevice(const SkCanvas* canvas) {
+        return canvas->getDevice();
+    }
+
     // The experimental_DrawEdgeAAImageSet API accepts separate dstClips and preViewMatrices arrays,
     // where entries refer into them, but no explicit size is provided. Given a set of entries,
     // computes the minimum length for these arrays that would provide index access errors.
@@ -11,6 +11,8 @@
 #include "src/core/SkPathMeasurePriv.h"
 #include "src/core/SkTSearch.h"
 
+#include "include/private/SkNx.h"
+
 #define kMaxTValue  0x3FFFFFFF
 
 static inline SkScalar tValue2Scalar(int t) {
@@ -433,6 +435,70 @@ static void compute_pos_tan(const SkPoint pts[], unsigned segType,
     }
 }
 
+// One coordinate of a quad at four t values, using the same arithmetic as SkQuadCoeff and
+// SkEvalQuadTangentAt() so the results match compute_pos_tan(). The tangent is not normalized.
+static void eval_quad_x4(SkScalar p0, SkScalar p1, SkScalar p2, const Sk4f& t,
+                         Sk4f* pos, Sk4f* tangent) {
+    SkScalar a = p2 - (p1 + p1) + p0,
+             b = (p1 - p0) + (p1 - p0);
+    *pos = (Sk4f(a) * t + Sk4f(b)) * t + Sk4f(p0);
+
+    SkScalar tb = p1 - p0,
+             ta = p2 - p1 - tb;
+    Sk4f d = Sk4f(ta) * t + Sk4f(tb);
+    *tangent = d + d;
+}
+
+// As above, matching SkCubicCoeff and eval_cubic_derivative().
+static void eval_cubic_x4(SkScalar p0, SkScalar p1, SkScalar p2, SkScalar p3, const Sk4f& t,
+                          Sk4f* pos, Sk4f* tangent) {
+    SkScalar a = p3 + 3 * (p1 - p2) - p0,
+             b = 3 * (p2 - (p1 + p1) + p0),
+             c = 3 * (p1 - p0);
+    *pos = ((Sk4f(a) * t + Sk4f(b)) * t + Sk4f(c)) * t + Sk4f(p0);
+
+    SkScalar tb = p2 - (p1 + p1) + p0;
+    tb = tb + tb;
+    *tangent = (Sk4f(a) * t + Sk4f(tb)) * t + Sk4f(p1 - p0);
+}
+
+// Like compute_pos_tan() for up to four t values on the same segment.
+static void compute_pos_tan_x4(const SkPoint pts[], unsigned segType, const SkScalar t[], int n,
+                               SkPoint pos[], SkVector tangent[]) {
+    SkASSERT(n >= 1 && n <= 4);
+    if (n == 1 || (segType != kQuad_SegType && segType != kCubic_SegType)) {
+        for (int i = 0; i < n; ++i) {
+            compute_pos_tan(pts, segType, t[i], pos ? &pos[i] : nullptr,
+                            tangent ? &tangent[i] : nullptr);
+        }
+        return;
+    }
+
+    Sk4f T(t[0], t[SkTMin(1, n - 1)], t[SkTMin(2, n - 1)], t[n - 1]);
+    Sk4f x, y, dx, dy;
+    if (segType == kQuad_SegType) {
+        eval_quad_x4(pts[0].fX, pts[1].fX, pts[2].fX, T, &x, &dx);
+        eval_quad_x4(pts[0].fY, pts[1].fY, pts[2].fY, T, &y, &dy);
+    } else {
+        eval_cubic_x4(pts[0].fX, pts[1].fX, pts[2].fX, pts[3].fX, T, &x, &dx);
+        eval_cubic_x4(pts[0].fY, pts[1].fY, pts[2].fY, pts[3].fY, T, &y, &dy);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (pos) {
+            pos[i].set(x[i], y[i]);
+        }
+        if (tangent) {
+            if (t[i] == 0 || t[i] == 1) {
+                // The end points have special cases for degenerate control points.
+                compute_pos_tan(pts, segType, t[i], nullptr, &tangent[i]);
+            } else {
+                tangent[i].set(dx[i], dy[i]);
+                tangent[i].normalize();
+            }
+        }
+    }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -530,10 +596,15 @@ const SkContourMeasure::Segment* SkContourMeasure::distanceToSegment( SkScalar d
     index ^= (index >> 31);
     seg = &seg[index];
 
-    // now interpolate t-values with the prev segment (if possible)
+    *t = this->segmentT(seg, distance);
+    return seg;
+}
+
+SkScalar SkContourMeasure::segmentT(const Segment* seg, SkScalar distance) const {
+    // interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
     // check if the prev segment is legal, and references the same set of points
-    if (index > 0) {
+    if (seg > fSegments.begin()) {
         startD = seg[-1].fDistance;
         if (seg[-1].fPtIndex == seg->fPtIndex) {
             SkASSERT(seg[-1].fType == seg->fType);
@@ -545,8 +616,7 @@ const SkContourMeasure::Segment* SkContourMeasure::distanceToSegment( SkScalar d
     SkASSERT(distance >= startD);
     SkASSERT(seg->fDistance > startD);
 
-    *t = startT + (seg->getScalarT() - startT) * (distance - startD) / (seg->fDistance - startD);
-    return seg;
+    return startT + (seg->getScalarT() - startT) * (distance - startD) / (seg->fDistance - startD);
 }
 
 bool SkContourMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tangent) const {
@@ -575,6 +645,56 @@ bool SkContourMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tang
     return true;
 }
 
+bool SkContourMeasure::getPosTan(const SkScalar distances[], int count,
+                                 SkPoint pos[], SkVector tangent[]) const {
+    SkASSERT(count >= 0);
+
+    const SkScalar length = this->length();
+    SkASSERT(length > 0 && fSegments.count() > 0);
+
+    // Each distance is found by stepping forward from the previous one's segment, and runs of
+    // distances that land on the same curve are evaluated together.
+    const Segment*  seg = fSegments.begin();
+    const Segment*  last = fSegments.end() - 1;
+    SkDEBUGCODE(SkScalar prevDistance = 0;)
+
+    for (int i = 0; i < count;) {
+        SkScalar t[4];
+        unsigned ptIndex = seg->fPtIndex;
+        unsigned segType = seg->fType;
+        int n = 0;
+        for (; n < 4 && i + n < count; ++n) {
+            SkScalar distance = distances[i + n];
+            if (SkScalarIsNaN(distance)) {
+                return false;
+            }
+            distance = SkTPin(distance, 0.0f, length);
+            SkASSERT(distance >= prevDistance);
+            SkDEBUGCODE(prevDistance = distance;)
+
+            while (seg < last && seg->fDistance < distance) {
+                ++seg;
+            }
+            if (seg->fPtIndex != ptIndex) {
+                if (n > 0) {
+                    break;
+                }
+                ptIndex = seg->fPtIndex;
+                segType = seg->fType;
+            }
+            t[n] = this->segmentT(seg, distance);
+            if (SkScalarIsNaN(t[n])) {
+                return false;
+            }
+        }
+        SkASSERT(ptIndex < (unsigned)fPts.count());
+        compute_pos_tan_x4(&fPts[ptIndex], segType, t, n,
+                           pos ? pos + i : nullptr, tangent ? tangent + i : nullptr);
+        i += n;
+    }
+    return true;
+}
+
 bool SkContourMeasure::getMatrix(SkScalar distance, SkMatrix* matrix, MatrixFlags flags) const {
     SkPoint     position;
     SkVector    tangent;
@@ -27,6 +27,7 @@
 #include "src/core/SkDrawProcs.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMatrixUtils.h"
+#include "src/core/SkPaintPriv.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRectPriv.h"
@@ -34,6 +35,7 @@
 #include "src/core/SkStroke.h"
 #include "src/core/SkTLazy.h"
 #include "src/core/SkUtils.h"
+#include "src/utils/SkDashPathPriv.h"
 
 #include <utility>
 
@@ -880,6 +882,51 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     proc(devPath, *fRC, blitter);
 }
 
+// Dashing can turn one path into millions of tiny contours. Streaming them through the stroker
+// and scan converter a batch at a time keeps memory constant in the number of dashes. Dashes in
+// different batches are blended separately where they overlap, so this is only done when drawing
+// a pixel twice looks the same as drawing it once: aliased, with a paint that overwrites.
+bool SkDraw::drawDashedPath(const SkPath& path, const SkPaint& paint, const SkMatrix& matrix,
+                            const SkRect* cullRect, bool drawCoverage,
+                            SkBlitter* customBlitter) const {
+    if (paint.isAntiAlias() ||
+        !SkPaintPriv::Overwrites(&paint, SkPaintPriv::kNone_ShaderOverrideOpacity)) {
+        return false;
+    }
+    SkPathEffect::DashInfo info;
+    // A mask filter needs to see the whole path at once.
+    if (paint.getMaskFilter() || !path.isFinite() ||
+        SkPathEffect::kDash_DashType != paint.getPathEffect()->asADash(&info)) {
+        return false;
+    }
+    SkAutoSTMalloc<8, SkScalar> intervals(info.fCount);
+    info.fIntervals = intervals.get();
+    paint.getPathEffect()->asADash(&info);
+
+    SkStrokeRec rec(paint, ComputeResScaleForStroking(*fMatrix));
+    SkAutoBlitterChoose blitterStorage;
+    SkBlitter* blitter = customBlitter;
+    SkPath strokedPath, devPath;
+    strokedPath.setIsVolatile(true);
+    devPath.setIsVolatile(true);
+
+    return SkDashPath::StreamDashPath(path, &rec, cullRect, info, [&](const SkPath& dashes) {
+        // The dasher may have switched rec to fill, having stroked the dashes itself.
+        const SkPath* batch = &dashes;
+        if (rec.applyToPath(&strokedPath, dashes)) {
+            batch = &strokedPath;
+        }
+        if (!batch->isFinite()) {
+            return;
+        }
+        if (!blitter) {
+            blitter = blitterStorage.choose(*this, nullptr, paint, drawCoverage);
+        }
+        batch->transform(matrix, &devPath);
+        this->drawDevPath(devPath, paint, drawCoverage, blitter, !rec.isHairlineStyle());
+    });
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -948,6 +995,11 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         if (this->computeConservativeLocalClipBounds(&cullRect)) {
             cullRectPtr = &cullRect;
         }
+        if (paint->getPathEffect() &&
+            this->drawDashedPath(*pathPtr, *paint, *matrix, cullRectPtr, drawCoverage,
+                                 customBlitter)) {
+            return;
+        }
         doFill = paint->getFillPath(*pathPtr, tmpPath, cullRectPtr,
                                     ComputeResScaleForStroking(*fMatrix));
         pathPtr = tmpPath;
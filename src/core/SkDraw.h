@@ -143,6 +143,19 @@ private:
                      bool drawCoverage,
                      SkBlitter* customBlitter,
                      bool doFill) const;
+
+    /**
+     *  If paint's path effect is a plain dash, and overlapping dashes can't change the pixels
+     *  drawn, stroke and draw the dashes of path in batches as they are produced, rather than
+     *  building the whole dashed path first. Returns false, having drawn nothing, if the caller
+     *  should dash the path itself.
+     */
+    bool drawDashedPath(const SkPath& path,
+                        const SkPaint& paint,
+                        const SkMatrix& matrix,
+                        const SkRect* cullRect,
+                        bool drawCoverage,
+                        SkBlitter* customBlitter) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -17,8 +17,10 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTime.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkBlurRescale.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
@@ -26,6 +28,7 @@
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
+#include "src/shaders/SkPictureShader.h"
 #include "src/utils/SkUTF.h"
 
 #include <stdlib.h>
@@ -41,6 +44,7 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkImageFilterCache::DumpMemoryStatistics(dump);
 }
 
 void SkGraphics::PurgeAllCaches() {
@@ -49,6 +53,14 @@ void SkGraphics::PurgeAllCaches() {
     SkImageFilter_Base::PurgeCache();
 }
 
+bool SkGraphics::SetApproximateLargeBlurs(bool enabled) {
+    return gSkApproximateLargeBlurs.exchange(enabled);
+}
+
+SkExecutor* SkGraphics::SetPictureShaderTileExecutor(SkExecutor* executor) {
+    return gSkPictureShaderTileExecutor.exchange(executor);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
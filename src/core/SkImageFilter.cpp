@@ -19,6 +19,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkSpecialSurface.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkValidationUtils.h"
 #include "src/core/SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -210,13 +211,22 @@ sk_sp<SkSpecialImage> SkImageFilter_Base::filterImage(SkSpecialImage* src, const
     const SkIRect srcSubset = fUsesSrcInput ? src->subset() : SkIRect::MakeWH(0, 0);
     SkImageFilterCacheKey key(fUniqueID, context.ctm(), context.clipBounds(), srcGenID, srcSubset);
     if (context.cache()) {
-        sk_sp<SkSpecialImage> result = context.cache()->get(key, offset);
+        sk_sp<SkSpecialImage> result = context.cache()->get(key, offset,
+                                                            context.partialCacheHits());
         if (result) {
             return result;
         }
     }
 
-    sk_sp<SkSpecialImage> result(this->onFilterImage(src, context, offset));
+    sk_sp<SkSpecialImage> result;
+    if (context.cache() && context.partialCacheHits() && !this->onIsClipIndependent()) {
+        // A result cropped from a larger clip's may not extend as far as a fresh one would.
+        Context exactContext(context.ctm(), context.clipBounds(), context.cache(),
+                             context.outputProperties(), context.executor(), false);
+        result = this->onFilterImage(src, exactContext, offset);
+    } else {
+        result = this->onFilterImage(src, context, offset);
+    }
 
 #if SK_SUPPORT_GPU
     if (src->isTextureBacked() && result && !result->isTextureBacked()) {
@@ -234,6 +244,72 @@ sk_sp<SkSpecialImage> SkImageFilter_Base::filterImage(SkSpecialImage* src, const
     return result;
 }
 
+void SkImageFilter_Base::filterImageTiled(SkSpecialImage* src, const Context& context,
+                                          int tileSize, const TileProc& proc) const {
+    SkASSERT(src && tileSize > 0);
+    if (!context.isValid()) {
+        return;
+    }
+
+    if (!this->canFilterTiled()) {
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        if (sk_sp<SkSpecialImage> result = this->filterImage(src, context, &offset)) {
+            proc(result.get(), offset, context.clipBounds());
+        }
+        return;
+    }
+
+    // Enough tiles to keep a few threads busy, while still bounding how many are alive at once.
+    static constexpr int kTilesPerBatch = 4;
+
+    const SkIRect& bounds = context.clipBounds();
+    SkTArray<SkIRect> tiles;
+    for (int y = bounds.fTop; y < bounds.fBottom; y += tileSize) {
+        for (int x = bounds.fLeft; x < bounds.fRight; x += tileSize) {
+            tiles.push_back(SkIRect::MakeLTRB(x, y, SkTMin(x + tileSize, bounds.fRight),
+                                              SkTMin(y + tileSize, bounds.fBottom)));
+        }
+    }
+
+    const bool parallel = context.executor() && !src->isTextureBacked();
+    for (int first = 0; first < tiles.count(); first += kTilesPerBatch) {
+        const int count = SkTMin(kTilesPerBatch, tiles.count() - first);
+
+        // Nodes used more than once within a tile still hit the cache, but nothing outlives the
+        // batch.
+        sk_sp<SkImageFilterCache> cache(
+                SkImageFilterCache::Create(SkImageFilterCache::kDefaultTransientSize));
+        sk_sp<SkSpecialImage> results[kTilesPerBatch];
+        SkIPoint offsets[kTilesPerBatch];
+        auto filterTile = [&](int i) {
+            Context tileContext(context.ctm(), tiles[first + i], cache.get(),
+                                context.outputProperties(), context.executor(),
+                                context.partialCacheHits());
+            offsets[i] = SkIPoint::Make(0, 0);
+            results[i] = this->filterImage(src, tileContext, &offsets[i]);
+        };
+
+        if (parallel && count > 1) {
+            SkTaskGroup tasks(*context.executor());
+            for (int i = 1; i < count; ++i) {
+                tasks.add([&filterTile, i] { filterTile(i); });
+            }
+            filterTile(0);
+            tasks.wait();
+        } else {
+            for (int i = 0; i < count; ++i) {
+                filterTile(i);
+            }
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (results[i]) {
+                proc(results[i].get(), offsets[i], tiles[first + i]);
+            }
+        }
+    }
+}
+
 bool SkImageFilter_Base::canHandleComplexCTM() const {
     // CropRects need to apply in the source coordinate system, but are not aware of complex CTMs
     // when performing clipping. For a simple fix, any filter with a crop rect set cannot support
@@ -251,6 +327,34 @@ bool SkImageFilter_Base::canHandleComplexCTM() const {
     return true;
 }
 
+bool SkImageFilter_Base::canFilterTiled() const {
+    if (!this->onCanFilterTiled()) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        const SkImageFilter_Base* input = as_IFB(this->getInput(i));
+        if (input && !input->canFilterTiled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkImageFilter_Base::isClipIndependent() const {
+    if (!this->onIsClipIndependent()) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        const SkImageFilter_Base* input = as_IFB(this->getInput(i));
+        if (input && !input->isClipIndependent()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void SkImageFilter::CropRect::applyTo(const SkIRect& imageBounds, const SkMatrix& ctm,
                                       bool embiggen, SkIRect* cropped) const {
     *cropped = imageBounds;
@@ -399,11 +503,62 @@ sk_sp<SkSpecialImage> SkImageFilter_Base::filterInput(int index,
     return result;
 }
 
+void SkImageFilter_Base::filterInputs(int count,
+                                      SkSpecialImage* src,
+                                      const Context& ctx,
+                                      sk_sp<SkSpecialImage> results[],
+                                      SkIPoint offsets[]) const {
+    SkASSERT(count <= this->countInputs());
+    auto filter = [&](int i) {
+        offsets[i] = SkIPoint::Make(0, 0);
+        results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+    };
+
+    // Each input only reads src and writes its own result, so they can run in any order. GPU
+    // work has to stay on the thread that owns the context.
+    if (!ctx.executor() || src->isTextureBacked() || count < 2) {
+        for (int i = 0; i < count; ++i) {
+            filter(i);
+        }
+        return;
+    }
+
+    // An input that appears more than once sees the same src and context each time, so it is
+    // only filtered once; this stands in for the cache hits a serial evaluation would get.
+    SkAutoSTArray<8, int> firstUse(count);
+    for (int i = 0; i < count; ++i) {
+        firstUse[i] = i;
+        for (int j = 0; j < i; ++j) {
+            if (this->getInput(j) == this->getInput(i)) {
+                firstUse[i] = j;
+                break;
+            }
+        }
+    }
+
+    SkTaskGroup tasks(*ctx.executor());
+    for (int i = 1; i < count; ++i) {
+        if (firstUse[i] == i) {
+            tasks.add([&filter, i] { filter(i); });
+        }
+    }
+    filter(0);
+    tasks.wait();
+
+    for (int i = 1; i < count; ++i) {
+        if (firstUse[i] != i) {
+            results[i] = results[firstUse[i]];
+            offsets[i] = offsets[firstUse[i]];
+        }
+    }
+}
+
 SkImageFilter_Base::Context SkImageFilter_Base::mapContext(const Context& ctx) const {
     SkIRect clipBounds = this->onFilterNodeBounds(ctx.clipBounds(), ctx.ctm(),
                                                   MapDirection::kReverse_MapDirection,
                                                   &ctx.clipBounds());
-    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties());
+    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties(), ctx.executor(),
+                   ctx.partialCacheHits());
 }
 
 #if SK_SUPPORT_GPU
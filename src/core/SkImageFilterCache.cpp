@@ -7,13 +7,16 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include <atomic>
 #include <vector>
 
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkOnce.h"
 #include "include/private/SkTHash.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkTDynamicHash.h"
@@ -27,27 +30,95 @@
 
 namespace {
 
+// The parts of a key that a partial hit has to match: everything but the clip bounds, and, when
+// the filter doesn't read its source, a whole-pixel translation of the CTM. The translation that
+// was normalized out is returned.
+struct RegionKey {
+    RegionKey() = default;
+    RegionKey(const SkImageFilterCacheKey& key, SkIPoint* translation)
+        : fUniqueID(key.fUniqueID)
+        , fMatrix(key.fMatrix)
+        , fSrcGenID(key.fSrcGenID)
+        , fSrcSubset(key.fSrcSubset) {
+        static_assert(sizeof(RegionKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
+                                           sizeof(uint32_t) + 4 * sizeof(int32_t),
+                      "region_key_tight_packing");
+        // Without a source, the result only depends on the CTM and the clip, and moving both by
+        // whole pixels moves the result with them.
+        static constexpr SkScalar kMaxTranslation = 1 << 24;
+        SkScalar tx = fMatrix.getTranslateX(),
+                 ty = fMatrix.getTranslateY();
+        *translation = SkIPoint::Make(0, 0);
+        if (0 == fSrcGenID && !fMatrix.hasPerspective() &&
+            SkScalarIsInt(tx) && SkScalarAbs(tx) < kMaxTranslation &&
+            SkScalarIsInt(ty) && SkScalarAbs(ty) < kMaxTranslation) {
+            *translation = SkIPoint::Make(SkScalarRoundToInt(tx), SkScalarRoundToInt(ty));
+            fMatrix.setTranslateX(0);
+            fMatrix.setTranslateY(0);
+        }
+        fMatrix.getType();  // force initialization of type, so hashes match
+    }
+
+    uint32_t fUniqueID;
+    SkMatrix fMatrix;
+    uint32_t fSrcGenID;
+    SkIRect  fSrcSubset;
+
+    bool operator==(const RegionKey& other) const {
+        return fUniqueID == other.fUniqueID &&
+               fMatrix == other.fMatrix &&
+               fSrcGenID == other.fSrcGenID &&
+               fSrcSubset == other.fSrcSubset;
+    }
+};
+
+template <typename T>
+static void remove_value(std::vector<T*>* values, T* v) {
+    for (auto it = values->begin(); it != values->end(); ++it) {
+        if (*it == v) {
+            values->erase(it);
+            break;
+        }
+    }
+}
+
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
     CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
     ~CacheImpl() override {
-        SkTDynamicHash<Value, Key>::Iter iter(&fLookup);
+        for (Shard& shard : fShards) {
+            SkTDynamicHash<Value, Key>::Iter iter(&shard.fLookup);
 
-        while (!iter.done()) {
-            Value* v = &*iter;
-            ++iter;
-            delete v;
+            while (!iter.done()) {
+                Value* v = &*iter;
+                ++iter;
+                delete v;
+            }
         }
     }
     struct Value {
         Value(const Key& key, SkSpecialImage* image, const SkIPoint& offset, const SkImageFilter* filter)
-            : fKey(key), fImage(SkRef(image)), fOffset(offset), fFilter(filter) {}
+            : fKey(key), fRegion(key, &fTranslation), fImage(SkRef(image)), fOffset(offset)
+            , fFilter(filter)
+            , fClipIndependent(filter && as_IFB(filter)->isClipIndependent()) {
+            fClip = key.fClipBounds.makeOffset(-fTranslation.fX, -fTranslation.fY);
+            fBounds = SkIRect::MakeXYWH(offset.fX - fTranslation.fX, offset.fY - fTranslation.fY,
+                                        image->width(), image->height());
+        }
 
         Key fKey;
+        SkIPoint fTranslation;
+        RegionKey fRegion;
+        // The clip bounds and the result's bounds, without fTranslation.
+        SkIRect fClip;
+        SkIRect fBounds;
         sk_sp<SkSpecialImage> fImage;
         SkIPoint fOffset;
         const SkImageFilter* fFilter;
+        // Only then may a smaller clip be served from this result; otherwise just a pan of it.
+        bool fClipIndependent;
+        uint64_t fLastUse;
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
@@ -57,99 +128,201 @@ public:
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
     };
 
-    sk_sp<SkSpecialImage> get(const Key& key, SkIPoint* offset) const override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
+    sk_sp<SkSpecialImage> get(const Key& key, SkIPoint* offset, bool partial) const override {
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        if (Value* v = shard.fLookup.find(key)) {
             *offset = v->fOffset;
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
+            this->touch(&shard, v);
+            fHits.fetch_add(1, std::memory_order_relaxed);
             return v->fImage;
         }
+        if (!partial) {
+            fMisses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        // A result computed for a larger clip holds every pixel this request can produce, as long
+        // as the filter's output doesn't depend on the clip.
+        SkIPoint translation;
+        if (auto* values = shard.fRegions.find(RegionKey(key, &translation))) {
+            SkIRect clip = key.fClipBounds.makeOffset(-translation.fX, -translation.fY);
+            for (Value* v : *values) {
+                SkIRect bounds;
+                if (!v->fClip.contains(clip) || (!v->fClipIndependent && v->fClip != clip) ||
+                    !bounds.intersect(v->fBounds, clip)) {
+                    continue;
+                }
+                sk_sp<SkSpecialImage> subset = v->fImage->makeSubset(
+                        bounds.makeOffset(-v->fBounds.fLeft, -v->fBounds.fTop));
+                if (subset) {
+                    *offset = SkIPoint::Make(bounds.fLeft + translation.fX,
+                                             bounds.fTop + translation.fY);
+                    this->touch(&shard, v);
+                    fPartialHits.fetch_add(1, std::memory_order_relaxed);
+                    return subset;
+                }
+            }
+        }
+        fMisses.fetch_add(1, std::memory_order_relaxed);
         return nullptr;
     }
 
     void set(const Key& key, SkSpecialImage* image, const SkIPoint& offset, const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            this->removeInternal(v);
-        }
+        Shard& shard = this->shardFor(key);
         Value* v = new Value(key, image, offset, filter);
-        fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += image->getSize();
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
-        }
-
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
+        {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (Value* old = shard.fLookup.find(key)) {
+                this->removeInternal(&shard, old);
+            }
+            v->fLastUse = fClock.fetch_add(1, std::memory_order_relaxed);
+            shard.fLookup.add(v);
+            shard.fLRU.addToHead(v);
+            fCurrentBytes.fetch_add(image->getSize(), std::memory_order_relaxed);
+            if (auto* values = shard.fRegions.find(v->fRegion)) {
+                values->push_back(v);
+            } else {
+                shard.fRegions.set(v->fRegion, {v});
+            }
+            if (auto* values = shard.fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                shard.fImageFilterValues.set(filter, {v});
+            }
+        }
+
+        // Evict the least recently used of the shards' oldest entries until back under budget,
+        // but never the entry just added.
+        while (fCurrentBytes.load(std::memory_order_relaxed) > fMaxBytes) {
+            Shard* oldest = nullptr;
+            uint64_t oldestUse = UINT64_MAX;
+            for (Shard& candidate : fShards) {
+                SkAutoMutexExclusive mutex(candidate.fMutex);
+                Value* tail = candidate.fLRU.tail();
+                if (tail && tail != v && tail->fLastUse < oldestUse) {
+                    oldest = &candidate;
+                    oldestUse = tail->fLastUse;
+                }
+            }
+            if (!oldest) {
                 break;
             }
-            this->removeInternal(tail);
+            SkAutoMutexExclusive mutex(oldest->fMutex);
+            Value* tail = oldest->fLRU.tail();
+            if (tail && tail != v) {
+                this->removeInternal(oldest, tail);
+            }
         }
     }
 
     void purge() override {
-        SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            while (Value* tail = shard.fLRU.tail()) {
+                this->removeInternal(&shard, tail);
+            }
         }
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        auto* values = fImageFilterValues.find(filter);
-        if (!values) {
-            return;
-        }
-        for (Value* v : *values) {
-            // We set the filter to be null so that removeInternal() won't delete from values while
-            // we're iterating over it.
-            v->fFilter = nullptr;
-            this->removeInternal(v);
-        }
-        fImageFilterValues.remove(filter);
+        // Keys carry the filter's unique ID, not the filter, so its entries could be in any shard.
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            auto* values = shard.fImageFilterValues.find(filter);
+            if (!values) {
+                continue;
+            }
+            for (Value* v : *values) {
+                // We set the filter to be null so that removeInternal() won't delete from values
+                // while we're iterating over it.
+                v->fFilter = nullptr;
+                this->removeInternal(&shard, v);
+            }
+            shard.fImageFilterValues.remove(filter);
+        }
+    }
+
+    SkDEBUGCODE(int count() const override { return this->countEntries(); })
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump, const char* dumpName) const override {
+        dump->dumpNumericValue(dumpName, "size", "bytes",
+                               fCurrentBytes.load(std::memory_order_relaxed));
+        dump->dumpNumericValue(dumpName, "budget_size", "bytes", fMaxBytes);
+        dump->dumpNumericValue(dumpName, "entry_count", "objects", this->countEntries());
+        dump->dumpNumericValue(dumpName, "hit_count", "objects",
+                               fHits.load(std::memory_order_relaxed));
+        dump->dumpNumericValue(dumpName, "partial_hit_count", "objects",
+                               fPartialHits.load(std::memory_order_relaxed));
+        dump->dumpNumericValue(dumpName, "miss_count", "objects",
+                               fMisses.load(std::memory_order_relaxed));
     }
 
-    SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
-    void removeInternal(Value* v) {
+    // Entries are spread over independently locked shards by filter, so that concurrent filtering
+    // of different nodes rarely contends. Every entry that can satisfy a request is in the
+    // request's shard. The byte budget is shared.
+    static constexpr int kShardCount = 8;
+
+    struct Shard {
+        SkTDynamicHash<Value, Key>                            fLookup;
+        SkTInternalLList<Value>                               fLRU;
+        // Value* always points to an item in fLookup.
+        SkTHashMap<RegionKey, std::vector<Value*>>            fRegions;
+        SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+        SkMutex                                               fMutex;
+    };
+
+    Shard& shardFor(const Key& key) const { return fShards[key.fUniqueID % kShardCount]; }
+
+    void touch(Shard* shard, Value* v) const {
+        v->fLastUse = fClock.fetch_add(1, std::memory_order_relaxed);
+        if (v != shard->fLRU.head()) {
+            shard->fLRU.remove(v);
+            shard->fLRU.addToHead(v);
+        }
+    }
+
+    int countEntries() const {
+        int count = 0;
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            count += shard.fLookup.count();
+        }
+        return count;
+    }
+
+    void removeInternal(Shard* shard, Value* v) {
         SkASSERT(v->fImage);
         if (v->fFilter) {
-            if (auto* values = fImageFilterValues.find(v->fFilter)) {
+            if (auto* values = shard->fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
-                    fImageFilterValues.remove(v->fFilter);
+                    shard->fImageFilterValues.remove(v->fFilter);
                 } else {
-                    for (auto it = values->begin(); it != values->end(); ++it) {
-                        if (*it == v) {
-                            values->erase(it);
-                            break;
-                        }
-                    }
+                    remove_value(values, v);
                 }
             }
         }
-        fCurrentBytes -= v->fImage->getSize();
-        fLRU.remove(v);
-        fLookup.remove(v->fKey);
+        if (auto* values = shard->fRegions.find(v->fRegion)) {
+            if (values->size() == 1 && (*values)[0] == v) {
+                shard->fRegions.remove(v->fRegion);
+            } else {
+                remove_value(values, v);
+            }
+        }
+        fCurrentBytes.fetch_sub(v->fImage->getSize(), std::memory_order_relaxed);
+        shard->fLRU.remove(v);
+        shard->fLookup.remove(v->fKey);
         delete v;
     }
 private:
-    SkTDynamicHash<Value, Key>                            fLookup;
-    mutable SkTInternalLList<Value>                       fLRU;
-    // Value* always points to an item in fLookup.
-    SkTHashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
-    size_t                                                fMaxBytes;
-    size_t                                                fCurrentBytes;
-    mutable SkMutex                                       fMutex;
+    mutable Shard                 fShards[kShardCount];
+    size_t                        fMaxBytes;
+    std::atomic<size_t>           fCurrentBytes;
+    mutable std::atomic<uint64_t> fClock{0};
+    mutable std::atomic<int64_t>  fHits{0};
+    mutable std::atomic<int64_t>  fPartialHits{0};
+    mutable std::atomic<int64_t>  fMisses{0};
 };
 
 } // namespace
@@ -165,3 +338,7 @@ SkImageFilterCache* SkImageFilterCache::Get() {
     once([]{ cache = SkImageFilterCache::Create(kDefaultCacheSize); });
     return cache;
 }
+
+void SkImageFilterCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    Get()->dumpMemoryStatistics(dump, "skia/sk_image_filter_cache");
+}
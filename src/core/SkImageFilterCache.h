@@ -14,6 +14,7 @@
 struct SkIPoint;
 class SkImageFilter;
 class SkSpecialImage;
+class SkTraceMemoryDump;
 
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
@@ -48,6 +49,12 @@ struct SkImageFilterCacheKey {
 
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to
 // (result, offset).
+//
+// When there is no exact match, get() can also return the part of a cached result whose clipBounds
+// contain the requested ones, given the same filter, source and CTM, if the filter is clip
+// independent (see SkImageFilter_Base::isClipIndependent()). For filters that don't read their
+// source, CTMs and clipBounds that differ only by the same whole-pixel translation match too, and
+// the result is shifted by that translation.
 class SkImageFilterCache : public SkRefCnt {
 public:
     enum { kDefaultTransientSize = 32 * 1024 * 1024 };
@@ -55,12 +62,21 @@ public:
     virtual ~SkImageFilterCache() {}
     static SkImageFilterCache* Create(size_t maxBytes);
     static SkImageFilterCache* Get();
-    virtual sk_sp<SkSpecialImage> get(const SkImageFilterCacheKey& key, SkIPoint* offset) const = 0;
+    // Only an exact match of key is returned unless partial is true.
+    virtual sk_sp<SkSpecialImage> get(const SkImageFilterCacheKey& key, SkIPoint* offset,
+                                      bool partial = true) const = 0;
     virtual void set(const SkImageFilterCacheKey& key, SkSpecialImage* image,
                      const SkIPoint& offset, const SkImageFilter* filter) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
+
+    // Reports the cache's size, budget, entry count and exact hits, partial hits and misses under
+    // dumpName.
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump* dump, const char* dumpName) const = 0;
+
+    // Dumps the global cache, Get(), as "skia/sk_image_filter_cache".
+    static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 };
 
 #endif
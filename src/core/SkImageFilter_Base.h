@@ -13,12 +13,15 @@
 #include "include/core/SkImageInfo.h"
 #include "include/private/SkTArray.h"
 
+#include <functional>
+
 #if SK_SUPPORT_GPU
 #include "include/gpu/GrTypes.h"
 #endif
 
 class GrFragmentProcessor;
 class GrRecordingContext;
+class SkExecutor;
 class SkSpecialImage;
 class SkSpecialSurface;
 class SkImageFilterCache;
@@ -50,11 +53,14 @@ public:
     class Context {
     public:
         Context(const SkMatrix& ctm, const SkIRect& clipBounds, SkImageFilterCache* cache,
-                const OutputProperties& outputProperties)
+                const OutputProperties& outputProperties, SkExecutor* executor = nullptr,
+                bool partialCacheHits = true)
             : fCTM(ctm)
             , fClipBounds(clipBounds)
             , fCache(cache)
             , fOutputProperties(outputProperties)
+            , fExecutor(executor)
+            , fPartialCacheHits(partialCacheHits)
         {}
 
         const SkMatrix& ctm() const { return fCTM; }
@@ -62,6 +68,19 @@ public:
         SkImageFilterCache* cache() const { return fCache; }
         const OutputProperties& outputProperties() const { return fOutputProperties; }
 
+        /**
+         *  If not null, independent inputs of raster-backed filters may be evaluated
+         *  concurrently on this executor (see filterInputs()).
+         */
+        SkExecutor* executor() const { return fExecutor; }
+
+        /**
+         *  Whether the cache may serve this request from a result computed for a larger clip.
+         *  filterImage() turns this off below filters that aren't clip independent, since those
+         *  can depend on how far their inputs' results extend.
+         */
+        bool partialCacheHits() const { return fPartialCacheHits; }
+
         /**
          *  Since a context can be build directly, its constructor has no chance to
          *  "return null" if it's given invalid or unsupported inputs. Call this to
@@ -77,6 +96,8 @@ public:
         SkIRect                fClipBounds;
         SkImageFilterCache*    fCache;
         OutputProperties       fOutputProperties;
+        SkExecutor*            fExecutor;
+        bool                   fPartialCacheHits;
     };
 
     /**
@@ -98,6 +119,26 @@ public:
     sk_sp<SkSpecialImage> filterImage(SkSpecialImage* src, const Context& context,
                                       SkIPoint* offset) const;
 
+    using TileProc = std::function<void(SkSpecialImage* image, const SkIPoint& offset,
+                                        const SkIRect& tile)>;
+
+    /**
+     *  Like filterImage(), but splits the context's clip bounds into tiles of at most
+     *  tileSize x tileSize and filters each tile separately, so each node's intermediate images
+     *  only cover a tile plus the margin (from onFilterNodeBounds) its consumers need, instead of
+     *  the whole output.
+     *
+     *  proc is called, in row-major tile order, for each tile that produced an image. Only the
+     *  image's pixels inside "tile" are valid; they match what filterImage() would produce there.
+     *  If the DAG can't be filtered tile by tile (see canFilterTiled()), the whole clip bounds are
+     *  filtered at once and handed to proc as a single tile.
+     *  Tiles are filtered a small batch at a time, concurrently if the context has an executor
+     *  and src is not texture backed. The context's cache is not used, so that finished tiles
+     *  do not accumulate in it.
+     */
+    void filterImageTiled(SkSpecialImage* src, const Context& context, int tileSize,
+                          const TileProc& proc) const;
+
     /**
      *  Returns whether any edges of the crop rect have been set. The crop
      *  rect is set at construction time, and determines which pixels from the
@@ -124,6 +165,21 @@ public:
      */
     bool canHandleComplexCTM() const;
 
+    /**
+     *  Returns true iff the filter and all of its (non-null) inputs produce the same pixels in a
+     *  tile of their output when asked only for that tile, with their inputs asked only for the
+     *  bounds onFilterNodeBounds() maps it back to.
+     */
+    bool canFilterTiled() const;
+
+    /**
+     *  Returns true iff the filter and all of its (non-null) inputs have opted in, through
+     *  onIsClipIndependent(), to producing the same pixels inside a clip whatever larger clip
+     *  they are filtered with. The cache only serves a smaller clip from a larger one's result
+     *  for such DAGs.
+     */
+    bool isClipIndependent() const;
+
     /**
      * Return an image filter representing this filter applied with the given ctm. This will modify
      * the DAG as needed if this filter does not support complex CTMs and 'ctm' is not simple. The
@@ -253,6 +309,15 @@ protected:
                                       const Context&,
                                       SkIPoint* offset) const;
 
+    // Calls filterInput() for each of the first "count" inputs, storing the results and offsets
+    // in "results" and "offsets". If the context has an executor and "src" is not texture
+    // backed, the inputs are filtered concurrently; the results are the same either way.
+    void filterInputs(int count,
+                      SkSpecialImage* src,
+                      const Context&,
+                      sk_sp<SkSpecialImage> results[],
+                      SkIPoint offsets[]) const;
+
     /**
      *  Return true (and returns a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -267,6 +332,19 @@ protected:
      */
     virtual bool onCanHandleComplexCTM() const { return false; }
 
+    /**
+     *  Override this to return false, as a leaf node, if the subclass' output in a region depends
+     *  on more of its input than onFilterNodeBounds() reports, or on the bounds it's asked for.
+     */
+    virtual bool onCanFilterTiled() const { return true; }
+
+    /**
+     *  Override this to return true, as a leaf node, if the subclass' output inside the clip
+     *  bounds never depends on how far those bounds extend: no edge handling, tiling or wrapping
+     *  keyed to the clip or to input bounds derived from it.
+     */
+    virtual bool onIsClipIndependent() const { return false; }
+
     const CropRect* getCropRectIfSet() const {
         return this->cropRectIsSet() ? &fCropRect : nullptr;
     }
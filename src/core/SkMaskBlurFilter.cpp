@@ -13,6 +13,7 @@
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlurRescale.h"
 #include "src/core/SkGaussFilter.h"
 
 #include <cmath>
@@ -949,6 +950,38 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// The approximation from SkBlurRescale: blur a reduced copy of the A8 src, then scale it back up
+// into dst, which already has the bounds and borders of the full resolution blur.
+static bool rescaled_blur(int kx, int ky, double reducedSigmaW, double reducedSigmaH,
+                          const SkMask& src, SkMask* dst, int borderW, int borderH) {
+    SkMask lowSrc;
+    lowSrc.fFormat = SkMask::kA8_Format;
+    lowSrc.fBounds = SkIRect::MakeWH(SkBlurRescale::ReducedSize(src.fBounds.width(), kx),
+                                     SkBlurRescale::ReducedSize(src.fBounds.height(), ky));
+    lowSrc.fRowBytes = lowSrc.fBounds.width();
+    lowSrc.fImage = SkMask::AllocImage(lowSrc.computeImageSize());
+    SkAutoMaskFreeImage autoLowSrc(lowSrc.fImage);
+    SkBlurRescale::Downsample(1, kx, ky,
+                              src.fImage, src.fRowBytes, src.fBounds.width(), src.fBounds.height(),
+                              lowSrc.fImage, lowSrc.fRowBytes);
+
+    SkMask lowDst;
+    SkMaskBlurFilter{reducedSigmaW, reducedSigmaH}.blur(lowSrc, &lowDst);
+    SkAutoMaskFreeImage autoLowDst(lowDst.fImage);
+    if (lowDst.fImage == nullptr) {
+        return false;
+    }
+
+    // lowSrc, and so the reduced grid, starts at the top left of src.
+    SkBlurRescale::Upsample(1, kx, ky,
+                            lowDst.fImage, lowDst.fRowBytes,
+                            lowDst.fBounds.width(), lowDst.fBounds.height(),
+                            lowDst.fBounds.left(), lowDst.fBounds.top(),
+                            dst->fImage, dst->fRowBytes,
+                            dst->fBounds.width(), dst->fBounds.height(), borderW, borderH);
+    return true;
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
@@ -976,6 +1009,22 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         return {0, 0};
     }
 
+    if (gSkApproximateLargeBlurs.load(std::memory_order_relaxed) &&
+        src.fFormat == SkMask::kA8_Format) {
+        double reducedSigmaW, reducedSigmaH;
+        int kx = SkBlurRescale::Plan(fSigmaW, &reducedSigmaW),
+            ky = SkBlurRescale::Plan(fSigmaH, &reducedSigmaH);
+        if (kx > 0 || ky > 0) {
+            if (!rescaled_blur(kx, ky, reducedSigmaW, reducedSigmaH, src, dst, borderW, borderH)) {
+                SkMask::FreeImage(dst->fImage);
+                dst->fImage = nullptr;
+                dst->fBounds.setEmpty();
+                return {0, 0};
+            }
+            return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+        }
+    }
+
     int srcW = src.fBounds.width(),
         srcH = src.fBounds.height(),
         dstW = dst->fBounds.width(),
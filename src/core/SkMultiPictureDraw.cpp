@@ -8,7 +8,12 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMultiPictureDraw.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/SkTArray.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkDevice.h"
+#include "src/core/SkTSort.h"
 #include "src/core/SkTaskGroup.h"
 
 void SkMultiPictureDraw::DrawData::draw() {
@@ -73,19 +78,95 @@ public:
     ~AutoMPDReset() { fMPD->reset(); }
 };
 
+// Finds the pixels a raster canvas draws into. Returns false for canvases without pixels of their
+// own: those that record, forward their draws to other canvases, or have some other backend.
+static bool raster_target(SkCanvas* canvas, const char** begin, const char** end) {
+    SkBaseDevice* device = SkCanvasPriv::BaseDevice(canvas);
+    SkPixmap pixmap;
+    if (!device || !device->accessPixels(&pixmap) || !pixmap.addr()) {
+        return false;
+    }
+    *begin = static_cast<const char*>(pixmap.addr());
+    *end = *begin + pixmap.computeByteSize();
+    return true;
+}
+
 //#define FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
 
 void SkMultiPictureDraw::draw(bool flush) {
     AutoMPDReset mpdreset(this);
 
+    auto drawThreadSafe = [this, flush](int i) {
+        fThreadSafeDrawData[i].draw();
+        if (flush) {
+            fThreadSafeDrawData[i].fCanvas->flush();
+        }
+    };
+
 #ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
     for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
-        fThreadSafeDrawData[i].draw();
+        drawThreadSafe(i);
     }
 #else
-    SkTaskGroup().batch(fThreadSafeDrawData.count(), [&](int i) {
-        fThreadSafeDrawData[i].draw();
-    });
+    // Draws into raster canvases whose pixels don't overlap can run concurrently. Draws into the
+    // same pixels, through one canvas or several, are kept in order on one task.
+    struct Target {
+        const char* fBegin;
+        const char* fEnd;
+        int         fIndex;
+    };
+    SkTDArray<Target> targets;
+    SkTArray<SkTDArray<int>> groups;
+    auto drawTargets = [&] {
+        // Sorted by where their pixels start, the draws into overlapping pixels are runs.
+        if (targets.count() > 1) {
+            SkTQSort(targets.begin(), targets.end() - 1, [](const Target& a, const Target& b) {
+                return a.fBegin < b.fBegin || (a.fBegin == b.fBegin && a.fIndex < b.fIndex);
+            });
+        }
+        groups.reset();
+        const char* groupEnd = nullptr;
+        for (const Target& target : targets) {
+            if (groups.empty() || target.fBegin >= groupEnd) {
+                groups.push_back();
+                groupEnd = target.fEnd;
+            }
+            groups.back().push_back(target.fIndex);
+            groupEnd = SkTMax(groupEnd, target.fEnd);
+        }
+        for (SkTDArray<int>& group : groups) {
+            if (group.count() > 1) {
+                SkTQSort(group.begin(), group.end() - 1);
+            }
+        }
+
+        if (groups.count() > 1) {
+            SkTaskGroup().batch(groups.count(), [&](int g) {
+                for (int i : groups[g]) {
+                    drawThreadSafe(i);
+                }
+            });
+        } else if (groups.count() == 1) {
+            for (int i : groups[0]) {
+                drawThreadSafe(i);
+            }
+        }
+        targets.rewind();
+    };
+
+    for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
+        Target target;
+        if (raster_target(fThreadSafeDrawData[i].fCanvas, &target.fBegin, &target.fEnd)) {
+            target.fIndex = i;
+            targets.push_back(target);
+        } else {
+            // Other canvases may draw into the pixels of the raster ones, so finish the raster
+            // draws added before this one first, and start the ones after it only once it's done.
+            drawTargets();
+            drawThreadSafe(i);
+        }
+    }
+    drawTargets();
 #endif
 
     // N.B. we could get going on any GPU work from this main thread while the CPU work runs.
@@ -39,6 +39,7 @@
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkBoxBlur_opts.h"
 #include "src/opts/SkChecksum_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
@@ -81,6 +82,8 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(cubic_solver);
 
+    DEFINE_DEFAULT(box_blur_8888);
+
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
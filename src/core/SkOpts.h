@@ -54,6 +54,11 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // The CPU three pass box blur used by SkBlurImageFilter, over "lines" lines of 8888 pixels.
+    extern void (*box_blur_8888)(int window, int srcLeft, int srcRight, int dstRight,
+                                 const uint32_t* src, int srcXStride, int srcYStride, int lines,
+                                 uint32_t* dst, int dstXStride, int dstYStride);
+
     // The fastest high quality 32-bit hash we can provide on this platform.
     extern uint32_t (*hash_fn)(const void*, size_t, uint32_t seed);
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
@@ -17,6 +17,7 @@
 #include "src/core/SkCubicClipper.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkPathAccel.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
 #include "src/core/SkSafeMath.h"
@@ -3554,12 +3555,8 @@ bool SkPath::contains(SkScalar x, SkScalar y) const {
     bool done = false;
     int w = 0;
     int onCurveCount = 0;
-    do {
-        SkPoint pts[4];
-        switch (iter.next(pts, false)) {
-            case SkPath::kMove_Verb:
-            case SkPath::kClose_Verb:
-                break;
+    auto winding = [&](SkPath::Verb verb, const SkPoint pts[], SkScalar weight) {
+        switch (verb) {
             case SkPath::kLine_Verb:
                 w += winding_line(pts, x, y, &onCurveCount);
                 break;
@@ -3567,16 +3564,33 @@ bool SkPath::contains(SkScalar x, SkScalar y) const {
                 w += winding_quad(pts, x, y, &onCurveCount);
                 break;
             case SkPath::kConic_Verb:
-                w += winding_conic(pts, x, y, iter.conicWeight(), &onCurveCount);
+                w += winding_conic(pts, x, y, weight, &onCurveCount);
                 break;
             case SkPath::kCubic_Verb:
                 w += winding_cubic(pts, x, y, &onCurveCount);
                 break;
-            case SkPath::kDone_Verb:
-                done = true;
+            default:
                 break;
-       }
-    } while (!done);
+        }
+    };
+    // Large paths that are queried repeatedly only look at the segments spanning y.
+    const SkPathAccel::WindingTree* tree = nullptr;
+    if (fPathRef->countVerbs() >= SkPathAccel::kMinVerbsForWindingTree) {
+        tree = SkPathPriv::Accel(*this)->windingTree(*this);
+    }
+    if (tree) {
+        tree->forEachSegmentCrossing(y, winding);
+    } else {
+        do {
+            SkPoint pts[4];
+            SkPath::Verb verb = iter.next(pts, false);
+            if (SkPath::kDone_Verb == verb) {
+                done = true;
+            } else {
+                winding(verb, pts, SkPath::kConic_Verb == verb ? iter.conicWeight() : 1);
+            }
+        } while (!done);
+    }
     bool evenOddFill = SkPath::kEvenOdd_FillType == this->getFillType()
             || SkPath::kInverseEvenOdd_FillType == this->getFillType();
     if (evenOddFill) {
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPathAccel.h"
+
+#include "src/core/SkPathPriv.h"
+
+#include <algorithm>
+
+SkPathAccel* SkPathPriv::Accel(const SkPath& path) {
+    const SkPathRef* ref = path.fPathRef.get();
+    SkPathAccel* accel = ref->fAccel.load(std::memory_order_acquire);
+    if (!accel) {
+        SkPathAccel* fresh = new SkPathAccel;
+        if (ref->fAccel.compare_exchange_strong(accel, fresh, std::memory_order_acq_rel)) {
+            accel = fresh;
+        } else {
+            delete fresh;   // another thread beat us to it; accel now holds theirs
+        }
+    }
+    return accel;
+}
+
+const SkPathAccel::WindingTree* SkPathAccel::windingTree(const SkPath& path) {
+    if (path.countVerbs() < kMinVerbsForWindingTree || !path.isFinite()) {
+        return nullptr;
+    }
+    // A single query is cheaper as a plain walk, so only index paths that are queried again.
+    if (fWindingRequests.load(std::memory_order_relaxed) < 1) {
+        fWindingRequests.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    fWindingOnce([&] { fWindingTree.reset(new WindingTree(path)); });
+    return fWindingTree.get();
+}
+
+bool SkPathAccel::tightBounds(const SkPath& path, SkRect* bounds,
+                              bool (*compute)(const SkPath&, SkRect*)) {
+    fTightBoundsOnce([&] { fTightBoundsValid = compute(path, &fTightBounds); });
+    if (fTightBoundsValid) {
+        *bounds = fTightBounds;
+    }
+    return fTightBoundsValid;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkPathAccel::WindingTree::WindingTree(const SkPath& path) {
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        int count;
+        switch (verb) {
+            case SkPath::kLine_Verb:  count = 2; break;
+            case SkPath::kQuad_Verb:
+            case SkPath::kConic_Verb: count = 3; break;
+            case SkPath::kCubic_Verb: count = 4; break;
+            default:                  continue;
+        }
+        SkScalar top = pts[0].fY,
+                 bottom = pts[0].fY;
+        for (int i = 1; i < count; ++i) {
+            top = SkTMin(top, pts[i].fY);
+            bottom = SkTMax(bottom, pts[i].fY);
+        }
+        // Chopping curves at their extrema can round a hair outside the control points.
+        SkScalar slop = SkTMax(SkScalarAbs(top), SkScalarAbs(bottom)) * (1.0f / (1 << 16));
+        Segment* seg = fSegments.append();
+        seg->fTop = top - slop;
+        seg->fBottom = bottom + slop;
+        seg->fWeight = SkPath::kConic_Verb == verb ? iter.conicWeight() : 1;
+        seg->fPtIndex = fPoints.count();
+        seg->fVerb = SkToU8(verb);
+        fPoints.append(count, pts);
+    }
+
+    SkTDArray<int> indices;
+    indices.setCount(fSegments.count());
+    for (int i = 0; i < indices.count(); ++i) {
+        indices[i] = i;
+    }
+    fByTop.setReserve(fSegments.count());
+    fByBottom.setReserve(fSegments.count());
+    fRoot = this->build(indices.begin(), indices.count());
+}
+
+int SkPathAccel::WindingTree::build(int indices[], int count) {
+    if (0 == count) {
+        return -1;
+    }
+    auto mid = [this](int i) { return fSegments[i].fTop * 0.5f + fSegments[i].fBottom * 0.5f; };
+
+    // Splitting at the median midpoint leaves at most half of the segments on either side.
+    std::nth_element(indices, indices + count / 2, indices + count,
+                     [&](int a, int b) { return mid(a) < mid(b); });
+    SkScalar center = mid(indices[count / 2]);
+    int* aboveEnd = std::partition(indices, indices + count,
+                                   [&](int i) { return fSegments[i].fBottom < center; });
+    int* crossingEnd = std::partition(aboveEnd, indices + count,
+                                      [&](int i) { return fSegments[i].fTop <= center; });
+    SkASSERT(crossingEnd > aboveEnd);
+
+    int nodeIndex = fNodes.count();
+    Node* node = fNodes.append();
+    node->fCenter = center;
+    node->fStart = fByTop.count();
+    node->fCount = SkToInt(crossingEnd - aboveEnd);
+
+    int* byTop = fByTop.append(node->fCount, aboveEnd);
+    std::sort(byTop, byTop + node->fCount,
+              [this](int a, int b) { return fSegments[a].fTop < fSegments[b].fTop; });
+    int* byBottom = fByBottom.append(node->fCount, aboveEnd);
+    std::sort(byBottom, byBottom + node->fCount,
+              [this](int a, int b) { return fSegments[a].fBottom > fSegments[b].fBottom; });
+
+    // fNodes may move while building the children.
+    int left = this->build(indices, SkToInt(aboveEnd - indices));
+    int right = this->build(crossingEnd, SkToInt(indices + count - crossingEnd));
+    fNodes[nodeIndex].fLeft = left;
+    fNodes[nodeIndex].fRight = right;
+    return nodeIndex;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathAccel_DEFINED
+#define SkPathAccel_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/private/SkOnce.h"
+#include "include/private/SkTDArray.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ *  Data derived from a path's verbs and points that speeds up repeated queries on the same path
+ *  (e.g. hit-testing). An SkPathAccel is attached to an SkPathRef on demand (see
+ *  SkPathPriv::Accel()) and discarded as soon as the path ref's contents change, so each piece is
+ *  computed at most once per generation ID. All methods are thread safe.
+ */
+class SkPathAccel {
+public:
+    /**
+     *  The segments of a path, as returned by SkPath::Iter with forceClose, bucketed by their
+     *  vertical extent in a centered interval tree. Finding the segments that may cross a
+     *  horizontal line takes O(log n + k) rather than O(n).
+     */
+    class WindingTree {
+    public:
+        explicit WindingTree(const SkPath&);
+
+        /**
+         *  Calls fn(verb, pts, weight) for every segment that may cross the line at y; all others
+         *  are guaranteed not to. Segments are visited in no particular order.
+         */
+        template <typename Fn> void forEachSegmentCrossing(SkScalar y, Fn&& fn) const {
+            for (int n = fRoot; n >= 0;) {
+                const Node& node = fNodes[n];
+                const int* begin;
+                const int* end;
+                if (y < node.fCenter) {
+                    // Every segment in this node ends below y; stop at the first starting below.
+                    for (begin = &fByTop[node.fStart], end = begin + node.fCount;
+                         begin < end && fSegments[*begin].fTop <= y; ++begin) {
+                        this->visit(fSegments[*begin], fn);
+                    }
+                    n = node.fLeft;
+                } else if (y > node.fCenter) {
+                    for (begin = &fByBottom[node.fStart], end = begin + node.fCount;
+                         begin < end && fSegments[*begin].fBottom >= y; ++begin) {
+                        this->visit(fSegments[*begin], fn);
+                    }
+                    n = node.fRight;
+                } else {
+                    for (begin = &fByTop[node.fStart], end = begin + node.fCount;
+                         begin < end; ++begin) {
+                        this->visit(fSegments[*begin], fn);
+                    }
+                    break;
+                }
+            }
+        }
+
+        int countSegments() const { return fSegments.count(); }
+
+    private:
+        struct Segment {
+            SkScalar fTop, fBottom;     // conservative: covers all control points
+            SkScalar fWeight;
+            int      fPtIndex;          // first point in fPoints
+            uint8_t  fVerb;
+        };
+        struct Node {
+            SkScalar fCenter;
+            int      fStart, fCount;    // range in fByTop and fByBottom
+            int      fLeft, fRight;     // segments entirely above/below fCenter, or -1
+        };
+
+        template <typename Fn> void visit(const Segment& seg, Fn& fn) const {
+            fn((SkPath::Verb)seg.fVerb, &fPoints[seg.fPtIndex], seg.fWeight);
+        }
+
+        int build(int indices[], int count);
+
+        SkTDArray<SkPoint> fPoints;
+        SkTDArray<Segment> fSegments;
+        SkTDArray<Node>    fNodes;
+        SkTDArray<int>     fByTop;      // each node's segments, sorted by increasing fTop
+        SkTDArray<int>     fByBottom;   // each node's segments, sorted by decreasing fBottom
+        int                fRoot;
+    };
+
+    /**
+     *  Paths with fewer verbs than this are cheap enough to walk, so they are never indexed.
+     */
+    static constexpr int kMinVerbsForWindingTree = 64;
+
+    /**
+     *  Returns the winding tree for path, building it on the second request, or nullptr if the
+     *  path is not worth indexing (yet). Non-finite paths are never indexed.
+     */
+    const WindingTree* windingTree(const SkPath& path);
+
+    /**
+     *  Returns compute(path, bounds), calling compute only the first time.
+     */
+    bool tightBounds(const SkPath& path, SkRect* bounds, bool (*compute)(const SkPath&, SkRect*));
+
+private:
+    std::atomic<int>             fWindingRequests{0};
+    SkOnce                       fWindingOnce;
+    std::unique_ptr<WindingTree> fWindingTree;
+
+    SkOnce                       fTightBoundsOnce;
+    SkRect                       fTightBounds;
+    bool                         fTightBoundsValid;
+};
+
+#endif
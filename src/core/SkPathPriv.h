@@ -10,6 +10,8 @@
 
 #include "include/core/SkPath.h"
 
+class SkPathAccel;
+
 class SkPathPriv {
 public:
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -272,6 +274,41 @@ public:
         SkRect tmp;
         return (path.fPathRef->fIsRRect | path.fPathRef->fIsOval) || path.isRect(&tmp);
     }
+
+    /**
+     *  Returns the lazily created accelerator attached to the path's SkPathRef. It lives until
+     *  the path ref's contents change.
+     */
+    static SkPathAccel* Accel(const SkPath& path);
+
+    /**
+     *  How WriteToMemory() stores the points of a general path. Conic weights are always
+     *  stored as floats.
+     */
+    enum class PointEncoding {
+        kFloat,     // 8 bytes per point, exact; may be referenced in place by ReadFromData()
+        kHalf,      // 4 bytes per point, half-float precision
+        kQuantized, // rounded to multiples of 1/(1 << fracBits), delta-coded as varints
+    };
+    static constexpr int kMaxQuantizedFracBits = 16;
+
+    /**
+     *  Like SkPath::writeToMemory(), but lets the caller trade precision for size. If the path
+     *  cannot be represented by the requested encoding (e.g. it has non-finite points, or points
+     *  out of range), it is written with PointEncoding::kFloat instead. The result can be read
+     *  by SkPath::readFromMemory() and ReadFromData().
+     */
+    static size_t WriteToMemory(const SkPath& path, void* storage, PointEncoding,
+                                int fracBits = 4);
+    static sk_sp<SkData> Serialize(const SkPath& path, PointEncoding, int fracBits = 4);
+
+    /**
+     *  Like SkPath::readFromMemory(), reading from data starting at offset. If the path was
+     *  written with PointEncoding::kFloat and the data is suitably aligned, the path references
+     *  the points and verbs inside data (keeping it alive) instead of copying them. Returns the
+     *  number of bytes read, or zero on failure.
+     */
+    static size_t ReadFromData(SkPath* path, sk_sp<SkData> data, size_t offset = 0);
 };
 
 #endif
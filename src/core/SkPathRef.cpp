@@ -12,6 +12,7 @@
 #include "include/private/SkOnce.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkBuffer.h"
+#include "src/core/SkPathAccel.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkSafeMath.h"
 
@@ -33,7 +34,7 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
     SkASSERT(incReserveVerbs >= 0);
     SkASSERT(incReservePoints >= 0);
 
-    if ((*pathRef)->unique()) {
+    if ((*pathRef)->unique() && !(*pathRef)->fBackingData) {
         (*pathRef)->incReserve(incReserveVerbs, incReservePoints);
     } else {
         SkPathRef* copy = new SkPathRef;
@@ -94,7 +95,9 @@ SkPathRef::~SkPathRef() {
     // to read one that's not valid and then free its memory without asserting.
     this->callGenIDChangeListeners();
     SkASSERT(fGenIDChangeListeners.empty());  // These are raw ptrs.
-    sk_free(fPoints);
+    if (!fBackingData) {
+        sk_free(fPoints);
+    }
 
     SkDEBUGCODE(fPoints = nullptr;)
     SkDEBUGCODE(fVerbs = nullptr;)
@@ -184,7 +187,12 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
         return;
     }
 
-    if (!(*dst)->unique()) {
+    // When transforming in place, src may only be alive through dst.
+    sk_sp<SkPathRef> keepSrcAlive;
+    if (!(*dst)->unique() || (*dst)->fBackingData) {
+        if (dst->get() == &src) {
+            keepSrcAlive = sk_ref_sp(&src);
+        }
         dst->reset(new SkPathRef);
     }
 
@@ -320,6 +328,20 @@ static bool deduce_pts_conics(const uint8_t verbs[], int vCount, int* ptCountPtr
     return true;
 }
 
+// Check that the verbs are valid, and imply the given number of pts and conics.
+static bool validate_contents(const uint8_t verbs[], int vCount, int ptCount,
+                              const SkScalar weights[], int conicCount) {
+    int pCount, cCount;
+    if (!validate_verb_sequence(verbs, vCount)) {
+        return false;
+    }
+    if (!deduce_pts_conics(verbs, vCount, &pCount, &cCount) ||
+        pCount != ptCount || cCount != conicCount) {
+        return false;
+    }
+    return validate_conic_weights(weights, conicCount);
+}
+
 SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
     std::unique_ptr<SkPathRef> ref(new SkPathRef);
 
@@ -373,15 +395,8 @@ SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
 
     // Check that the verbs are valid, and imply the correct number of pts and conics
     {
-        int pCount, cCount;
-        if (!validate_verb_sequence(ref->verbsMemBegin(), ref->countVerbs())) {
-            return nullptr;
-        }
-        if (!deduce_pts_conics(ref->verbsMemBegin(), ref->countVerbs(), &pCount, &cCount) ||
-            pCount != ref->countPoints() || cCount != ref->fConicWeights.count()) {
-            return nullptr;
-        }
-        if (!validate_conic_weights(ref->fConicWeights.begin(), ref->fConicWeights.count())) {
+        if (!validate_contents(ref->verbsMemBegin(), ref->countVerbs(), ref->countPoints(),
+                               ref->fConicWeights.begin(), ref->fConicWeights.count())) {
             return nullptr;
         }
         // Check that the bounds match the serialized bounds.
@@ -399,8 +414,47 @@ SkPathRef* SkPathRef::CreateFromBuffer(SkRBuffer* buffer) {
     return ref.release();
 }
 
+SkPathRef* SkPathRef::CreateFromData(sk_sp<SkData> data,
+                                     const SkPoint points[], int pointCount,
+                                     const uint8_t verbs[], int verbCount,
+                                     const SkScalar weights[], int weightCount) {
+    if (pointCount < 0 || verbCount < 0 || weightCount < 0 ||
+        !validate_contents(verbs, verbCount, pointCount, weights, weightCount)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkPathRef> ref(new SkPathRef);
+
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(points);
+    const uint8_t* end = verbs + verbCount;
+    bool canBorrow = data && pointCount > 0 &&
+                     SkIsAlign4(reinterpret_cast<uintptr_t>(points)) &&
+                     reinterpret_cast<const uint8_t*>(points + pointCount) == verbs &&
+                     begin >= data->bytes() && end <= data->bytes() + data->size();
+    if (canBorrow) {
+        // Never written through while fBackingData is set (see Editor).
+        ref->fBackingData = std::move(data);
+        ref->fPoints = const_cast<SkPoint*>(points);
+        ref->fVerbs = const_cast<uint8_t*>(verbs + verbCount);
+        ref->fPointCnt = pointCount;
+        ref->fVerbCnt = verbCount;
+        ref->fFreeSpace = 0;
+        ref->fGenerationID = 0;
+        ref->fConicWeights.append(weightCount, weights);
+    } else {
+        ref->resetToSize(verbCount, pointCount, weightCount);
+        sk_careful_memcpy(ref->verbsMemWritable(), verbs, verbCount * sizeof(uint8_t));
+        sk_careful_memcpy(ref->fPoints, points, pointCount * sizeof(SkPoint));
+        sk_careful_memcpy(ref->fConicWeights.begin(), weights, weightCount * sizeof(SkScalar));
+    }
+    // call this after validate_contents, since it relies on valid verbs
+    ref->fSegmentMask = ref->computeSegmentMask();
+    SkDEBUGCODE(ref->validate();)
+    return ref.release();
+}
+
 void SkPathRef::Rewind(sk_sp<SkPathRef>* pathRef) {
-    if ((*pathRef)->unique()) {
+    if ((*pathRef)->unique() && !(*pathRef)->fBackingData) {
         SkDEBUGCODE((*pathRef)->validate();)
         (*pathRef)->callGenIDChangeListeners();
         (*pathRef)->fBoundsIsDirty = true;  // this also invalidates fIsFinite
@@ -729,6 +783,10 @@ void SkPathRef::addGenIDChangeListener(sk_sp<GenIDChangeListener> listener) {
 
 // we need to be called *before* the genID gets changed or zerod
 void SkPathRef::callGenIDChangeListeners() {
+    // This is called whenever the contents are about to change (or go away), which only happens
+    // while we're unique, so nobody else can be using the accelerator.
+    delete fAccel.exchange(nullptr, std::memory_order_relaxed);
+
     SkAutoMutexExclusive lock(fGenIDChangeListenersMutex);
     for (GenIDChangeListener* listener : fGenIDChangeListeners) {
         if (!listener->shouldUnregisterFromPath()) {
@@ -7,6 +7,7 @@
 
 #include "include/core/SkData.h"
 #include "include/core/SkMath.h"
+#include "include/private/SkHalf.h"
 #include "include/private/SkPathRef.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkBuffer.h"
@@ -19,6 +20,8 @@
 enum SerializationOffsets {
     kType_SerializationShift = 28,       // requires 4 bits
     kDirection_SerializationShift = 26,  // requires 2 bits
+    kFracBits_SerializationShift = 18,   // requires 5 bits
+    kEncoding_SerializationShift = 16,   // requires 2 bits
     kFillType_SerializationShift = 8,    // requires 8 bits
     // low-8-bits are version
     kVersion_SerializationMask = 0xFF,
@@ -29,8 +32,9 @@ enum SerializationVersions {
     kPathPrivLastMoveToIndex_Version = 2,
     kPathPrivTypeEnumVersion = 3,
     kJustPublicData_Version = 4,    // introduced Feb/2018
+    kCompact_Version = 5,           // verbs follow points, optional point encodings
 
-    kCurrent_Version = kJustPublicData_Version
+    kCurrent_Version = kCompact_Version
 };
 
 enum SerializationType {
@@ -50,6 +54,151 @@ static SerializationType extract_serializationtype(uint32_t packed) {
     return static_cast<SerializationType>((packed >> kType_SerializationShift) & 0xF);
 }
 
+static SkPathPriv::PointEncoding extract_encoding(uint32_t packed) {
+    return static_cast<SkPathPriv::PointEncoding>((packed >> kEncoding_SerializationShift) & 0x3);
+}
+
+static int extract_fracbits(uint32_t packed) {
+    return (packed >> kFracBits_SerializationShift) & 0x1F;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Point encodings used by kCompact_Version.
+
+static constexpr float kMaxHalf = 65504.0f;
+static constexpr float kMaxQuantized = 1 << 29;     // keeps deltas within int32
+
+static bool points_fit_encoding(const SkPoint pts[], int count,
+                                SkPathPriv::PointEncoding encoding, int fracBits) {
+    if (encoding == SkPathPriv::PointEncoding::kFloat) {
+        return true;
+    }
+    const float limit = encoding == SkPathPriv::PointEncoding::kHalf
+                      ? kMaxHalf : kMaxQuantized / (1 << fracBits);
+    for (int i = 0; i < count; ++i) {
+        // written so that NaN fails
+        if (!(std::abs(pts[i].fX) <= limit && std::abs(pts[i].fY) <= limit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void encode_half(const SkPoint pts[], int count, SkHalf dst[]) {
+    const float* src = &pts[0].fX;
+    int n = 2 * count;
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        SkFloatToHalf_finite_ftz(Sk4f::Load(src)).store(dst);
+    }
+    if (n) {
+        SkHalf tmp[4];
+        SkFloatToHalf_finite_ftz(Sk4f(src[0], src[1], 0, 0)).store(tmp);
+        dst[0] = tmp[0];
+        dst[1] = tmp[1];
+    }
+}
+
+static void decode_half(const SkHalf src[], int count, SkPoint pts[]) {
+    float* dst = &pts[0].fX;
+    int n = 2 * count;
+    uint64_t four;
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        memcpy(&four, src, sizeof(four));
+        SkHalfToFloat_finite_ftz(four).store(dst);
+    }
+    if (n) {
+        SkHalf tmp[4] = { src[0], src[1], 0, 0 };
+        memcpy(&four, tmp, sizeof(four));
+        float xy[4];
+        SkHalfToFloat_finite_ftz(four).store(xy);
+        dst[0] = xy[0];
+        dst[1] = xy[1];
+    }
+}
+
+// Quantized points are stored as the zigzag varint deltas of x and y from the previous point.
+// Returns the number of bytes needed, and writes them if dst is not null.
+static size_t encode_quantized(const SkPoint pts[], int count, int fracBits, uint8_t* dst) {
+    const float scale = 1 << fracBits;
+    size_t bytes = 0;
+    int32_t prev[2] = { 0, 0 };
+    for (int i = 0; i < count; ++i) {
+        const float xy[2] = { pts[i].fX, pts[i].fY };
+        for (int j = 0; j < 2; ++j) {
+            int32_t q = sk_float_round2int(xy[j] * scale);
+            int32_t delta = q - prev[j];
+            prev[j] = q;
+            uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+            do {
+                uint8_t byte = zigzag & 0x7F;
+                zigzag >>= 7;
+                if (dst) {
+                    dst[bytes] = byte | (zigzag ? 0x80 : 0);
+                }
+                bytes++;
+            } while (zigzag);
+        }
+    }
+    return bytes;
+}
+
+static bool decode_quantized(const uint8_t src[], size_t length, int fracBits,
+                             int count, SkPoint pts[]) {
+    const float invScale = 1.0f / (1 << fracBits);
+    const uint8_t* stop = src + length;
+    uint32_t prev[2] = { 0, 0 };
+    for (int i = 0; i < count; ++i) {
+        float xy[2];
+        for (int j = 0; j < 2; ++j) {
+            uint32_t zigzag = 0;
+            for (int shift = 0;; shift += 7) {
+                if (src == stop || shift > 28) {
+                    return false;
+                }
+                uint8_t byte = *src++;
+                zigzag |= (uint32_t)(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+            // unsigned math, so that bad data can't overflow
+            prev[j] += (zigzag >> 1) ^ (0 - (zigzag & 1));
+            xy[j] = (int32_t)prev[j] * invScale;
+        }
+        pts[i].set(xy[0], xy[1]);
+    }
+    return src == stop;
+}
+
+// Returns what SkPath::fLastMoveToIndex would be after building these verbs (in memory order).
+static int last_move_to_index(const uint8_t verbs[], int count) {
+    int lastMoveToIndex = ~0;
+    int ptIndex = 0;
+    for (int i = count - 1; i >= 0; --i) {
+        switch (verbs[i]) {
+            case SkPath::kMove_Verb:
+                lastMoveToIndex = ptIndex;
+                // fall through
+            case SkPath::kLine_Verb:
+                ptIndex += 1;
+                break;
+            case SkPath::kQuad_Verb:
+            case SkPath::kConic_Verb:
+                ptIndex += 2;
+                break;
+            case SkPath::kCubic_Verb:
+                ptIndex += 3;
+                break;
+            case SkPath::kClose_Verb:
+                if (lastMoveToIndex >= 0) {
+                    lastMoveToIndex = ~lastMoveToIndex;
+                }
+                break;
+        }
+    }
+    return lastMoveToIndex;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkPath::writeToMemoryAsRRect(void* storage) const {
@@ -87,26 +236,57 @@ size_t SkPath::writeToMemoryAsRRect(void* storage) const {
 }
 
 size_t SkPath::writeToMemory(void* storage) const {
-    SkDEBUGCODE(this->validate();)
+    return SkPathPriv::WriteToMemory(*this, storage, SkPathPriv::PointEncoding::kFloat);
+}
+
+size_t SkPathPriv::WriteToMemory(const SkPath& path, void* storage, PointEncoding encoding,
+                                 int fracBits) {
+    SkDEBUGCODE(path.validate();)
 
-    if (size_t bytes = this->writeToMemoryAsRRect(storage)) {
+    if (size_t bytes = path.writeToMemoryAsRRect(storage)) {
         return bytes;
     }
 
-    int32_t packed = (fFillType << kFillType_SerializationShift) |
+    const SkPathRef& ref = *path.fPathRef;
+    int32_t pts = ref.countPoints();
+    int32_t cnx = ref.countWeights();
+    int32_t vbs = ref.countVerbs();
+
+    fracBits = SkTPin(fracBits, 0, kMaxQuantizedFracBits);
+    if (!points_fit_encoding(ref.points(), pts, encoding, fracBits)) {
+        encoding = PointEncoding::kFloat;
+    }
+    if (encoding != PointEncoding::kQuantized) {
+        fracBits = 0;
+    }
+
+    int32_t packed = (path.fFillType << kFillType_SerializationShift) |
+                     ((int)encoding << kEncoding_SerializationShift) |
+                     (fracBits << kFracBits_SerializationShift) |
                      (SerializationType::kGeneral << kType_SerializationShift) |
                      kCurrent_Version;
 
-    int32_t pts = fPathRef->countPoints();
-    int32_t cnx = fPathRef->countWeights();
-    int32_t vbs = fPathRef->countVerbs();
-
     SkSafeMath safe;
+    size_t quantizedBytes = 0;
     size_t size = 4 * sizeof(int32_t);
-    size = safe.add(size, safe.mul(pts, sizeof(SkPoint)));
-    size = safe.add(size, safe.mul(cnx, sizeof(SkScalar)));
+    switch (encoding) {
+        case PointEncoding::kFloat:
+            size = safe.add(size, safe.mul(pts, sizeof(SkPoint)));
+            break;
+        case PointEncoding::kHalf:
+            size = safe.add(size, safe.mul(pts, 2 * sizeof(SkHalf)));
+            break;
+        case PointEncoding::kQuantized:
+            quantizedBytes = encode_quantized(ref.points(), pts, fracBits, nullptr);
+            size = safe.add(size, sizeof(int32_t) + quantizedBytes);
+            if (!SkTFitsIn<int32_t>(quantizedBytes)) {
+                return 0;
+            }
+            break;
+    }
     size = safe.add(size, safe.mul(vbs, sizeof(uint8_t)));
     size = safe.alignUp(size, 4);
+    size = safe.add(size, safe.mul(cnx, sizeof(SkScalar)));
     if (!safe) {
         return 0;
     }
@@ -119,10 +299,22 @@ size_t SkPath::writeToMemory(void* storage) const {
     buffer.write32(pts);
     buffer.write32(cnx);
     buffer.write32(vbs);
-    buffer.write(fPathRef->points(), pts * sizeof(SkPoint));
-    buffer.write(fPathRef->conicWeights(), cnx * sizeof(SkScalar));
-    buffer.write(fPathRef->verbsMemBegin(), vbs * sizeof(uint8_t));
+    switch (encoding) {
+        case PointEncoding::kFloat:
+            buffer.write(ref.points(), pts * sizeof(SkPoint));
+            break;
+        case PointEncoding::kHalf:
+            encode_half(ref.points(), pts, (SkHalf*)buffer.skip(pts * 2 * sizeof(SkHalf)));
+            break;
+        case PointEncoding::kQuantized:
+            buffer.write32(SkToS32(quantizedBytes));
+            encode_quantized(ref.points(), pts, fracBits, (uint8_t*)buffer.skip(quantizedBytes));
+            break;
+    }
+    // The verbs directly follow the points, so that a reader can use them in place.
+    buffer.write(ref.verbsMemBegin(), vbs * sizeof(uint8_t));
     buffer.padToAlign4();
+    buffer.write(ref.conicWeights(), cnx * sizeof(SkScalar));
 
     SkASSERT(buffer.pos() == size);
     return size;
@@ -135,6 +327,13 @@ sk_sp<SkData> SkPath::serialize() const {
     return data;
 }
 
+sk_sp<SkData> SkPathPriv::Serialize(const SkPath& path, PointEncoding encoding, int fracBits) {
+    size_t size = WriteToMemory(path, nullptr, encoding, fracBits);
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    WriteToMemory(path, data->writable_data(), encoding, fracBits);
+    return data;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////
 // reading
 
@@ -151,9 +350,30 @@ size_t SkPath::readFromMemory(const void* storage, size_t length) {
     if (version == kJustPublicData_Version) {
         return this->readFromMemory_EQ4(storage, length);
     }
+    if (version == kCompact_Version) {
+        return this->readFromMemory_EQ5(storage, length, nullptr);
+    }
     return 0;
 }
 
+size_t SkPathPriv::ReadFromData(SkPath* path, sk_sp<SkData> data, size_t offset) {
+    if (!data || offset > data->size()) {
+        return 0;
+    }
+    const void* storage = data->bytes() + offset;
+    size_t length = data->size() - offset;
+
+    SkRBuffer buffer(storage, length);
+    uint32_t packed;
+    if (!buffer.readU32(&packed)) {
+        return 0;
+    }
+    if (extract_version(packed) == kCompact_Version) {
+        return path->readFromMemory_EQ5(storage, length, data.get());
+    }
+    return path->readFromMemory(storage, length);
+}
+
 size_t SkPath::readAsRRect(const void* storage, size_t length) {
     SkRBuffer buffer(storage, length);
     uint32_t packed;
@@ -278,6 +498,90 @@ size_t SkPath::readFromMemory_EQ4(const void* storage, size_t length) {
     return buffer.pos();
 }
 
+size_t SkPath::readFromMemory_EQ5(const void* storage, size_t length, SkData* backingData) {
+    SkRBuffer buffer(storage, length);
+    uint32_t packed;
+    if (!buffer.readU32(&packed)) {
+        return 0;
+    }
+
+    SkASSERT(extract_version(packed) == kCompact_Version);
+
+    switch (extract_serializationtype(packed)) {
+        case SerializationType::kRRect:
+            return this->readAsRRect(storage, length);
+        case SerializationType::kGeneral:
+            break;  // fall through
+        default:
+            return 0;
+    }
+
+    int32_t pts, cnx, vbs;
+    if (!buffer.readS32(&pts) || !buffer.readS32(&cnx) || !buffer.readS32(&vbs) ||
+        pts < 0 || cnx < 0 || vbs < 0) {
+        return 0;
+    }
+
+    SkPathPriv::PointEncoding encoding = extract_encoding(packed);
+    int fracBits = extract_fracbits(packed);
+    SkAutoTMalloc<SkPoint> decoded;
+    const SkPoint* points = nullptr;
+    switch (encoding) {
+        case SkPathPriv::PointEncoding::kFloat:
+            points = buffer.skipCount<SkPoint>(pts);
+            break;
+        case SkPathPriv::PointEncoding::kHalf:
+            if (auto halves = buffer.skipCount<SkHalf>(2 * SkToSizeT(pts))) {
+                decoded.reset(pts);
+                decode_half(halves, pts, decoded.get());
+                points = decoded.get();
+            }
+            break;
+        case SkPathPriv::PointEncoding::kQuantized: {
+            int32_t bytes;
+            if (!buffer.readS32(&bytes) || bytes < 0 ||
+                fracBits > SkPathPriv::kMaxQuantizedFracBits) {
+                return 0;
+            }
+            // Each coordinate takes at least one byte.
+            const uint8_t* src = buffer.skipCount<uint8_t>(bytes);
+            if (!src || pts > bytes / 2) {
+                return 0;
+            }
+            decoded.reset(pts);
+            if (!decode_quantized(src, bytes, fracBits, pts, decoded.get())) {
+                return 0;
+            }
+            points = decoded.get();
+        } break;
+        default:
+            return 0;
+    }
+    const uint8_t* verbs = buffer.skipCount<uint8_t>(vbs);
+    buffer.skipToAlign4();
+    const SkScalar* conics = buffer.skipCount<SkScalar>(cnx);
+    if (!buffer.isValid()) {
+        return 0;
+    }
+    SkASSERT(buffer.pos() <= length);
+
+    sk_sp<SkData> borrow = encoding == SkPathPriv::PointEncoding::kFloat ? sk_ref_sp(backingData)
+                                                                        : nullptr;
+    sk_sp<SkPathRef> ref(SkPathRef::CreateFromData(std::move(borrow), points, pts,
+                                                   verbs, vbs, conics, cnx));
+    if (!ref) {
+        return 0;
+    }
+
+    SkPath tmp;
+    tmp.fPathRef = std::move(ref);
+    tmp.fLastMoveToIndex = last_move_to_index(verbs, vbs);
+    tmp.setFillType(extract_filltype(packed));
+
+    *this = std::move(tmp);
+    return buffer.pos();
+}
+
 size_t SkPath::readFromMemory_LE3(const void* storage, size_t length) {
     SkRBuffer buffer(storage, length);
 
@@ -11,12 +11,16 @@
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTaskGroup.h"
 #include <atomic>
 
 // When we read/write the SkPictInfo via a stream, we have a sentinel byte right after the info.
@@ -132,6 +136,30 @@ sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
     return r.finishRecordingAsPicture();
 }
 
+// Plays back SkPictureData read with an op index directly, rather than converting it to an
+// SkBigPicture as Forwardport() does, so that only what each playback draws is ever read.
+class SkLazyPicture final : public SkPicture {
+public:
+    SkLazyPicture(const SkRect& cull, std::unique_ptr<const SkPictureData> data)
+        : fCullRect(cull)
+        , fData(std::move(data)) {}
+
+    void playback(SkCanvas* canvas, AbortCallback* callback) const override {
+        SkPicturePlayback playback(fData.get());
+        playback.draw(canvas, callback, nullptr);
+    }
+
+    SkRect cullRect() const override { return fCullRect; }
+    int approximateOpCount() const override { return fData->opRanges().count(); }
+    size_t approximateBytesUsed() const override {
+        return sizeof(*this) + fData->opData()->size();
+    }
+
+private:
+    const SkRect                         fCullRect;
+    std::unique_ptr<const SkPictureData> fData;
+};
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procs) {
     return MakeFromStream(stream, procs, nullptr);
 }
@@ -153,8 +181,17 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, const SkDeserialPro
     return MakeFromStream(&stream, procs, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromDataLazily(sk_sp<SkData> data, const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    return MakeFromStream(&stream, procs, nullptr, data.get());
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialProcs* procsPtr,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           const SkData* lazySource) {
     SkPictInfo info;
     if (!StreamIsSKP(stream, &info)) {
         return nullptr;
@@ -170,7 +207,10 @@ sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, const SkDeserialPro
     switch (trailingStreamByteAfterPictInfo) {
         case kPictureData_TrailingStreamByteAfterPictInfo: {
             std::unique_ptr<SkPictureData> data(
-                    SkPictureData::CreateFromStream(stream, info, procs, typefaces));
+                    SkPictureData::CreateFromStream(stream, info, procs, typefaces, lazySource));
+            if (data && data->opBBH()) {
+                return sk_make_sp<SkLazyPicture>(info.fCullRect, std::move(data));
+            }
             return Forwardport(info, data.get(), nullptr);
         }
         case kCustom_TrailingStreamByteAfterPictInfo: {
@@ -214,13 +254,53 @@ sk_sp<SkPicture> SkPicturePriv::MakeFromBuffer(SkReadBuffer& buffer) {
     return SkPicture::Forwardport(info, data.get(), &buffer);
 }
 
-SkPictureData* SkPicture::backport() const {
+// Plays picture into rec one SkRecord op at a time, noting which part of rec's op stream each op
+// wrote and the bounds it draws within. big is picture if it is an SkBigPicture, or null.
+static void playback_indexed(const SkPicture* picture, const SkBigPicture* big, const SkRect& cull,
+                             SkPictureRecord* rec, SkTDArray<SkPictureOpRange>* ranges) {
+    const SkRecord* record;
+    SkPicture const* const* drawablePicts = nullptr;
+    int drawableCount = 0;
+    sk_sp<SkRecord> rerecorded;
+    if (big) {
+        record = big->record();
+        drawablePicts = big->drawablePicts();
+        drawableCount = big->drawableCount();
+    } else {
+        rerecorded = sk_make_sp<SkRecord>();
+        SkRecorder recorder(rerecorded.get(), cull);
+        picture->playback(&recorder);
+        record = rerecorded.get();
+    }
+
+    SkAutoTMalloc<SkRect> bounds(record->count());
+    SkRecordFillBounds(cull, *record, bounds.get());
+
+    SkRecords::Draw draw(rec, drawablePicts, nullptr, drawableCount);
+    for (int i = 0; i < record->count(); i++) {
+        const size_t start = rec->writeStream().bytesWritten();
+        record->visit(i, draw);
+        const size_t end = rec->writeStream().bytesWritten();
+        if (end > start) {
+            ranges->push_back({SkToU32(start), SkToU32(end), bounds[i]});
+        }
+    }
+}
+
+SkPictureData* SkPicture::backport(bool indexOps) const {
     SkPictInfo info = this->createHeader();
     SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
+    SkTDArray<SkPictureOpRange> ranges;
     rec.beginRecording();
+    if (indexOps) {
+        playback_indexed(this, this->asSkBigPicture(), info.fCullRect, &rec, &ranges);
+    } else {
         this->playback(&rec);
+    }
     rec.endRecording();
-    return new SkPictureData(rec, info);
+    SkPictureData* data = new SkPictureData(rec, info);
+    data->setOpIndex(std::move(ranges));
+    return data;
 }
 
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procs) const {
@@ -261,8 +341,10 @@ static bool write_pad32(SkWStream* stream, const void* data, size_t size) {
 // Private serialize.
 // SkPictureData::serialize makes a first pass on all subpictures, indicatewd by textBlobsOnly=true,
 // to fill typefaceSet.
+// prepared, if not null, holds what prepareSerialize() did for this picture with these procs.
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
-                          SkRefCntSet* typefaceSet, bool textBlobsOnly) const {
+                          SkRefCntSet* typefaceSet, bool textBlobsOnly,
+                          const SkPreparedPicture* prepared) const {
     SkSerialProcs procs;
     if (procsPtr) {
         procs = *procsPtr;
@@ -271,7 +353,11 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     SkPictInfo info = this->createHeader();
     stream->write(&info, sizeof(info));
 
-    if (auto custom = custom_serialize(this, procs)) {
+    // The first pass is made without procs, so it never writes the custom format.
+    sk_sp<SkData> custom = !prepared    ? custom_serialize(this, procs)
+                         : textBlobsOnly ? nullptr
+                                         : prepared->fCustom;
+    if (custom) {
         int32_t size = SkToS32(custom->size());
         if (size == 0) {
             stream->write8(kFailure_TrailingStreamByteAfterPictInfo);
@@ -283,7 +369,18 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
         return;
     }
 
-    std::unique_ptr<SkPictureData> data(this->backport());
+    std::unique_ptr<SkPictureData> backported;
+    const SkPictureData* data = prepared ? prepared->fData.get() : nullptr;
+    if (!data) {
+        backported.reset(this->backport(procs.fIndexPictureOps));
+        // Only the top level call waits, having prepared the whole tree of sub-pictures at once.
+        if (backported && procs.fExecutor && !typefaceSet && !textBlobsOnly) {
+            SkTaskGroup tasks(*procs.fExecutor);
+            backported->prepareSerialize(procs, &tasks);
+            tasks.wait();
+        }
+        data = backported.get();
+    }
     if (data) {
         stream->write8(kPictureData_TrailingStreamByteAfterPictInfo);
         data->serialize(stream, procs, typefaceSet, textBlobsOnly);
@@ -292,6 +389,16 @@ void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procsPtr,
     }
 }
 
+void SkPicture::prepareSerialize(const SkSerialProcs& procs, SkPreparedPicture* prepared,
+                                 SkTaskGroup* tasks) const {
+    prepared->fCustom = custom_serialize(this, procs);
+    prepared->fData.reset(this->backport(procs.fIndexPictureOps));
+    // With the custom format only the typefaces of the backported data are used.
+    if (!prepared->fCustom) {
+        prepared->fData->prepareSerialize(procs, tasks);
+    }
+}
+
 void SkPicturePriv::Flatten(const sk_sp<const SkPicture> picture, SkWriteBuffer& buffer) {
     SkPictInfo info = picture->createHeader();
     std::unique_ptr<SkPictureData> data(picture->backport());
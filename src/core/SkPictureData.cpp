@@ -9,12 +9,15 @@
 
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkTypeface.h"
+#include "include/private/SkTHash.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkMakeUnique.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkPictureRecord.h"
+#include "src/core/SkRTree.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobPriv.h"
 #include "src/core/SkWriteBuffer.h"
 
@@ -61,6 +64,10 @@ SkPictureData::SkPictureData(const SkPictureRecord& record,
     this->initForPlayback();
 }
 
+void SkPictureData::setOpIndex(SkTDArray<SkPictureOpRange> ranges) {
+    fOpRanges = std::move(ranges);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -144,7 +151,32 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec,
     }
 }
 
-void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) const {
+// Lays out the SK_PICT_OP_INDEX_TAG as
+//     count, count SkPictureOpRanges,
+//     count, count path offsets into the SK_PICT_BUFFER_SIZE_TAG chunk,
+//     count, count image offsets into it,
+// then pads it to put the chunks that follow four byte aligned in the stream, which is what lets
+// SkPictureData::CreateFromStream() read them in place.
+void SkPictureData::writeOpIndex(SkWStream* stream, const ObjectOffsets& offsets) const {
+    const size_t size = sizeof(uint32_t) + fOpRanges.count() * sizeof(SkPictureOpRange)
+                      + sizeof(uint32_t) + offsets.fPaths.count() * sizeof(uint32_t)
+                      + sizeof(uint32_t) + offsets.fImages.count() * sizeof(uint32_t);
+    const size_t end = stream->bytesWritten() + 2 * sizeof(uint32_t) + size;
+    const size_t pad = SkAlign4(end) - end;
+
+    write_tag_size(stream, SK_PICT_OP_INDEX_TAG, size + pad);
+    stream->write32(fOpRanges.count());
+    stream->write(fOpRanges.begin(), fOpRanges.count() * sizeof(SkPictureOpRange));
+    for (const SkTDArray<uint32_t>* array : {&offsets.fPaths, &offsets.fImages}) {
+        stream->write32(array->count());
+        stream->write(array->begin(), array->count() * sizeof(uint32_t));
+    }
+    const uint32_t zero = 0;
+    stream->write(&zero, pad);
+}
+
+void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly,
+                                    ObjectOffsets* offsets) const {
     int i, n;
 
     if (!textBlobsOnly) {
@@ -159,8 +191,14 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) c
             write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
             buffer.writeInt(n);
             for (int i = 0; i < n; i++) {
+                if (offsets) {
+                    offsets->mark(&offsets->fPaths);
+                }
                 buffer.writePath(fPaths[i]);
             }
+            if (offsets) {
+                offsets->mark(&offsets->fPaths);
+            }
         }
     }
 
@@ -182,8 +220,14 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, bool textBlobsOnly) c
         if (!fImages.empty()) {
             write_tag_size(buffer, SK_PICT_IMAGE_BUFFER_TAG, fImages.count());
             for (const auto& img : fImages) {
+                if (offsets) {
+                    offsets->mark(&offsets->fImages);
+                }
                 buffer.writeImage(img.get());
             }
+            if (offsets) {
+                offsets->mark(&offsets->fImages);
+            }
         }
     }
 }
@@ -200,6 +244,49 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
     return newProcs;
 }
 
+// What SkBinaryWriteBuffer::writeImage() encodes an image as.
+static sk_sp<SkData> encode_image(SkImage* image, const SkSerialProcs& procs) {
+    sk_sp<SkData> data;
+    if (procs.fImageProc) {
+        data = procs.fImageProc(image, procs.fImageCtx);
+    }
+    return data ? data : image->encodeToData();
+}
+
+void SkPictureData::prepareSerialize(const SkSerialProcs& procs, SkTaskGroup* tasks) {
+    fEncodedImages.reset(fImages.count());
+    for (int i = 0; i < fImages.count(); ++i) {
+        // Reading back a texture is not safe off the thread that owns its context.
+        if (!fImages[i]->isTextureBacked()) {
+            tasks->add([this, i, procs] {
+                fEncodedImages[i] = encode_image(const_cast<SkImage*>(fImages[i].get()), procs);
+            });
+        }
+    }
+    fPreparedPictures.reset(fPictures.count());
+    for (int i = 0; i < fPictures.count(); ++i) {
+        tasks->add([this, i, procs, tasks] {
+            fPictures[i]->prepareSerialize(procs, &fPreparedPictures[i], tasks);
+        });
+    }
+}
+
+// Answers writeImage() with the images prepareSerialize() encoded, and asks the original proc
+// about any others, like those in shaders.
+struct EncodedImages {
+    SkTHashMap<uint32_t, sk_sp<SkData>> fEncoded;
+    SkSerialImageProc                   fProc;
+    void*                               fCtx;
+
+    static sk_sp<SkData> Proc(SkImage* image, void* ctx) {
+        auto images = static_cast<EncodedImages*>(ctx);
+        if (sk_sp<SkData>* data = images->fEncoded.find(image->uniqueID())) {
+            return *data;
+        }
+        return images->fProc ? images->fProc(image, images->fCtx) : nullptr;
+    }
+};
+
 // topLevelTypeFaceSet is null only on the top level call.
 // This method is called recursively on every subpicture in two passes.
 // textBlobsOnly serves to indicate that we are on the first pass and skip as much work as
@@ -207,9 +294,13 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 // TODO(nifong): dedupe typefaces and all other shared resources in a faster and more readable way.
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet, bool textBlobsOnly) const {
-    // This can happen at pretty much any time, so might as well do it first.
-    write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
-    stream->write(fOpData->bytes(), fOpData->size());
+    // This can happen at pretty much any time, so might as well do it first. With an op index
+    // it goes after the buffer instead, so that both can be read in place; see writeOpIndex().
+    const bool indexed = !fOpRanges.empty() && !textBlobsOnly;
+    if (!indexed) {
+        write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
+        stream->write(fOpData->bytes(), fOpData->size());
+    }
 
     // We serialize all typefaces into the typeface section of the top-level picture.
     SkRefCntSet localTypefaceSet;
@@ -220,9 +311,24 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     SkFactorySet factSet;  // buffer refs factSet, so factSet must come first.
     SkBinaryWriteBuffer buffer;
     buffer.setFactoryRecorder(sk_ref_sp(&factSet));
-    buffer.setSerialProcs(skip_typeface_proc(procs));
+    SkSerialProcs bufferProcs = skip_typeface_proc(procs);
+    EncodedImages encodedImages;
+    if (!fEncodedImages.empty() && !textBlobsOnly) {
+        for (int i = 0; i < fImages.count(); ++i) {
+            if (fEncodedImages[i]) {
+                encodedImages.fEncoded.set(fImages[i]->uniqueID(), fEncodedImages[i]);
+            }
+        }
+        encodedImages.fProc = bufferProcs.fImageProc;
+        encodedImages.fCtx = bufferProcs.fImageCtx;
+        bufferProcs.fImageProc = EncodedImages::Proc;
+        bufferProcs.fImageCtx = &encodedImages;
+    }
+    buffer.setSerialProcs(bufferProcs);
     buffer.setTypefaceRecorder(sk_ref_sp(typefaceSet));
-    this->flattenToBuffer(buffer, textBlobsOnly);
+    ObjectOffsets offsets;
+    offsets.fBuffer = &buffer;
+    this->flattenToBuffer(buffer, textBlobsOnly, indexed ? &offsets : nullptr);
 
     // Dummy serialize our sub-pictures for the side effect of filling typefaceSet
     // with typefaces from sub-pictures.
@@ -232,8 +338,12 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
         bool write(const void*, size_t size) override { fBytesWritten += size; return true; }
         size_t bytesWritten() const override { return fBytesWritten; }
     } devnull;
-    for (const auto& pic : fPictures) {
-        pic->serialize(&devnull, nullptr, typefaceSet, /*textBlobsOnly=*/ true);
+    auto prepared = [this](int i) {
+        return fPreparedPictures.empty() ? nullptr : &fPreparedPictures[i];
+    };
+    for (int i = 0; i < fPictures.count(); ++i) {
+        fPictures[i]->serialize(&devnull, nullptr, typefaceSet, /*textBlobsOnly=*/ true,
+                                prepared(i));
     }
     if (textBlobsOnly) { return; } // return early from dummy serialize
 
@@ -245,15 +355,25 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     // paints would just write indices into our typeface set.
     WriteTypefaces(stream, *typefaceSet, procs);
 
+    if (indexed) {
+        this->writeOpIndex(stream, offsets);
+    }
+
     // Write the buffer.
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
+    if (indexed) {
+        write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
+        stream->write(fOpData->bytes(), fOpData->size());
+    }
+
     // Write sub-pictures by calling serialize again.
     if (!fPictures.empty()) {
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictures.count());
-        for (const auto& pic : fPictures) {
-            pic->serialize(stream, &procs, typefaceSet, /*textBlobsOnly=*/ false);
+        for (int i = 0; i < fPictures.count(); ++i) {
+            fPictures[i]->serialize(stream, &procs, typefaceSet, /*textBlobsOnly=*/ false,
+                                    prepared(i));
         }
     }
 
@@ -285,19 +405,49 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Returns the next size bytes of stream, which reads from source. They are referenced rather than
+// copied unless they are not aligned well enough for SkReadBuffer.
+static sk_sp<SkData> read_chunk_in_place(SkStream* stream, const SkData* source, size_t size) {
+    const size_t offset = stream->getPosition();
+    if (stream->skip(size) != size || offset + size > source->size()) {
+        return nullptr;
+    }
+    if (!SkIsAlign4(reinterpret_cast<uintptr_t>(source->bytes() + offset))) {
+        return SkData::MakeWithCopy(source->bytes() + offset, size);
+    }
+    return SkData::MakeSubset(source, offset, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* lazySource) {
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            fOpData = lazySource ? read_chunk_in_place(stream, lazySource, size)
+                                 : SkData::MakeFromStream(stream, size);
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_OP_INDEX_TAG: {
+            // The index is only of use when reading lazily.
+            if (!lazySource) {
+                return stream->skip(size) == size;
+            }
+            SkAutoMalloc storage(size);
+            if (stream->read(storage.get(), size) != size) {
+                return false;
+            }
+            // Ignore the padding at the end.
+            SkReadBuffer buffer(storage.get(), size & ~3);
+            if (!this->parseOpIndex(buffer)) {
+                return false;
+            }
+        } break;
         case SK_PICT_FACTORY_TAG: {
             if (!stream->readU32(&size)) { return false; }
             fFactoryPlayback = skstd::make_unique<SkFactoryPlayback>(size);
@@ -329,7 +479,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback,
+                                                     lazySource);
                 if (!pic) {
                     return false;
                 }
@@ -337,13 +488,30 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            sk_sp<SkData> chunk;
+            if (lazySource) {
+                chunk = read_chunk_in_place(stream, lazySource, size);
+                if (!chunk) {
+                    return false;
+                }
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+            }
+
+            // With an op index, its paths and images are skipped now and decoded from the chunk
+            // when they are first used.
+            if (!fOpRanges.empty()) {
+                fLazyBuffer = chunk;
+                fLazyProcs = procs;
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(chunk ? chunk->data() : storage.get(), size);
             buffer.setVersion(fInfo.getVersion());
+            buffer.setBackingData(chunk);
 
             if (!fFactoryPlayback) {
                 return false;
@@ -372,9 +540,6 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     return true;    // success
 }
 
-static sk_sp<SkImage> create_image_from_buffer(SkReadBuffer& buffer) {
-    return buffer.readImage();
-}
 static sk_sp<SkVertices> create_vertices_from_buffer(SkReadBuffer& buffer) {
     auto data = buffer.readByteArrayAsData();
     return data ? SkVertices::Decode(data->data(), data->size()) : nullptr;
@@ -409,6 +574,20 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
+// Checks that offsets, from the op index, hold where each of count objects starting here in buffer
+// begins and then where the last one ends, and skips over them.
+static bool skip_lazy_objects(SkReadBuffer& buffer, int count, const SkTDArray<uint32_t>& offsets) {
+    if (!buffer.validate(offsets.count() - 1 == count && offsets[0] == buffer.offset())) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (!buffer.validate(SkIsAlign4(offsets[i + 1]) && offsets[i] < offsets[i + 1])) {
+            return false;
+        }
+    }
+    return buffer.skip(offsets[count] - offsets[0]) != nullptr;
+}
+
 void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
     switch (tag) {
         case SK_PICT_PAINT_BUFFER_TAG: {
@@ -430,6 +609,13 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
                 if (!buffer.validate(count >= 0)) {
                     return;
                 }
+                if (fLazyBuffer) {
+                    if (skip_lazy_objects(buffer, count, fPathOffsets)) {
+                        fPaths.reset(count);
+                        fPathOnce.reset(new SkOnce[count]);
+                    }
+                    return;
+                }
                 for (int i = 0; i < count; i++) {
                     buffer.readPath(&fPaths.push_back());
                     if (!buffer.isValid()) {
@@ -444,7 +630,25 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             new_array_from_buffer(buffer, size, fVertices, create_vertices_from_buffer);
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            new_array_from_buffer(buffer, size, fImages, create_image_from_buffer);
+            if (fLazyBuffer) {
+                if (buffer.validate(fImages.empty() && SkTFitsIn<int>(size)) &&
+                    skip_lazy_objects(buffer, SkToInt(size), fImageOffsets)) {
+                    fImages.reset(SkToInt(size));
+                    fImageOnce.reset(new SkOnce[size]);
+                }
+                break;
+            }
+            // Each image takes at least a word, so this bounds the allocation.
+            if (buffer.validate(fImages.empty() && SkTFitsIn<int>(size)) &&
+                buffer.validateCanReadN<uint32_t>(size)) {
+                SkAutoTArray<sk_sp<SkImage>> images(SkToInt(size));
+                if (buffer.readImages(images.get(), SkToInt(size))) {
+                    fImages.reset(SkToInt(size));
+                    for (int i = 0; i < fImages.count(); ++i) {
+                        fImages[i] = std::move(images[i]);
+                    }
+                }
+            }
             break;
         case SK_PICT_READER_TAG: {
             // Preflight check that we can initialize all data from the buffer
@@ -472,16 +676,80 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
     }
 }
 
+template <typename T>
+static bool read_array(SkReadBuffer& buffer, SkTDArray<T>* array) {
+    const uint32_t count = buffer.readUInt();
+    if (!buffer.validateCanReadN<T>(count)) {
+        return false;
+    }
+    array->setCount(SkToInt(count));
+    return 0 == count || buffer.readPad32(array->begin(), count * sizeof(T));
+}
+
+bool SkPictureData::parseOpIndex(SkReadBuffer& buffer) {
+    return buffer.validate(fOpRanges.empty()) &&
+           read_array(buffer, &fOpRanges) &&
+           read_array(buffer, &fPathOffsets) &&
+           read_array(buffer, &fImageOffsets);
+}
+
+// The ranges can only be checked against the ops once they have been read.
+bool SkPictureData::finishOpIndex() {
+    if (fOpRanges.empty()) {
+        return true;
+    }
+    if (!fOpData) {
+        return false;
+    }
+    SkAutoTMalloc<SkRect> bounds(fOpRanges.count());
+    uint32_t end = 0;
+    for (int i = 0; i < fOpRanges.count(); ++i) {
+        const SkPictureOpRange& range = fOpRanges[i];
+        if (range.fStart < end || range.fEnd <= range.fStart || range.fEnd > fOpData->size() ||
+            !SkIsAlign4(range.fStart) || !SkIsAlign4(range.fEnd) || !range.fBounds.isFinite()) {
+            return false;
+        }
+        end = range.fEnd;
+        bounds[i] = range.fBounds;
+    }
+    fOpBBH = sk_make_sp<SkRTree>();
+    fOpBBH->insert(bounds.get(), fOpRanges.count());
+    return true;
+}
+
+void SkPictureData::decodeLazyPath(int index) const {
+    fPathOnce[index]([&] {
+        SkReadBuffer buffer(fLazyBuffer->bytes() + fPathOffsets[index],
+                            fPathOffsets[index + 1] - fPathOffsets[index]);
+        buffer.setVersion(fInfo.getVersion());
+        buffer.setBackingData(fLazyBuffer);
+        buffer.readPath(&fPaths[index]);
+        fPaths[index].updateBoundsCache();
+    });
+}
+
+void SkPictureData::decodeLazyImage(int index) const {
+    fImageOnce[index]([&] {
+        SkReadBuffer buffer(fLazyBuffer->bytes() + fImageOffsets[index],
+                            fImageOffsets[index + 1] - fImageOffsets[index]);
+        buffer.setVersion(fInfo.getVersion());
+        buffer.setDeserialProcs(fLazyProcs);
+        fImages[index] = buffer.readImage();
+    });
+}
+
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* lazySource) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, procs, topLevelTFPlayback, lazySource) ||
+        !data->finishOpIndex()) {
         return nullptr;
     }
     return data.release();
@@ -500,7 +768,8 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 const SkDeserialProcs& procs,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* lazySource) {
     for (;;) {
         uint32_t tag;
         if (!stream->readU32(&tag)) { return false; }
@@ -510,7 +779,7 @@ bool SkPictureData::parseStream(SkStream* stream,
 
         uint32_t size;
         if (!stream->readU32(&size)) { return false; }
-        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, procs, topLevelTFPlayback, lazySource)) {
             return false; // we're invalid
         }
     }
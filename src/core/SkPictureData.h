@@ -11,7 +11,10 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkDrawable.h"
 #include "include/core/SkPicture.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTArray.h"
+#include "include/private/SkTDArray.h"
+#include "src/core/SkBBoxHierarchy.h"
 #include "src/core/SkPictureFlat.h"
 
 #include <memory>
@@ -22,11 +25,12 @@ class SkReader32;
 struct SkSerialProcs;
 class SkStream;
 class SkWStream;
-class SkBBoxHierarchy;
 class SkMatrix;
 class SkPaint;
 class SkPath;
+class SkPictureData;
 class SkReadBuffer;
+class SkTaskGroup;
 class SkTextBlob;
 
 struct SkPictInfo {
@@ -55,6 +59,7 @@ public:
 #define SK_PICT_TYPEFACE_TAG   SkSetFourByteTag('t', 'p', 'f', 'c')
 #define SK_PICT_PICTURE_TAG    SkSetFourByteTag('p', 'c', 't', 'r')
 #define SK_PICT_DRAWABLE_TAG   SkSetFourByteTag('d', 'r', 'a', 'w')
+#define SK_PICT_OP_INDEX_TAG   SkSetFourByteTag('o', 'p', 'i', 'x')
 
 // This tag specifies the size of the ReadBuffer, needed for the following tags
 #define SK_PICT_BUFFER_SIZE_TAG     SkSetFourByteTag('a', 'r', 'a', 'y')
@@ -68,6 +73,24 @@ public:
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
+// The ops of the op stream that one op of an SkRecord was written as, and its bounds in picture
+// coordinates, as SkRecordFillBounds() computes them. The SK_PICT_OP_INDEX_TAG holds one for each
+// SkRecord op that wrote anything, in order.
+struct SkPictureOpRange {
+    uint32_t fStart;
+    uint32_t fEnd;
+    SkRect   fBounds;
+};
+
+// The parts of serializing a sub-picture that do not depend on what was written before it, which
+// SkPictureData::prepareSerialize() does up front: what SkSerialProcs::fPictureProc returned for
+// it, if anything, and the picture backported, with its images encoded and its own sub-pictures
+// prepared. The backported data is still used to collect typefaces when fCustom is set.
+struct SkPreparedPicture {
+    sk_sp<SkData>                  fCustom;
+    std::unique_ptr<SkPictureData> fData;
+};
+
 template <typename T>
 T* read_index_base_1_or_null(SkReadBuffer* reader, const SkTArray<sk_sp<T>>& array) {
     int index = reader->readInt();
@@ -78,35 +101,62 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If lazySource is not null, stream must be reading from it. Then chunks are referenced
+    // rather than copied, and if the picture has an op index, its paths and images are only
+    // decoded when first used.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkData* lazySource = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*, bool textBlobsOnly=false) const;
+    // Encodes this picture's images and prepares its sub-pictures for serialize(), adding the
+    // work to tasks. Nothing may use this until tasks is done.
+    void prepareSerialize(const SkSerialProcs&, SkTaskGroup* tasks);
     void flatten(SkWriteBuffer&) const;
 
     const sk_sp<SkData>& opData() const { return fOpData; }
 
+    const SkRect& cullRect() const { return fInfo.fCullRect; }
+
+    // Set by SkPicture::backport() when asked to index the ops, or read back lazily.
+    void setOpIndex(SkTDArray<SkPictureOpRange>);
+    const SkTDArray<SkPictureOpRange>& opRanges() const { return fOpRanges; }
+    // Indexes opRanges() by their bounds; null unless read lazily.
+    const SkBBoxHierarchy* opBBH() const { return fOpBBH.get(); }
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*);
+    bool parseStream(SkStream*, const SkDeserialProcs&, SkTypefacePlayback*,
+                     const SkData* lazySource);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
     const SkImage* getImage(SkReadBuffer* reader) const {
         // images are written base-0, unlike paths, pictures, drawables, etc.
         const int index = reader->readInt();
-        return reader->validateIndex(index, fImages.count()) ? fImages[index].get() : nullptr;
+        if (!reader->validateIndex(index, fImages.count())) {
+            return nullptr;
+        }
+        if (fLazyBuffer) {
+            this->decodeLazyImage(index);
+        }
+        return fImages[index].get();
     }
 
     const SkPath& getPath(SkReadBuffer* reader) const {
         int index = reader->readInt();
-        return reader->validate(index > 0 && index <= fPaths.count()) ?
-                fPaths[index - 1] : fEmptyPath;
+        if (!reader->validate(index > 0 && index <= fPaths.count())) {
+            return fEmptyPath;
+        }
+        if (fLazyBuffer) {
+            this->decodeLazyPath(index - 1);
+        }
+        return fPaths[index - 1];
     }
 
     const SkPicture* getPicture(SkReadBuffer* reader) const {
@@ -138,12 +188,31 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        const SkDeserialProcs&, SkTypefacePlayback*);
+                        const SkDeserialProcs&, SkTypefacePlayback*, const SkData* lazySource);
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
-    void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly) const;
+    // Where each path and image starts in fBuffer, followed by where the last one ends.
+    struct ObjectOffsets {
+        const SkBinaryWriteBuffer* fBuffer;
+        SkTDArray<uint32_t>        fPaths;
+        SkTDArray<uint32_t>        fImages;
+
+        void mark(SkTDArray<uint32_t>* offsets) const {
+            offsets->push_back(SkToU32(fBuffer->bytesWritten()));
+        }
+    };
+    // If offsets is not null, it must be for the same buffer.
+    void flattenToBuffer(SkWriteBuffer&, bool textBlobsOnly, ObjectOffsets* offsets = nullptr) const;
+
+    void writeOpIndex(SkWStream*, const ObjectOffsets&) const;
+    bool parseOpIndex(SkReadBuffer&);
+    bool finishOpIndex();
+
+    void decodeLazyPath(int index) const;
+    void decodeLazyImage(int index) const;
 
     SkTArray<SkPaint>  fPaints;
-    SkTArray<SkPath>   fPaths;
+    // When read lazily, each path and image is decoded from fLazyBuffer the first time it is used.
+    mutable SkTArray<SkPath> fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
 
@@ -154,7 +223,22 @@ private:
     SkTArray<sk_sp<SkDrawable>>        fDrawables;
     SkTArray<sk_sp<const SkTextBlob>>  fTextBlobs;
     SkTArray<sk_sp<const SkVertices>>  fVertices;
-    SkTArray<sk_sp<const SkImage>>     fImages;
+    mutable SkTArray<sk_sp<const SkImage>> fImages;
+
+    // Filled by prepareSerialize(), one for each of fImages and fPictures; an image left null is
+    // encoded when it is written, as it would be without preparing.
+    SkTArray<sk_sp<SkData>>            fEncodedImages;
+    SkTArray<SkPreparedPicture>        fPreparedPictures;
+
+    SkTDArray<SkPictureOpRange>        fOpRanges;
+    sk_sp<SkBBoxHierarchy>             fOpBBH;
+
+    sk_sp<SkData>                      fLazyBuffer;   // the SK_PICT_BUFFER_SIZE_TAG chunk
+    SkDeserialProcs                    fLazyProcs;
+    SkTDArray<uint32_t>                fPathOffsets;  // into fLazyBuffer, one more than fPaths
+    SkTDArray<uint32_t>                fImageOffsets; // into fLazyBuffer, one more than fImages
+    std::unique_ptr<SkOnce[]>          fPathOnce;
+    std::unique_ptr<SkOnce[]>          fImageOnce;
 
     SkTypefacePlayback                 fTFPlayback;
     std::unique_ptr<SkFactoryPlayback> fFactoryPlayback;
@@ -82,19 +82,54 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
 
     SkAutoCanvasRestore acr(canvas, false);
 
-    while (!reader.eof()) {
-        if (callback && callback->abort()) {
-            return;
-        }
+    // Plays the ops up to stop, returning false if playback should end here.
+    auto playOps = [&](size_t stop) {
+        while (reader.offset() < stop && !reader.eof()) {
+            if (callback && callback->abort()) {
+                return false;
+            }
 
-        fCurOffset = reader.offset();
-        uint32_t size;
-        DrawType op = ReadOpAndSize(&reader, &size);
-        if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
-            return;
+            fCurOffset = reader.offset();
+            uint32_t size;
+            DrawType op = ReadOpAndSize(&reader, &size);
+            if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM)) {
+                return false;
+            }
+
+            this->handleOp(&reader, op, size, canvas, initialMatrix);
+        }
+        return true;
+    };
+
+    // With an op index, draw only the ops that affect pixels in the canvas's current clip, like
+    // SkRecordDraw() does with a bbh. Ops that are skipped are never read, so neither are the
+    // paths and images they use.
+    const SkBBoxHierarchy* bbh = fPictureData->opBBH();
+    SkRect query;
+    if (bbh) {
+        query = canvas->getLocalClipBounds();
+        // If the query contains the whole picture, don't bother with the index.
+        if (query.contains(fPictureData->cullRect())) {
+            bbh = nullptr;
         }
+    }
+    if (bbh) {
+        SkTDArray<int> ops;
+        bbh->search(query, &ops);
 
-        this->handleOp(&reader, op, size, canvas, initialMatrix);
+        const SkTDArray<SkPictureOpRange>& ranges = fPictureData->opRanges();
+        for (int i : ops) {
+            // A clip that empties the canvas skips ahead to its restore, which may be past the
+            // start of this range, or all of it.
+            if (reader.offset() < ranges[i].fStart) {
+                reader.skip(ranges[i].fStart - reader.offset());
+            }
+            if (!playOps(ranges[i].fEnd)) {
+                return;
+            }
+        }
+    } else if (!playOps(fPictureData->opData()->size())) {
+        return;
     }
 
     // need to propagate invalid state to the parent reader
@@ -15,6 +15,7 @@
 #include "src/core/SkClipOpPriv.h"
 #include "src/core/SkDrawShadowInfo.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkTSearch.h"
 #include "src/image/SkImage_Base.h"
 #include "src/utils/SkPatchUtils.h"
@@ -832,10 +833,36 @@ void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
     fWriter.writeMatrix(matrix);
 }
 
+uint32_t SkPictureRecord::PaintHash::operator()(const SkPaint& paint) const {
+    const void* effects[] = {
+        paint.getShader(), paint.getColorFilter(), paint.getMaskFilter(),
+        paint.getPathEffect(), paint.getImageFilter(),
+    };
+    const SkColor4f color = paint.getColor4f();
+    const SkScalar scalars[] = {
+        color.fR, color.fG, color.fB, color.fA, paint.getStrokeWidth(), paint.getStrokeMiter(),
+    };
+    const uint32_t bits =
+        (uint32_t)paint.getBlendMode()      << 0 |
+        (uint32_t)paint.getStyle()          << 8 |
+        (uint32_t)paint.getStrokeCap()      << 10 |
+        (uint32_t)paint.getStrokeJoin()     << 12 |
+        (uint32_t)paint.getFilterQuality()  << 14 |
+        (uint32_t)paint.isAntiAlias()       << 16 |
+        (uint32_t)paint.isDither()          << 17;
+    uint32_t hash = SkOpts::hash(effects, sizeof(effects));
+    hash = SkOpts::hash(scalars, sizeof(scalars), hash);
+    return SkOpts::hash(&bits, sizeof(bits), hash);
+}
+
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
     if (paint) {
-        fPaints.push_back(*paint);
-        this->addInt(fPaints.count());
+        int* index = fPaintIndices.find(*paint);
+        if (!index) {
+            fPaints.push_back(*paint);
+            index = fPaintIndices.set(*paint, fPaints.count());
+        }
+        this->addInt(*index);
     } else {
         this->addInt(0);
     }
@@ -243,7 +243,12 @@ protected:
     }
 
 private:
+    // Each distinct paint is written once, and ops refer to it by index.
+    struct PaintHash {
+        uint32_t operator()(const SkPaint&) const;
+    };
     SkTArray<SkPaint>  fPaints;
+    SkTHashMap<SkPaint, int, PaintHash> fPaintIndices;
 
     struct PathHash {
         uint32_t operator()(const SkPath& p) { return p.getGenerationID(); }
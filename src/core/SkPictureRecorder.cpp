@@ -45,6 +45,7 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& userCullRect,
         ? SkRecorder::Playback_DrawPictureMode
         : SkRecorder::Record_DrawPictureMode;
     fRecorder->reset(fRecord.get(), cullRect, dpm, fMiniRecorder.get());
+    fRecorder->setInternPaths(recordFlags & kInternPaths_RecordFlag);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
@@ -56,6 +57,7 @@ SkCanvas* SkPictureRecorder::getRecordingCanvas() {
 sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlags) {
     fActivelyRecording = false;
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->setInternPaths(false);  // Let go of the interned paths.
 
     if (fRecord->count() == 0) {
         auto pic = fMiniRecorder->detachAsPicture(fBBH ? nullptr : &fCullRect);
@@ -117,6 +119,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFl
     fActivelyRecording = false;
     fRecorder->flushMiniRecorder();
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+    fRecorder->setInternPaths(false);  // Let go of the interned paths.
 
     SkRecordOptimize(fRecord.get());
 
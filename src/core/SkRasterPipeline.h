@@ -101,6 +101,7 @@
     M(rgb_to_hsl) M(hsl_to_rgb)                                    \
     M(gauss_a_to_rgba)                                             \
     M(emboss)                                                      \
+    M(perlin_noise)                                                \
     M(swizzle)
 
 // The largest number of pixels we handle at a time.
@@ -195,6 +196,20 @@ struct SkRasterPipeline_EmbossCtx {
                                add;
 };
 
+// Fractal noise or turbulence, as drawn by SkPerlinNoiseShader.  The tables are laid out for gathers.
+struct SkRasterPipeline_PerlinNoiseCtx {
+    const uint32_t* latticeSelector;    // 256 entries
+    const float*    gradientX[4];       // 256 entries for each of r,g,b,a
+    const float*    gradientY[4];
+    const float*    stitching;          // width, wrapX, height, wrapY for each octave, or null
+    float           baseFrequencyX,
+                    baseFrequencyY;
+    float           offsetX,            // from device pixels to noise space
+                    offsetY;
+    int             octaves;
+    bool            fractalNoise;       // otherwise turbulence
+};
+
 
 
 class SkRasterPipeline {
@@ -15,8 +15,10 @@
 #include "src/core/SkMakeUnique.h"
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSafeMath.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifndef SK_DISABLE_READBUFFER
 
@@ -95,6 +97,12 @@ void SkReadBuffer::setDeserialProcs(const SkDeserialProcs& procs) {
     fProcs = procs;
 }
 
+void SkReadBuffer::setBackingData(sk_sp<SkData> data) {
+    SkASSERT(!data || (fReader.base() >= data->data() &&
+                       fReader.peek() <= data->bytes() + data->size()));
+    fBackingData = std::move(data);
+}
+
 bool SkReadBuffer::readBool() {
     uint32_t value = this->readUInt();
     // Boolean value should be either 0 or 1
@@ -222,7 +230,13 @@ void SkReadBuffer::readRegion(SkRegion* region) {
 void SkReadBuffer::readPath(SkPath* path) {
     size_t size = 0;
     if (!fError) {
-        size = path->readFromMemory(fReader.peek(), fReader.available());
+        if (fBackingData) {
+            size_t offset = static_cast<const char*>(fReader.peek()) -
+                            static_cast<const char*>(fBackingData->data());
+            size = SkPathPriv::ReadFromData(path, fBackingData, offset);
+        } else {
+            size = path->readFromMemory(fReader.peek(), fReader.available());
+        }
         if (!this->validate((SkAlign4(size) == size) && (0 != size))) {
             path->reset();
         }
@@ -286,61 +300,67 @@ uint32_t SkReadBuffer::getArrayCount() {
  *  size (31bits)
  *  data [ encoded, with raw width/height ]
  */
-sk_sp<SkImage> SkReadBuffer::readImage() {
-    SkIRect bounds;
+bool SkReadBuffer::readEncodedImage(SkIRect* bounds, sk_sp<SkData>* data) {
     if (this->isVersionLT(SkPicturePriv::kStoreImageBounds_Version)) {
-        bounds.fLeft = bounds.fTop = 0;
-        bounds.fRight = this->read32();
-        bounds.fBottom = this->read32();
+        bounds->fLeft = bounds->fTop = 0;
+        bounds->fRight = this->read32();
+        bounds->fBottom = this->read32();
     } else {
-        this->readIRect(&bounds);
+        this->readIRect(bounds);
     }
-    const int width = bounds.width();
-    const int height = bounds.height();
-    if (width <= 0 || height <= 0) {    // SkImage never has a zero dimension
-        this->validate(false);
-        return nullptr;
+    if (bounds->width() <= 0 || bounds->height() <= 0) {    // SkImage never has a zero dimension
+        return this->validate(false);
     }
 
     int32_t size = this->read32();
     if (size == SK_NaN32) {
         // 0x80000000 is never valid, since it cannot be passed to abs().
-        this->validate(false);
-        return nullptr;
+        return this->validate(false);
     }
     if (size == 0) {
-        // The image could not be encoded at serialization time - return an empty placeholder.
-        return MakeEmptyImage(width, height);
+        // The image could not be encoded at serialization time.
+        data->reset();
+        return true;
     }
 
     // we used to negate the size for "custom" encoded images -- ignore that signal (Dec-2017)
     size = SkAbs32(size);
     if (size == 1) {
         // legacy check (we stopped writing this for "raw" images Nov-2017)
-        this->validate(false);
-        return nullptr;
+        return this->validate(false);
     }
 
     // Preflight check to make sure there's enough stuff in the buffer before
     // we allocate the memory. This helps the fuzzer avoid OOM when it creates
     // bad/corrupt input.
     if (!this->validateCanReadN<uint8_t>(size)) {
-        return nullptr;
+        return false;
     }
 
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
-        this->validate(false);
-        return nullptr;
+    *data = SkData::MakeUninitialized(size);
+    if (!this->readPad32((*data)->writable_data(), size)) {
+        return this->validate(false);
     }
     if (this->isVersionLT(SkPicturePriv::kDontNegateImageSize_Version)) {
         (void)this->read32();   // originX
         (void)this->read32();   // originY
     }
+    return true;
+}
+
+// The part of readImage() that decodes, which touches nothing but its arguments.
+static sk_sp<SkImage> make_image(const SkIRect& bounds, sk_sp<SkData> data,
+                                 const SkDeserialProcs& procs) {
+    const int width = bounds.width();
+    const int height = bounds.height();
+    if (!data) {
+        // The image could not be encoded at serialization time - return an empty placeholder.
+        return MakeEmptyImage(width, height);
+    }
 
     sk_sp<SkImage> image;
-    if (fProcs.fImageProc) {
-        image = fProcs.fImageProc(data->data(), data->size(), fProcs.fImageCtx);
+    if (procs.fImageProc) {
+        image = procs.fImageProc(data->data(), data->size(), procs.fImageCtx);
     }
     if (!image) {
         image = SkImage::MakeFromEncoded(std::move(data));
@@ -355,6 +375,41 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
     return image ? image : MakeEmptyImage(width, height);
 }
 
+sk_sp<SkImage> SkReadBuffer::readImage() {
+    SkIRect bounds;
+    sk_sp<SkData> data;
+    if (!this->readEncodedImage(&bounds, &data)) {
+        return nullptr;
+    }
+    return make_image(bounds, std::move(data), fProcs);
+}
+
+bool SkReadBuffer::readImages(sk_sp<SkImage> images[], int count) {
+    if (!fProcs.fExecutor || count < 2) {
+        for (int i = 0; i < count; ++i) {
+            if (!(images[i] = this->readImage())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reading is sequential and cheap; decoding (or whatever fImageProc does) is neither.
+    SkAutoTArray<SkIRect> bounds(count);
+    SkAutoTArray<sk_sp<SkData>> data(count);
+    for (int i = 0; i < count; ++i) {
+        if (!this->readEncodedImage(&bounds[i], &data[i])) {
+            return false;
+        }
+    }
+    SkTaskGroup tasks(*fProcs.fExecutor);
+    tasks.batch(count, [&](int i) {
+        images[i] = make_image(bounds[i], std::move(data[i]), fProcs);
+    });
+    tasks.wait();
+    return true;
+}
+
 sk_sp<SkTypeface> SkReadBuffer::readTypeface() {
     // Read 32 bits (signed)
     //   0 -- return null (default font)
@@ -9,6 +9,7 @@
 #define SkReadBuffer_DEFINED
 
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
 #include "include/core/SkDrawLooper.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkImageFilter.h"
@@ -24,7 +25,6 @@
 #include "src/core/SkWriteBuffer.h"
 #include "src/shaders/SkShaderBase.h"
 
-class SkData;
 class SkImage;
 
 #ifndef SK_DISABLE_READBUFFER
@@ -133,6 +133,9 @@ public:
     // be created (e.g. it was not originally encoded) then this returns an image that doesn't
     // draw.
     sk_sp<SkImage> readImage();
+    // Reads count images as readImage() does, decoding them concurrently if the SkDeserialProcs
+    // have an executor. Returns false on a real error.
+    bool readImages(sk_sp<SkImage> images[], int count);
     sk_sp<SkTypeface> readTypeface();
 
     void setTypefaceArray(sk_sp<SkTypeface> array[], int count) {
@@ -152,6 +155,12 @@ public:
     void setDeserialProcs(const SkDeserialProcs& procs);
     const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
 
+    /**
+     *  Call this if the buffer's memory lies inside data. Paths read from the buffer may then
+     *  reference their points and verbs in data, keeping it alive, instead of copying them.
+     */
+    void setBackingData(sk_sp<SkData> data);
+
     /**
      *  If isValid is false, sets the buffer to be "invalid". Returns true if the buffer
      *  is still valid.
@@ -193,6 +202,9 @@ public:
 
 private:
     const char* readString(size_t* length);
+    // The part of readImage() that reads the buffer, leaving the decoding for later. data is
+    // left null if the image was not encoded.
+    bool readEncodedImage(SkIRect* bounds, sk_sp<SkData>* data);
 
     void setInvalid();
     bool readArray(void* value, size_t size, size_t elementSize);
@@ -213,6 +225,8 @@ private:
 
     SkDeserialProcs fProcs;
 
+    sk_sp<SkData> fBackingData;
+
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
     }
@@ -294,6 +308,7 @@ public:
     uint32_t getArrayCount() { return 0; }
 
     sk_sp<SkImage>    readImage()    { return nullptr; }
+    bool readImages(sk_sp<SkImage>[], int) { return false; }
     sk_sp<SkTypeface> readTypeface() { return nullptr; }
 
     bool validate(bool)                                 { return false; }
@@ -309,6 +324,7 @@ public:
     void setTypefaceArray(sk_sp<SkTypeface>[], int)        {}
     void setFactoryPlayback(SkFlattenable::Factory[], int) {}
     void setDeserialProcs(const SkDeserialProcs&)          {}
+    void setBackingData(sk_sp<SkData>)                     {}
 
     const SkDeserialProcs& getDeserialProcs() const {
         static const SkDeserialProcs procs;
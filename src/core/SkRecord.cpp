@@ -34,4 +34,10 @@ void SkRecord::defrag() {
     Record* noops = std::remove_if(fRecords.get(), fRecords.get() + fCount,
                                    [](Record op) { return op.type() == SkRecords::NoOp_Type; });
     fCount = noops - fRecords.get();
+
+    // This is usually the last change to a record, so give back the room it had to grow.
+    if (fCount < fReserved) {
+        fReserved = fCount;
+        fRecords.realloc(fReserved);
+    }
 }
@@ -13,6 +13,8 @@
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkRecords.h"
 
+#include <type_traits>
+
 // SkRecord represents a sequence of SkCanvas calls, saved for future use.
 // These future uses may include: replay, optimization, serialization, or combinations of those.
 //
@@ -53,6 +55,7 @@ public:
 
     // Allocate contiguous space for count Ts, to be freed when the SkRecord is destroyed.
     // Here T can be any class, not just those from SkRecords.  Throws on failure.
+    // This space is kept apart from the commands themselves, so use it for their larger payloads.
     template <typename T>
     T* alloc(size_t count = 1) {
         struct RawBytes {
@@ -69,7 +72,7 @@ public:
         if (fCount == fReserved) {
             this->grow();
         }
-        return fRecords[fCount++].set(this->allocCommand<T>());
+        return this->allocCommand<T>(&fRecords[fCount++]);
     }
 
     // Replace the i-th command with a new command of type T.
@@ -82,7 +85,7 @@ public:
         Destroyer destroyer;
         this->mutate(i, destroyer);
 
-        return fRecords[i].set(this->allocCommand<T>());
+        return this->allocCommand<T>(&fRecords[i]);
     }
 
     // Replace the i-th command with a new command of type T.
@@ -90,12 +93,13 @@ public:
     // You must show proof that you've already adopted the existing command.
     template <typename T, typename Existing>
     T* replace(int i, const SkRecords::Adopted<Existing>& proofOfAdoption) {
+        static_assert(!IsInline<Existing>::value, "Inline commands are overwritten in place.");
         SkASSERT(i < this->count());
 
         SkASSERT(Existing::kType == fRecords[i].type());
         SkASSERT(proofOfAdoption == fRecords[i].ptr());
 
-        return fRecords[i].set(this->allocCommand<T>());
+        return this->allocCommand<T>(&fRecords[i]);
     }
 
     // Does not return the bytes in any pointers embedded in the Records; callers
@@ -104,23 +108,28 @@ public:
 
     // Rearrange and resize this record to eliminate any NoOps.
     // May change count() and the indices of ops, but preserves their order.
+    // Also invalidates references to commands small enough to be stored inline.
     void defrag();
 
 private:
     // An SkRecord is structured as an array of pointers into a big chunk of memory where
-    // records representing each canvas draw call are stored:
+    // records representing each canvas draw call are stored, one after another in the order
+    // they're appended.  Commands that fit in a pointer are stored in place of it instead:
+    //
+    // fRecords:  [*][*][Translate][*]...
+    //             |  |             |
+    //             |  |             |
+    //             |  |             +--------------------------------+
+    //             |  +-----------------+                            |
+    //             |                    |                            |
+    //             v                    v                            v
+    //   fOps:    [SkRecords::DrawRect][SkRecords::DrawPoints][SkRecords::DrawRect]...
     //
-    // fRecords:  [*][*][*]...
-    //             |  |  |
-    //             |  |  |
-    //             |  |  +---------------------------------------+
-    //             |  +-----------------+                        |
-    //             |                    |                        |
-    //             v                    v                        v
-    //   fAlloc:  [SkRecords::DrawRect][SkRecords::DrawPosTextH][SkRecords::DrawRect]...
+    // The arrays commands point to, like DrawPoints' points, are kept in fAlloc, so playback
+    // walks fOps in order without skipping over them.
     //
     // We store the types of each of the pointers alongside the pointer.
-    // The cost to append a T to this structure is 8 + sizeof(T) bytes.
+    // The cost to append a T to this structure is 16 + sizeof(T) bytes, or 16 if it's inline.
 
     // A mutator that can be used with replace to destroy canvas commands.
     struct Destroyer {
@@ -128,23 +137,24 @@ private:
         void operator()(T* record) { record->~T(); }
     };
 
+    // Commands stored in a Record rather than in fOps.  They move when fRecords does.
     template <typename T>
-    SK_WHEN(std::is_empty<T>::value, T*) allocCommand() {
-        static T singleton = {};
-        return &singleton;
-    }
-
-    template <typename T>
-    SK_WHEN(!std::is_empty<T>::value, T*) allocCommand() { return this->alloc<T>(); }
+    struct IsInline : std::integral_constant<bool, sizeof(T) <= sizeof(void*) &&
+                                                   alignof(T) <= alignof(void*) &&
+                                                   std::is_trivially_copyable<T>::value> {};
 
     void grow();
 
-    // A typed pointer to some bytes in fAlloc.  visit() and mutate() allow polymorphic dispatch.
+    // A typed pointer to some bytes in fOps, or a small command itself.  visit() and mutate()
+    // allow polymorphic dispatch.
     struct Record {
         SkRecords::Type fType;
-        void*           fPtr;
+        union {
+            void* fPtr;
+            char  fInline[sizeof(void*)];
+        };
 
-        // Point this record to its data in fAlloc.  Returns ptr for convenience.
+        // Point this record to its data in fOps.  Returns ptr for convenience.
         template <typename T>
         T* set(T* ptr) {
             fType = T::kType;
@@ -153,13 +163,29 @@ private:
             return ptr;
         }
 
+        // Make room for a T in this record.
+        template <typename T>
+        T* setInline() {
+            fType = T::kType;
+            return (T*)fInline;
+        }
+
         SkRecords::Type type() const { return fType; }
-        void* ptr() const { return fPtr; }
+        void* ptr() const {
+            return const_cast<Record*>(this)->mutate([](auto* op) { return (void*)op; });
+        }
+
+        template <typename T>
+        SK_WHEN(IsInline<T>::value, T*) ptr() const { return (T*)fInline; }
+
+        template <typename T>
+        SK_WHEN(!IsInline<T>::value, T*) ptr() const { return (T*)fPtr; }
 
         // Visit this record with functor F (see public API above).
         template <typename F>
         auto visit(F&& f) const -> decltype(f(SkRecords::NoOp())) {
-        #define CASE(T) case SkRecords::T##_Type: return f(*(const SkRecords::T*)this->ptr());
+        #define CASE(T) case SkRecords::T##_Type: \
+            return f(*(const SkRecords::T*)this->ptr<SkRecords::T>());
             switch(this->type()) { SK_RECORD_TYPES(CASE) }
         #undef CASE
             SkDEBUGFAIL("Unreachable");
@@ -170,7 +196,7 @@ private:
         // Mutate this record with functor F (see public API above).
         template <typename F>
         auto mutate(F&& f) -> decltype(f((SkRecords::NoOp*)nullptr)) {
-        #define CASE(T) case SkRecords::T##_Type: return f((SkRecords::T*)this->ptr());
+        #define CASE(T) case SkRecords::T##_Type: return f(this->ptr<SkRecords::T>());
             switch(this->type()) { SK_RECORD_TYPES(CASE) }
         #undef CASE
             SkDEBUGFAIL("Unreachable");
@@ -179,14 +205,27 @@ private:
         }
     };
 
+    template <typename T>
+    SK_WHEN(IsInline<T>::value, T*) allocCommand(Record* record) { return record->setInline<T>(); }
+
+    template <typename T>
+    SK_WHEN(!IsInline<T>::value, T*) allocCommand(Record* record) {
+        struct RawBytes {
+            alignas(T) char data[sizeof(T)];
+        };
+        fApproxBytesAllocated += sizeof(T) + alignof(T);
+        return record->set((T*)fOps.makeArrayDefault<RawBytes>(1));
+    }
+
     // fRecords needs to be a data structure that can append fixed length data, and need to
     // support efficient random access and forward iteration.  (It doesn't need to be contiguous.)
     int fCount{0},
         fReserved{0};
     SkAutoTMalloc<Record> fRecords;
 
-    // fAlloc needs to be a data structure which can append variable length data in contiguous
-    // chunks, returning a stable handle to that data for later retrieval.
+    // fOps and fAlloc need to be data structures which can append variable length data in
+    // contiguous chunks, returning a stable handle to that data for later retrieval.
+    SkArenaAlloc fOps{256};
     SkArenaAlloc fAlloc{256};
     size_t       fApproxBytesAllocated{0};
 };
@@ -7,8 +7,10 @@
 
 #include "src/core/SkRecordOpts.h"
 
+#include "include/private/SkTArray.h"
 #include "include/private/SkTDArray.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkPaintPriv.h"
 #include "src/core/SkRecordPattern.h"
 #include "src/core/SkRecords.h"
 
@@ -286,6 +288,387 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// The passes below aren't pattern-based: they walk the whole record once, following the matrix and
+// clip through saves and restores.  Everything they track is in the record's own coordinates, so
+// their changes hold for whatever matrix and clip the record is drawn under.
+
+// Follows the matrix of each open save.
+class MatrixTracker {
+public:
+    MatrixTracker() { fMatrices.push_back(SkMatrix::I()); }
+
+    const SkMatrix& matrix() const { return fMatrices.back(); }
+
+    template <typename T> void operator()(const T&) {}
+    void operator()(const Save&)       { fMatrices.push_back(this->matrix()); }
+    void operator()(const SaveLayer&)  { fMatrices.push_back(this->matrix()); }
+    void operator()(const SaveBehind&) { fMatrices.push_back(this->matrix()); }
+    void operator()(const Restore& op) {
+        if (fMatrices.count() > 1) {
+            fMatrices.pop_back();
+        }
+        fMatrices.back() = op.matrix;
+    }
+    void operator()(const SetMatrix& op) { fMatrices.back() = op.matrix; }
+    void operator()(const Translate& op) { fMatrices.back().preTranslate(op.dx, op.dy); }
+    void operator()(const Concat& op)    { fMatrices.back().preConcat(op.matrix); }
+
+private:
+    SkTArray<SkMatrix> fMatrices;
+};
+
+// Intersect and difference clips only ever shrink the clip; the deprecated ops may grow it.
+static bool clip_may_grow(SkClipOp op) {
+    return op != SkClipOp::kIntersect && op != SkClipOp::kDifference;
+}
+
+// True if a draw with this paint touches exactly the pixels whose centers its geometry covers.
+static bool fills_aliased(const SkPaint* paint) {
+    return !paint || (!paint->isAntiAlias() &&
+                      paint->getStyle() == SkPaint::kFill_Style &&
+                      !paint->getPathEffect() &&
+                      !paint->getMaskFilter() &&
+                      !paint->getImageFilter());
+}
+
+static bool overwrites(const SkPaint& paint) {
+    return !paint.getMaskFilter() && !paint.getImageFilter() &&
+           SkPaintPriv::Overwrites(&paint, SkPaintPriv::kNone_ShaderOverrideOpacity);
+}
+
+// No-ops draws whose every pixel a later opaque draw overwrites:
+//   - An opaque DrawPaint overwrites everything drawn since the last clip, or since the layer it
+//     draws into was saved, whichever came later.  Nothing drawn in between, even inside nested
+//     saves and layers, reaches outside the clip it overwrites.
+//   - An opaque, aliased DrawRect overwrites the aliased rects and images drawn inside it since
+//     the last clip, layer or nested picture; those touch only pixels whose centers it covers too.
+// Neither culls inside a save where an antialiased or non-rectangular clip has been recorded.
+// Drawables are never removed, as they may draw something different each time.
+class OverdrawCuller {
+public:
+    explicit OverdrawCuller(SkRecord* record) : fRecord(record) {
+        fFirstCoverable.push_back(0);
+        fSoftClipped.push_back(false);
+    }
+
+    void run() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->visit(fIndex, *this);
+            fRecord->visit(fIndex, fMatrix);
+        }
+    }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&) {
+        fFirstCoverable.push_back(fFirstCoverable.top());
+        fSoftClipped.push_back(fSoftClipped.top());
+    }
+    void operator()(const SaveLayer&)  { this->pushLayer(); }
+    void operator()(const SaveBehind&) { this->pushLayer(); }
+    void operator()(const Restore&) {
+        if (fFirstCoverable.count() > 1) {
+            fFirstCoverable.pop();
+            fSoftClipped.pop();
+        }
+        // What was drawn inside a layer may be spread around by its paint.
+        fCandidates.reset();
+    }
+
+    void operator()(const ClipPath& op)   { this->clip(op.opAA.op(), true); }
+    void operator()(const ClipRRect& op)  { this->clip(op.opAA.op(), true); }
+    void operator()(const ClipRect& op)   { this->clip(op.opAA.op(), op.opAA.aa()); }
+    void operator()(const ClipRegion& op) { this->clip(op.op, !op.region.isRect()); }
+
+    void operator()(const DrawDrawable&) { fCandidates.reset(); }
+    void operator()(const DrawPicture&)  { fCandidates.reset(); }
+
+    void operator()(const DrawPaint& op) {
+        if (fSoftClipped.top() || !overwrites(op.paint)) {
+            return;
+        }
+        int start = fFirstCoverable.top();
+        if (start >= fCoveredFrom) {
+            start = SkTMax(start, fCoveredTo);  // The rest were overwritten by the last DrawPaint.
+        }
+        for (int i = start; i < fIndex; i++) {
+            if (fRecord->visit(i, IsCoverable())) {
+                fRecord->replace<NoOp>(i);
+            }
+        }
+        fCoveredFrom = fFirstCoverable.top();
+        fCoveredTo   = fIndex;
+        fCandidates.reset();
+    }
+
+    void operator()(const DrawRect& op) {
+        if (fills_aliased(&op.paint) && overwrites(op.paint) &&
+            fMatrix.matrix().rectStaysRect()) {
+            const SkRect covered = fMatrix.matrix().mapRect(op.rect);
+            for (int i = fCandidates.count() - 1; i >= 0; i--) {
+                if (covered.contains(fCandidates[i].fBounds)) {
+                    fRecord->replace<NoOp>(fCandidates[i].fIndex);
+                    fCandidates.remove(i);
+                }
+            }
+        }
+        this->addCandidate(&op.paint, op.rect);
+    }
+    void operator()(const DrawImage& op) {
+        this->addCandidate(op.paint, SkRect::MakeXYWH(op.left, op.top,
+                                                      op.image->width(), op.image->height()));
+    }
+    void operator()(const DrawImageRect& op) { this->addCandidate(op.paint, op.dst); }
+
+private:
+    struct IsCoverable {
+        template <typename T>
+        bool operator()(const T&) { return T::kTags & kDraw_Tag; }
+        bool operator()(const DrawDrawable&) { return false; }
+    };
+
+    void pushLayer() {
+        fFirstCoverable.push_back(fIndex + 1);
+        // The layer is still drawn into through the clips around it.
+        fSoftClipped.push_back(fSoftClipped.top());
+        fCandidates.reset();
+    }
+
+    void clip(SkClipOp op, bool soft) {
+        // Where the clip only partly covers a pixel, each draw is blended in at that partial
+        // coverage, so what was drawn before shows through whatever is drawn over it.
+        fSoftClipped.top() |= soft;
+        if (clip_may_grow(op)) {
+            // Draws after this may reach outside the clips of every open save.
+            for (int& first : fFirstCoverable) {
+                first = fIndex + 1;
+            }
+        } else {
+            fFirstCoverable.top() = fIndex + 1;
+        }
+        fCandidates.reset();
+    }
+
+    void addCandidate(const SkPaint* paint, SkRect bounds) {
+        if (fSoftClipped.top() || !fills_aliased(paint)) {
+            return;
+        }
+        // Keep the search for what a DrawRect overwrites short.
+        if (fCandidates.count() == kMaxCandidates) {
+            fCandidates.remove(0);
+        }
+        bounds.sort();
+        fCandidates.push_back({fIndex, fMatrix.matrix().mapRect(bounds)});
+    }
+
+    static constexpr int kMaxCandidates = 32;
+
+    struct Candidate {
+        int    fIndex;
+        SkRect fBounds;  // in the record's coordinates
+    };
+
+    SkRecord*     fRecord;
+    int           fIndex = 0;
+    MatrixTracker fMatrix;
+
+    // For each open save, the first op a DrawPaint inside it may overwrite.
+    SkTDArray<int> fFirstCoverable;
+    // For each open save, whether an antialiased or non-rectangular clip applies inside it.
+    SkTDArray<bool> fSoftClipped;
+    // The last DrawPaint overwrote [fCoveredFrom, fCoveredTo].
+    int fCoveredFrom = 0,
+        fCoveredTo   = 0;
+    // The draws since the last clip that a DrawRect could overwrite.
+    SkTDArray<Candidate> fCandidates;
+};
+
+void SkRecordNoopOverdrawnDraws(SkRecord* record) {
+    OverdrawCuller culler(record);
+    culler.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Merges runs of DrawImageRects that share a paint and constraint into a DrawEdgeAAImageSet.
+// Devices draw each entry of a set just as drawImageRect() would, but the GPU device can batch
+// them into a single op.  Image and mask filters apply to each draw on its own, so those are left.
+class ImageRectMerger {
+public:
+    explicit ImageRectMerger(SkRecord* record) : fRecord(record) {}
+
+    void run() {
+        for (int i = 0; i < fRecord->count(); i++) {
+            const DrawImageRect* op = fRecord->visit(i, AsDrawImageRect());
+            if (op && fCount > 0 && same_draw(*op, *fRun)) {
+                fEntries.push_back(entry(*op));
+                fLast = i;
+                fCount++;
+                continue;
+            }
+            if (!op && fRecord->visit(i, IsNoOp())) {
+                continue;
+            }
+            this->merge();
+            if (op && mergeable(*op)) {
+                fEntries.push_back(entry(*op));
+                fRun = op;
+                fFirst = fLast = i;
+                fCount = 1;
+            }
+        }
+        this->merge();
+    }
+
+private:
+    struct AsDrawImageRect {
+        const DrawImageRect* operator()(const DrawImageRect& op) { return &op; }
+        template <typename T>
+        const DrawImageRect* operator()(const T&) { return nullptr; }
+    };
+    struct IsNoOp {
+        bool operator()(const NoOp&) { return true; }
+        template <typename T>
+        bool operator()(const T&) { return false; }
+    };
+
+    static bool mergeable(const DrawImageRect& op) {
+        return !op.paint || (!op.paint->getImageFilter() && !op.paint->getMaskFilter());
+    }
+
+    static bool same_draw(const DrawImageRect& a, const DrawImageRect& b) {
+        if (a.constraint != b.constraint || !a.paint != !b.paint) {
+            return false;
+        }
+        return !a.paint || *a.paint == *b.paint;
+    }
+
+    SkCanvas::ImageSetEntry entry(const DrawImageRect& op) const {
+        const unsigned aaFlags = op.paint && op.paint->isAntiAlias()
+                ? SkCanvas::kAll_QuadAAFlags : SkCanvas::kNone_QuadAAFlags;
+        return SkCanvas::ImageSetEntry(op.image,
+                                       op.src ? *op.src : SkRect::Make(op.image->bounds()),
+                                       op.dst, 1.f, aaFlags);
+    }
+
+    void merge() {
+        if (fCount > 1) {
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(fCount);
+            for (int i = 0; i < fCount; i++) {
+                set[i] = std::move(fEntries[i]);
+            }
+            SkPaint* paint = nullptr;
+            if (fRun->paint) {
+                paint = new (fRecord->alloc<SkPaint>()) SkPaint(*fRun->paint);
+            }
+            const SkCanvas::SrcRectConstraint constraint = fRun->constraint;
+
+            new (fRecord->replace<DrawEdgeAAImageSet>(fFirst))
+                    DrawEdgeAAImageSet{paint, std::move(set), fCount, nullptr, nullptr, constraint};
+            for (int i = fFirst + 1; i <= fLast; i++) {
+                fRecord->replace<NoOp>(i);
+            }
+        }
+        fEntries.reset();
+        fRun = nullptr;
+        fCount = 0;
+    }
+
+    SkRecord* fRecord;
+
+    // The run of DrawImageRects at [fFirst, fLast], with only NoOps between them.
+    const DrawImageRect*                fRun = nullptr;
+    int                                 fFirst = 0,
+                                        fLast  = 0,
+                                        fCount = 0;
+    SkTArray<SkCanvas::ImageSetEntry>   fEntries;
+};
+
+void SkRecordMergeDrawImageRects(SkRecord* record) {
+    ImageRectMerger merger(record);
+    merger.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// No-ops aliased ClipRects that contain the clip they intersect.  Only the aliased intersect clips
+// before them are followed; antialiased clips and difference clips only shrink the clip further,
+// which leaves the ClipRect just as redundant.
+class RedundantClipNooper {
+public:
+    explicit RedundantClipNooper(SkRecord* record) : fRecord(record) {
+        fBounds.push_back(unknown_bounds());
+    }
+
+    void run() {
+        for (fIndex = 0; fIndex < fRecord->count(); fIndex++) {
+            fRecord->visit(fIndex, *this);
+            fRecord->visit(fIndex, fMatrix);
+        }
+    }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&)       { fBounds.push_back(fBounds.back()); }
+    void operator()(const SaveLayer&)  { fBounds.push_back(fBounds.back()); }
+    void operator()(const SaveBehind&) { fBounds.push_back(fBounds.back()); }
+    void operator()(const Restore&) {
+        if (fBounds.count() > 1) {
+            fBounds.pop_back();
+        }
+    }
+
+    void operator()(const ClipRect& op) {
+        const SkMatrix& matrix = fMatrix.matrix();
+        if (!op.opAA.aa() && op.opAA.op() == SkClipOp::kIntersect && matrix.rectStaysRect() &&
+            matrix.mapRect(op.rect).contains(fBounds.back())) {
+            fRecord->replace<NoOp>(fIndex);
+            return;
+        }
+        this->clip(&op.rect, op.opAA);
+    }
+    void operator()(const ClipRRect& op) { this->clip(&op.rrect.getBounds(), op.opAA); }
+    void operator()(const ClipPath& op) {
+        this->clip(op.path.isInverseFillType() ? nullptr : &op.path.getBounds(), op.opAA);
+    }
+    void operator()(const ClipRegion& op) {
+        if (clip_may_grow(op.op)) {
+            fBounds.back() = unknown_bounds();
+        }
+    }
+
+private:
+    // Nothing is contained by these, and intersecting them with a rect gives the rect.
+    static SkRect unknown_bounds() {
+        return {-SK_ScalarInfinity, -SK_ScalarInfinity, SK_ScalarInfinity, SK_ScalarInfinity};
+    }
+
+    // rect bounds the clip's geometry, or is null for an inverse fill.
+    void clip(const SkRect* rect, ClipOpAndAA opAA) {
+        SkRect& bounds = fBounds.back();
+        if (clip_may_grow(opAA.op())) {
+            bounds = unknown_bounds();
+        } else if (rect && !opAA.aa() && opAA.op() == SkClipOp::kIntersect) {
+            if (!bounds.intersect(fMatrix.matrix().mapRect(*rect))) {
+                bounds.setEmpty();
+            }
+        }
+    }
+
+    SkRecord*     fRecord;
+    int           fIndex = 0;
+    MatrixTracker fMatrix;
+    // For each open save, bounds on its clip in the record's coordinates.
+    SkTArray<SkRect> fBounds;
+};
+
+void SkRecordNoopRedundantClipRects(SkRecord* record) {
+    RedundantClipNooper nooper(record);
+    nooper.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -315,6 +698,9 @@ void SkRecordOptimize2(SkRecord* record) {
     SkRecordNoopSaveLayerDrawRestores(record);
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordNoopRedundantClipRects(record);
+    SkRecordNoopOverdrawnDraws(record);
+    SkRecordMergeDrawImageRects(record);
 
     record->defrag();
 }
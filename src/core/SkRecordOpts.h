@@ -26,6 +26,17 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// No-ops draws entirely overwritten by a later opaque DrawPaint or aliased DrawRect.  This assumes
+// the record is played back under an aliased clip; along the edges of an antialiased one the
+// overwritten draws still show through.
+void SkRecordNoopOverdrawnDraws(SkRecord*);
+
+// Merges runs of DrawImageRects that share a paint into a single DrawEdgeAAImageSet.
+void SkRecordMergeDrawImageRects(SkRecord*);
+
+// No-ops aliased ClipRects that contain the aliased clip already in effect.
+void SkRecordNoopRedundantClipRects(SkRecord*);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkRecordPlan.h"
+
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+
+template <typename T>
+static void draw_op(SkRecords::Draw* draw, const void* op) {
+    (*draw)(*static_cast<const T*>(op));
+}
+
+namespace {
+    struct IsNoOp {
+        template <typename T> bool operator()(const T&) { return false; }
+        bool operator()(const SkRecords::NoOp&) { return true; }
+    };
+
+    template <typename Step>
+    struct Resolve {
+        template <typename T> Step operator()(const T& op) { return {&draw_op<T>, &op}; }
+    };
+}
+
+SkRecordPlan::SkRecordPlan(const SkRecord& record) {
+    fSteps.reset(record.count());
+    for (int i = 0; i < record.count(); i++) {
+        if (record.visit(i, IsNoOp())) {
+            continue;
+        }
+        fSteps[fCount++] = record.visit(i, Resolve<Step>());
+    }
+}
+
+void SkRecordPlan::playback(SkCanvas* canvas,
+                            SkPicture const* const drawablePicts[], int drawableCount,
+                            SkPicture::AbortCallback* callback) const {
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    SkRecords::Draw draw(canvas, drawablePicts, nullptr, drawableCount);
+    for (int i = 0; i < fCount; i++) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        fSteps[i].fDraw(&draw, fSteps[i].fOp);
+    }
+}
+
+size_t SkRecordPlan::bytesUsed() const {
+    return sizeof(*this) + fCount * sizeof(Step);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordPlan_DEFINED
+#define SkRecordPlan_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/private/SkTemplates.h"
+
+class SkCanvas;
+class SkRecord;
+
+namespace SkRecords { class Draw; }
+
+/**
+ *  A flattened SkRecord for pictures that are played back over and over, like UI widgets and
+ *  SkPictureShader tiles. Each op is resolved once to the function making its canvas call, so
+ *  playback is a straight walk over (function, op) pairs with the NoOps gone, rather than a trip
+ *  through SkRecord::visit()'s switch per op. Nothing is culled: like SkRecordDraw() without a
+ *  BBH, every op is drawn, so what a recording canvas captures doesn't depend on the plan.
+ *
+ *  The plan points into the record, which must outlive it.
+ */
+class SkRecordPlan {
+public:
+    explicit SkRecordPlan(const SkRecord&);
+
+    /** Draws the record into canvas, as SkRecordDraw() would without a BBH. */
+    void playback(SkCanvas*, SkPicture const* const drawablePicts[], int drawableCount,
+                  SkPicture::AbortCallback*) const;
+
+    int count() const { return fCount; }
+    size_t bytesUsed() const;
+
+private:
+    struct Step {
+        void      (*fDraw)(SkRecords::Draw*, const void* op);
+        const void* fOp;
+    };
+
+    SkAutoTMalloc<Step> fSteps;
+    int                 fCount = 0;
+};
+
+#endif
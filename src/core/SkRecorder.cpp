@@ -13,6 +13,8 @@
 #include "include/private/SkTo.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
 #include "src/utils/SkPatchUtils.h"
 
 #include <new>
@@ -67,6 +69,32 @@ void SkRecorder::forgetRecord() {
     fDrawableList.reset(nullptr);
     fApproxBytesUsedBySubPictures = 0;
     fRecord = nullptr;
+    this->setInternPaths(false);
+}
+
+void SkRecorder::setInternPaths(bool intern) {
+    fInternPaths = intern;
+    fInternedPaths.reset();
+}
+
+uint32_t SkRecorder::PathContentHash::operator()(const SkPath& path) const {
+    uint32_t hash = SkOpts::hash(SkPathPriv::PointData(path),
+                                 path.countPoints() * sizeof(SkPoint), path.getFillType());
+    hash = SkOpts::hash(SkPathPriv::VerbData(path), path.countVerbs(), hash);
+    return SkOpts::hash(SkPathPriv::ConicWeightData(path),
+                        SkPathPriv::ConicWeightCnt(path) * sizeof(SkScalar), hash);
+}
+
+const SkPath& SkRecorder::intern(const SkPath& path) {
+    // Volatile paths are about to change, so there's little point sharing them.
+    if (!fInternPaths || path.isVolatile()) {
+        return path;
+    }
+    if (const SkPath* interned = fInternedPaths.find(path)) {
+        return *interned;
+    }
+    fInternedPaths.add(path);
+    return path;
 }
 
 // To make appending to fRecord a little less verbose.
@@ -190,8 +218,9 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 }
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    TRY_MINIRECORDER(drawPath, path, paint);
-    this->append<SkRecords::DrawPath>(paint, path);
+    const SkPath& interned = this->intern(path);
+    TRY_MINIRECORDER(drawPath, interned, paint);
+    this->append<SkRecords::DrawPath>(paint, interned);
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -307,7 +336,7 @@ void SkRecorder::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], cons
 }
 
 void SkRecorder::onDrawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
-    this->append<SkRecords::DrawShadowRec>(path, rec);
+    this->append<SkRecords::DrawShadowRec>(this->intern(path), rec);
 }
 
 void SkRecorder::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
@@ -390,7 +419,7 @@ void SkRecorder::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle ed
 void SkRecorder::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     INHERITED(onClipPath, path, op, edgeStyle);
     SkRecords::ClipOpAndAA opAA(op, kSoft_ClipEdgeStyle == edgeStyle);
-    this->append<SkRecords::ClipPath>(path, opAA);
+    this->append<SkRecords::ClipPath>(this->intern(path), opAA);
 }
 
 void SkRecorder::onClipRegion(const SkRegion& deviceRgn, SkClipOp op) {
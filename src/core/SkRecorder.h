@@ -10,6 +10,7 @@
 
 #include "include/core/SkCanvasVirtualEnforcer.h"
 #include "include/private/SkTDArray.h"
+#include "include/private/SkTHash.h"
 #include "include/utils/SkNoDrawCanvas.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkMiniRecorder.h"
@@ -46,6 +47,11 @@ public:
     enum DrawPictureMode { Record_DrawPictureMode, Playback_DrawPictureMode };
     void reset(SkRecord*, const SkRect& bounds, DrawPictureMode, SkMiniRecorder* = nullptr);
 
+    // When interning, a path with the same contents as one recorded earlier is recorded as a copy
+    // of that one instead, sharing its points and verbs (and generation ID). Either way this
+    // forgets the paths interned so far.
+    void setInternPaths(bool intern);
+
     size_t approxBytesUsedBySubPictures() const { return fApproxBytesUsedBySubPictures; }
 
     SkDrawableList* getDrawableList() const { return fDrawableList.get(); }
@@ -133,12 +139,21 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    const SkPath& intern(const SkPath&);
+
+    struct PathContentHash {
+        uint32_t operator()(const SkPath&) const;
+    };
+
     DrawPictureMode fDrawPictureMode;
     size_t fApproxBytesUsedBySubPictures;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
 
     SkMiniRecorder* fMiniRecorder;
+
+    bool fInternPaths = false;
+    SkTHashSet<SkPath, PathContentHash> fInternedPaths;
 };
 
 #endif//SkRecorder_DEFINED
@@ -8,6 +8,7 @@
 #include "src/core/SkStrokerPriv.h"
 
 #include "include/private/SkMacros.h"
+#include "include/private/SkTDArray.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkPathPriv.h"
@@ -135,6 +136,7 @@ public:
 
     void moveTo(const SkPoint&);
     void lineTo(const SkPoint&, const SkPath::Iter* iter = nullptr);
+    void polylineTo(const SkPoint pts[], int count, bool isClosed);
     void quadTo(const SkPoint&, const SkPoint&);
     void conicTo(const SkPoint&, const SkPoint&, SkScalar weight);
     void cubicTo(const SkPoint&, const SkPoint&, const SkPoint&);
@@ -172,6 +174,8 @@ private:
 
     SkPath  fInner, fOuter, fCusper; // outer is our working answer, inner is temp
 
+    SkTDArray<SkVector> fPolylineUnitNormals;   // scratch for polylineTo(), reused per contour
+
     enum StrokeType {
         kOuter_StrokeType = 1,      // use sign-opposite values later to flip perpendicular axis
         kInner_StrokeType = -1
@@ -243,6 +247,7 @@ private:
     void    finishContour(bool close, bool isLine);
     bool    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
                       bool isLine);
+    void    joinTo(const SkVector& normal, const SkVector& unitNormal, bool isLine);
     void    postJoinTo(const SkPoint&, const SkVector& normal,
                        const SkVector& unitNormal);
 
@@ -255,9 +260,6 @@ bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
                               SkVector* unitNormal, bool currIsLine) {
     SkASSERT(fSegmentCount >= 0);
 
-    SkScalar    prevX = fPrevPt.fX;
-    SkScalar    prevY = fPrevPt.fY;
-
     if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal)) {
         if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper) {
             return false;
@@ -269,19 +271,23 @@ bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
         unitNormal->set(1, 0);
     }
 
+    this->joinTo(*normal, *unitNormal, currIsLine);
+    return true;
+}
+
+void SkPathStroker::joinTo(const SkVector& normal, const SkVector& unitNormal, bool currIsLine) {
     if (fSegmentCount == 0) {
-        fFirstNormal = *normal;
-        fFirstUnitNormal = *unitNormal;
-        fFirstOuterPt.set(prevX + normal->fX, prevY + normal->fY);
+        fFirstNormal = normal;
+        fFirstUnitNormal = unitNormal;
+        fFirstOuterPt.set(fPrevPt.fX + normal.fX, fPrevPt.fY + normal.fY);
 
         fOuter.moveTo(fFirstOuterPt.fX, fFirstOuterPt.fY);
-        fInner.moveTo(prevX - normal->fX, prevY - normal->fY);
+        fInner.moveTo(fPrevPt.fX - normal.fX, fPrevPt.fY - normal.fY);
     } else {    // we have a previous segment
-        fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, *unitNormal,
+        fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, unitNormal,
                 fRadius, fInvMiterLimit, fPrevIsLine, currIsLine);
     }
     fPrevIsLine = currIsLine;
-    return true;
 }
 
 void SkPathStroker::postJoinTo(const SkPoint& currPt, const SkVector& normal,
@@ -373,9 +379,18 @@ SkPathStroker::SkPathStroker(const SkPath& src,
     //
     // 3x for result == inner + outer + join (swag)
     // 1x for inner == 'wag' (worst contour length would be better guess)
-    fOuter.incReserve(src.countPoints() * 3);
+    //
+    // Polylines are predictable enough to do better: each line adds at most three points to the
+    // inner path (the offset point, plus the pivot and offset point of an inner join), and the
+    // outer path takes its own offset and join points in addition to the reversed inner path.
+    if (src.getSegmentMasks() == SkPath::kLine_SegmentMask) {
+        fOuter.incReserve(src.countPoints() * 6);
+        fInner.incReserve(src.countPoints() * 3);
+    } else {
+        fOuter.incReserve(src.countPoints() * 3);
+        fInner.incReserve(src.countPoints());
+    }
     fOuter.setIsVolatile(true);
-    fInner.incReserve(src.countPoints());
     fInner.setIsVolatile(true);
     // TODO : write a common error function used by stroking and filling
     // The '4' below matches the fill scan converter's error term
@@ -447,6 +462,70 @@ void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
     this->postJoinTo(currPt, normal, unitNormal);
 }
 
+// SkPath::Iter doesn't close a contour with a NaN at either end.
+static bool can_close_to(const SkPoint& pt, const SkPoint& moveTo) {
+    return pt != moveTo && !SkScalarIsNaN(pt.fX) && !SkScalarIsNaN(pt.fY) &&
+           !SkScalarIsNaN(moveTo.fX) && !SkScalarIsNaN(moveTo.fY);
+}
+
+// Computes the unit normal of each segment pts[i] -> pts[i+1] the way set_normal_unitnormal()
+// does, so the stroke is the same either way. Segments without a normal are left as (0,0); the
+// caller falls back to preJoinTo() for those. This stays scalar: setNormalize() works in doubles,
+// which SkNx has no lanes for, and float lanes round differently.
+static void polyline_unit_normals(const SkPoint pts[], int count, SkScalar scale,
+                                  SkVector normals[]) {
+    for (int i = 0; i < count - 1; ++i) {
+        if (normals[i].setNormalize((pts[i + 1].fX - pts[i].fX) * scale,
+                                    (pts[i + 1].fY - pts[i].fY) * scale)) {
+            SkPointPriv::RotateCCW(&normals[i]);
+        }
+    }
+}
+
+// Strokes the lines of a contour in bulk: pts[0] is the current point (the contour's moveTo) and
+// each following point ends a line. This matches calling lineTo() for each point, except that the
+// segment normals are precomputed and the look-ahead of has_valid_tangent() works on the points
+// directly, since only lines follow.
+void SkPathStroker::polylineTo(const SkPoint pts[], int count, bool isClosed) {
+    SkASSERT(count >= 1 && fPrevPt == pts[0]);
+
+    fPolylineUnitNormals.setCount(count);
+    polyline_unit_normals(pts, count, fResScale, fPolylineUnitNormals.begin());
+
+    // Like has_valid_tangent(), which lets SkPath::Iter skip the lines that end within
+    // SK_ScalarNearlyZero of the current point, and then finds the closing line, if any.
+    auto hasValidTangent = [&](int i) {
+        for (int j = i + 1; j < count; ++j) {
+            if (!SkPointPriv::EqualsWithinTolerance(pts[i], pts[j])) {
+                return true;
+            }
+        }
+        return isClosed && can_close_to(pts[i], pts[0]);
+    };
+
+    const bool isButt = SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper;
+    const SkScalar teenyTolerance = SK_ScalarNearlyZero * fInvResScale;
+    for (int i = 1; i < count; ++i) {
+        const SkPoint& currPt = pts[i];
+        if (SkPointPriv::EqualsWithinTolerance(fPrevPt, currPt, teenyTolerance)) {
+            if (isButt || fJoinCompleted || hasValidTangent(i)) {
+                continue;
+            }
+        }
+        SkVector normal, unitNormal;
+        unitNormal = fPolylineUnitNormals[i - 1];
+        // The precomputed normal is only good if the previous line wasn't skipped.
+        if (fPrevPt == pts[i - 1] && !unitNormal.isZero()) {
+            unitNormal.scale(fRadius, &normal);
+            this->joinTo(normal, unitNormal, true);
+        } else if (!this->preJoinTo(currPt, &normal, &unitNormal, true)) {
+            continue;
+        }
+        this->line_to(currPt, normal);
+        this->postJoinTo(currPt, normal, unitNormal);
+    }
+}
+
 void SkPathStroker::setQuadEndNormal(const SkPoint quad[3], const SkVector& normalAB,
         const SkVector& unitNormalAB, SkVector* normalBC, SkVector* unitNormalBC) {
     if (!set_normal_unitnormal(quad[1], quad[2], fResScale, fRadius, normalBC, unitNormalBC)) {
@@ -1376,6 +1455,81 @@ private:
     bool            fSwapWithSrc;
 };
 
+// Handles a close verb; lastSegment is updated the way the caller's verb loop tracks it.
+static void close_contour(SkPathStroker* stroker, SkPaint::Cap cap, SkPath::Verb* lastSegment) {
+    if (SkPaint::kButt_Cap != cap) {
+        /* If the stroke consists of a moveTo followed by a close, treat it
+           as if it were followed by a zero-length line. Lines without length
+           can have square and round end caps. */
+        if (stroker->hasOnlyMoveTo()) {
+            stroker->lineTo(stroker->moveToPt());
+            *lastSegment = SkPath::kLine_Verb;
+            return;
+        }
+        /* If the stroke consists of a moveTo followed by one or more zero-length
+           verbs, then followed by a close, treat is as if it were followed by a
+           zero-length line. Lines without length can have square & round end caps. */
+        if (stroker->isCurrentContourEmpty()) {
+            *lastSegment = SkPath::kLine_Verb;
+            return;
+        }
+    }
+    stroker->close(*lastSegment == SkPath::kLine_Verb);
+}
+
+// Line-only paths (plots, charts, polylines) skip SkPath::Iter and hand each contour's points to
+// the stroker in one run. The verbs are visited in the same order, with the same implicit closing
+// line and trailing-moveTo handling, as the general loop in strokePath().
+static SkPath::Verb stroke_lines(const SkPath& src, SkPaint::Cap cap, SkPathStroker* stroker) {
+    SkASSERT(src.getSegmentMasks() == SkPath::kLine_SegmentMask);
+
+    const SkPoint* pts = SkPathPriv::PointData(src);
+    const SkPoint* contour = nullptr;   // the current moveTo, followed by its lines
+    int count = 0;
+    int verbsLeft = src.countVerbs();
+    SkPath::Verb lastSegment = SkPath::kMove_Verb;
+
+    for (SkPath::Verb verb : SkPathPriv::Verbs(src)) {
+        --verbsLeft;
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                if (count > 1) {
+                    stroker->polylineTo(contour, count, false);
+                }
+                contour = pts++;
+                count = 1;
+                if (verbsLeft > 0) {   // a trailing moveTo is ignored
+                    stroker->moveTo(*contour);
+                }
+                break;
+            case SkPath::kLine_Verb:
+                pts += 1;
+                count += 1;
+                lastSegment = SkPath::kLine_Verb;
+                break;
+            case SkPath::kClose_Verb: {
+                SkASSERT(contour);
+                if (count > 1) {
+                    stroker->polylineTo(contour, count, true);
+                }
+                if (can_close_to(contour[count - 1], contour[0])) {
+                    stroker->lineTo(contour[0]);
+                    lastSegment = SkPath::kLine_Verb;
+                }
+                count = 1;
+                close_contour(stroker, cap, &lastSegment);
+            } break;
+            default:
+                SkASSERT(false);
+                break;
+        }
+    }
+    if (count > 1) {
+        stroker->polylineTo(contour, count, false);
+    }
+    return lastSegment;
+}
+
 void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkASSERT(dst);
 
@@ -1413,6 +1567,11 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
 
+    if (src.getSegmentMasks() == SkPath::kLine_SegmentMask) {
+        lastSegment = stroke_lines(src, this->getCap(), &stroker);
+        goto DONE;
+    }
+
     for (;;) {
         SkPoint  pts[4];
         switch (iter.next(pts, false)) {
@@ -1437,24 +1596,7 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
                 lastSegment = SkPath::kCubic_Verb;
                 break;
             case SkPath::kClose_Verb:
-                if (SkPaint::kButt_Cap != this->getCap()) {
-                    /* If the stroke consists of a moveTo followed by a close, treat it
-                       as if it were followed by a zero-length line. Lines without length
-                       can have square and round end caps. */
-                    if (stroker.hasOnlyMoveTo()) {
-                        stroker.lineTo(stroker.moveToPt());
-                        goto ZERO_LENGTH;
-                    }
-                    /* If the stroke consists of a moveTo followed by one or more zero-length
-                       verbs, then followed by a close, treat is as if it were followed by a
-                       zero-length line. Lines without length can have square & round end caps. */
-                    if (stroker.isCurrentContourEmpty()) {
-                ZERO_LENGTH:
-                        lastSegment = SkPath::kLine_Verb;
-                        break;
-                    }
-                }
-                stroker.close(lastSegment == SkPath::kLine_Verb);
+                close_contour(&stroker, this->getCap(), &lastSegment);
                 break;
             case SkPath::kDone_Verb:
                 goto DONE;
@@ -6,7 +6,7 @@
  */
 
 
-#include "include/core/SkPathMeasure.h"
+#include "include/core/SkContourMeasure.h"
 #include "include/core/SkStrokeRec.h"
 #include "include/effects/SkDiscretePathEffect.h"
 #include "include/private/SkFixed.h"
@@ -85,21 +85,25 @@ bool SkDiscretePathEffect::onFilterPath(SkPath* dst, const SkPath& src,
                                         SkStrokeRec* rec, const SkRect*) const {
     bool doFill = rec->isFillStyle();
 
-    SkPathMeasure   meas(src, doFill);
+    SkContourMeasureIter    iter(src, doFill);
+    sk_sp<SkContourMeasure> meas = iter.next();
 
     /* Caller may supply their own seed assist, which by default is 0 */
-    uint32_t seed = fSeedAssist ^ SkScalarRoundToInt(meas.getLength());
+    uint32_t seed = fSeedAssist ^ SkScalarRoundToInt(meas ? meas->length() : 0);
 
     LCGRandom   rand(seed ^ ((seed << 16) | (seed >> 16)));
     SkScalar    scale = fPerterb;
-    SkPoint     p;
-    SkVector    v;
 
-    do {
-        SkScalar    length = meas.getLength();
+    constexpr int kBatchSize = 64;
+    SkScalar    distances[kBatchSize];
+    SkPoint     p[kBatchSize];
+    SkVector    v[kBatchSize];
+
+    for (; meas; meas = iter.next()) {
+        SkScalar    length = meas->length();
 
         if (fSegLength * (2 + doFill) > length) {
-            meas.getSegment(0, length, dst, true);  // to short for us to mangle
+            meas->getSegment(0, length, dst, true);  // to short for us to mangle
         } else {
             int         n = SkScalarRoundToInt(length / fSegLength);
             constexpr int kMaxReasonableIterations = 100000;
@@ -107,27 +111,35 @@ bool SkDiscretePathEffect::onFilterPath(SkPath* dst, const SkPath& src,
             SkScalar    delta = length / n;
             SkScalar    distance = 0;
 
-            if (meas.isClosed()) {
+            if (meas->isClosed()) {
                 n -= 1;
                 distance += delta/2;
             }
 
-            if (meas.getPosTan(distance, &p, &v)) {
-                Perterb(&p, v, rand.nextSScalar1() * scale);
-                dst->moveTo(p);
-            }
-            while (--n >= 0) {
-                distance += delta;
-                if (meas.getPosTan(distance, &p, &v)) {
-                    Perterb(&p, v, rand.nextSScalar1() * scale);
-                    dst->lineTo(p);
+            // Sample n + 1 points, a batch at a time.
+            for (int i = 0; i <= n; i += kBatchSize) {
+                int count = SkTMin(kBatchSize, n + 1 - i);
+                for (int j = 0; j < count; ++j) {
+                    distances[j] = distance;
+                    distance += delta;
+                }
+                bool batchOK = meas->getPosTan(distances, count, p, v);
+                for (int j = 0; j < count; ++j) {
+                    if (batchOK || meas->getPosTan(distances[j], &p[j], &v[j])) {
+                        Perterb(&p[j], v[j], rand.nextSScalar1() * scale);
+                        if (0 == i + j) {
+                            dst->moveTo(p[j]);
+                        } else {
+                            dst->lineTo(p[j]);
+                        }
+                    }
                 }
             }
-            if (meas.isClosed()) {
+            if (meas->isClosed()) {
                 dst->close();
             }
         }
-    } while (meas.nextContour());
+    }
     return true;
 }
 
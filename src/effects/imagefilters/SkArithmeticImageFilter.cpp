@@ -207,11 +207,13 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* source,
                                                                const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
-
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> images[2];
+    SkIPoint offsets[2];
+    this->filterInputs(2, source, ctx, images, offsets);
+    sk_sp<SkSpecialImage> background(std::move(images[0])),
+                          foreground(std::move(images[1]));
+    const SkIPoint& backgroundOffset = offsets[0];
+    const SkIPoint& foregroundOffset = offsets[1];
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
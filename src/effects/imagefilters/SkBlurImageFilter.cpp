@@ -12,10 +12,9 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/SkColorData.h"
-#include "include/private/SkNx.h"
 #include "include/private/SkTFitsIn.h"
-#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkAutoPixmapStorage.h"
+#include "src/core/SkBlurRescale.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
@@ -47,6 +46,10 @@ protected:
                                         SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    // Repeat wraps around the input bounds, which a smaller clip can shrink.
+    bool onIsClipIndependent() const override {
+        return fTileMode == SkTileMode::kDecal || fTileMode == SkTileMode::kClamp;
+    }
 
 private:
     friend void SkBlurImageFilter::RegisterFlattenables();
@@ -213,20 +216,12 @@ static int calculate_window(double sigma) {
 //
 // For a window of six, the border value is eight. In the even case the border is 3 *
 // (window/2) - 1.
-static int calculate_border(int window) {
-    return (window & 1) == 1 ? 3 * ((window - 1) / 2) : 3 * (window / 2) - 1;
-}
-
-static int calculate_buffer(int window) {
-    int bufferSize = window - 1;
-    return (window & 1) == 1 ? 3 * bufferSize : 3 * bufferSize + 1;
-}
-
-// blur_one_direction implements the common three pass box filter approximation of Gaussian blur,
-// but combines all three passes into a single pass. This approach is facilitated by three circular
-// buffers the width of the window which track values for trailing edges of each of the three
-// passes. This allows the algorithm to use more precision in the calculation because the values
-// are not rounded each pass. And this implementation also avoids a trap that's easy to fall
+//
+// SkOpts::box_blur_8888 implements the common three pass box filter approximation of Gaussian
+// blur, but combines all three passes into a single pass. This approach is facilitated by three
+// circular buffers the width of the window which track values for trailing edges of each of the
+// three passes. This allows the algorithm to use more precision in the calculation because the
+// values are not rounded each pass. And this implementation also avoids a trap that's easy to fall
 // into resulting in blending in too many zeroes near the edge.
 //
 //  In general, a window sum has the form:
@@ -261,134 +256,19 @@ static int calculate_buffer(int window) {
 //    sum0_n+2 = sum0_n+1 - buffer0[i];
 //    buffer0[i] = leading edge
 //
-//   This is all encapsulated in the processValue function below.
+//   This is all encapsulated in the processValue function in src/opts/SkBoxBlur_opts.h, which
+// runs several rows (or columns) through these sums at once.
 //
-using Pass0And1 = Sk4u[2];
-// The would be dLeft parameter is assumed to be 0.
-static void blur_one_direction(Sk4u* buffer, int window,
-                               int srcLeft, int srcRight, int dstRight,
-                               const uint32_t* src, int srcXStride, int srcYStride, int srcH,
-                                     uint32_t* dst, int dstXStride, int dstYStride) {
-
-    // The circular buffers are one less than the window.
-    auto pass0Count = window - 1,
-         pass1Count = window - 1,
-         pass2Count = (window & 1) == 1 ? window - 1 : window;
-
-    Pass0And1* buffer01Start = (Pass0And1*)buffer;
-    Sk4u*      buffer2Start  = buffer + pass0Count + pass1Count;
-    Pass0And1* buffer01End   = (Pass0And1*)buffer2Start;
-    Sk4u*      buffer2End    = buffer2Start + pass2Count;
-
-    // If the window is odd then the divisor is just window ^ 3 otherwise,
-    // it is window * window * (window + 1) = window ^ 3 + window ^ 2;
-    auto window2 = window * window;
-    auto window3 = window2 * window;
-    auto divisor = (window & 1) == 1 ? window3 : window3 + window2;
-
-    // NB the sums in the blur code use the following technique to avoid
-    // adding 1/2 to round the divide.
-    //
-    //   Sum/d + 1/2 == (Sum + h) / d
-    //   Sum + d(1/2) ==  Sum + h
-    //     h == (1/2)d
-    //
-    // But the d/2 it self should be rounded.
-    //    h == d/2 + 1/2 == (d + 1) / 2
-    //
-    // weight = 1 / d * 2 ^ 32
-    auto weight = static_cast<uint32_t>(round(1.0 / divisor * (1ull << 32)));
-    auto half = static_cast<uint32_t>((divisor + 1) / 2);
-
-    auto border = calculate_border(window);
-
-    // Calculate the start and end of the source pixels with respect to the destination start.
-    auto srcStart = srcLeft - border,
-         srcEnd   = srcRight - border,
-         dstEnd   = dstRight;
-
-    for (auto y = 0; y < srcH; y++) {
-        auto buffer01Cursor = buffer01Start;
-        auto buffer2Cursor  = buffer2Start;
-
-        Sk4u sum0{0u};
-        Sk4u sum1{0u};
-        Sk4u sum2{half};
-
-        sk_bzero(buffer01Start, (buffer2End - (Sk4u *) (buffer01Start)) * sizeof(*buffer2Start));
-
-        // Given an expanded input pixel, move the window ahead using the leadingEdge value.
-        auto processValue = [&](const Sk4u& leadingEdge) -> Sk4u {
-            sum0 += leadingEdge;
-            sum1 += sum0;
-            sum2 += sum1;
-
-            Sk4u value = sum2.mulHi(weight);
-
-            sum2 -= *buffer2Cursor;
-            *buffer2Cursor = sum1;
-            buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2Start;
-
-            sum1 -= (*buffer01Cursor)[1];
-            (*buffer01Cursor)[1] = sum0;
-            sum0 -= (*buffer01Cursor)[0];
-            (*buffer01Cursor)[0] = leadingEdge;
-            buffer01Cursor =
-                    (buffer01Cursor + 1) < buffer01End ? buffer01Cursor + 1 : buffer01Start;
-
-            return value;
-        };
-
-        auto srcIdx = srcStart;
-        auto dstIdx = 0;
-        const uint32_t* srcCursor = src;
-              uint32_t* dstCursor = dst;
-
-        // The destination pixels are not effected by the src pixels,
-        // change to zero as per the spec.
-        // https://drafts.fxtf.org/filter-effects/#FilterPrimitivesOverviewIntro
-        while (dstIdx < srcIdx) {
-            *dstCursor = 0;
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        // The edge of the source is before the edge of the destination. Calculate the sums for
-        // the pixels before the start of the destination.
-        while (dstIdx > srcIdx) {
-            Sk4u leadingEdge = srcIdx < srcEnd ? SkNx_cast<uint32_t>(Sk4b::Load(srcCursor)) : 0;
-            (void) processValue(leadingEdge);
-            srcCursor += srcXStride;
-            srcIdx++;
-        }
-
-        // The dstIdx and srcIdx are in sync now; the code just uses the dstIdx for both now.
-        // Consume the source generating pixels to dst.
-        auto loopEnd = std::min(dstEnd, srcEnd);
-        while (dstIdx < loopEnd) {
-            Sk4u leadingEdge = SkNx_cast<uint32_t>(Sk4b::Load(srcCursor));
-            SkNx_cast<uint8_t>(processValue(leadingEdge)).store(dstCursor);
-            srcCursor += srcXStride;
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        // The leading edge is beyond the end of the source. Assume that the pixels
-        // are now 0x0000 until the end of the destination.
-        loopEnd = dstEnd;
-        while (dstIdx < loopEnd) {
-            SkNx_cast<uint8_t>(processValue(0u)).store(dstCursor);
-            dstCursor += dstXStride;
-            SK_PREFETCH(dstCursor);
-            dstIdx++;
-        }
-
-        src += srcYStride;
-        dst += dstYStride;
-    }
-}
+// NB the sums use the following technique to avoid adding 1/2 to round the divide.
+//
+//   Sum/d + 1/2 == (Sum + h) / d
+//   Sum + d(1/2) ==  Sum + h
+//     h == (1/2)d
+//
+// But the d/2 it self should be rounded.
+//    h == d/2 + 1/2 == (d + 1) / 2
+//
+// The divide is a multiply by weight = 1 / d * 2 ^ 32, keeping the high 32 bits.
 
 static sk_sp<SkSpecialImage> copy_image_with_bounds(
         SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
@@ -455,55 +335,22 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, &source->props());
 }
 
-// TODO: Implement CPU backend for different fTileMode.
-static sk_sp<SkSpecialImage> cpu_blur(
-        SkVector sigma,
-        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
-        SkIRect srcBounds, SkIRect dstBounds) {
-    auto windowW = calculate_window(sigma.x()),
-         windowH = calculate_window(sigma.y());
-
-    if (windowW <= 1 && windowH <= 1) {
-        return copy_image_with_bounds(source, input, srcBounds, dstBounds);
-    }
-
-    SkBitmap inputBM;
-
-    if (!input->getROPixels(&inputBM)) {
-        return nullptr;
-    }
-
-    if (inputBM.colorType() != kN32_SkColorType) {
-        return nullptr;
-    }
-
-    SkBitmap src;
-    inputBM.extractSubset(&src, srcBounds);
-
-    // Make everything relative to the destination bounds.
-    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
-    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
-
+// Blurs src, which covers srcBounds, into a newly allocated dst covering dstBounds. Both bounds are
+// relative to dst, and srcBounds must be inside dstBounds.
+static bool box_blur(int windowW, int windowH, const SkBitmap& src,
+                     SkIRect srcBounds, SkIRect dstBounds, SkBitmap* dstPtr) {
     auto srcW = srcBounds.width(),
          srcH = srcBounds.height(),
          dstW = dstBounds.width(),
          dstH = dstBounds.height();
 
-    SkImageInfo dstInfo = inputBM.info().makeWH(dstW, dstH);
+    SkImageInfo dstInfo = src.info().makeWH(dstW, dstH);
 
-    SkBitmap dst;
+    SkBitmap& dst = *dstPtr;
     if (!dst.tryAllocPixels(dstInfo)) {
-        return nullptr;
+        return false;
     }
 
-    auto bufferSizeW = calculate_buffer(windowW),
-         bufferSizeH = calculate_buffer(windowH);
-
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
-    SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
-
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
     //     the destination. Then, do an in-place vertical blur.
@@ -544,21 +391,116 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        blur_one_direction(
-                buffer, windowW,
+        SkOpts::box_blur_8888(
+                windowW,
                 srcBounds.left(), srcBounds.right(), dstBounds.right(),
                 static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
                 intermediateSrc, 1, intermediateRowBytesAsPixels);
     }
 
     if (windowH > 1) {
-        blur_one_direction(
-                buffer, windowH,
+        SkOpts::box_blur_8888(
+                windowH,
                 srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
                 intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
                 intermediateDst, dst.rowBytesAsPixels(), 1);
     }
 
+    return true;
+}
+
+// The approximation from SkBlurRescale: blur a reduced copy of src with the remaining sigma, then
+// scale the result back up into dst. The reduced grid starts at the top left of src, and is blurred
+// over enough cells to cover all of dstBounds.
+static bool rescaled_blur(int kx, int ky, SkVector reducedSigma, const SkBitmap& src,
+                          SkIRect srcBounds, SkIRect dstBounds, SkBitmap* dst) {
+    SkIRect lowSrcBounds = SkIRect::MakeWH(SkBlurRescale::ReducedSize(srcBounds.width(), kx),
+                                           SkBlurRescale::ReducedSize(srcBounds.height(), ky));
+    SkBitmap lowSrc;
+    if (!lowSrc.tryAllocPixels(src.info().makeWH(lowSrcBounds.width(), lowSrcBounds.height()))) {
+        return false;
+    }
+    SkBlurRescale::Downsample(4, kx, ky,
+                              static_cast<const uint8_t*>(src.getPixels()), src.rowBytes(),
+                              srcBounds.width(), srcBounds.height(),
+                              static_cast<uint8_t*>(lowSrc.getPixels()), lowSrc.rowBytes());
+
+    SkIRect lowDstBounds;
+    SkBlurRescale::UpsampleRange(kx, dstBounds.width(), srcBounds.left(),
+                                 &lowDstBounds.fLeft, &lowDstBounds.fRight);
+    SkBlurRescale::UpsampleRange(ky, dstBounds.height(), srcBounds.top(),
+                                 &lowDstBounds.fTop, &lowDstBounds.fBottom);
+    // A crop can leave the reduced source poking out of the cells needed, but box_blur() wants it
+    // inside.
+    lowDstBounds.join(lowSrcBounds);
+    SkIPoint lowOrigin = lowDstBounds.topLeft();
+    lowSrcBounds.offset(-lowOrigin);
+    lowDstBounds.offset(-lowOrigin);
+
+    SkBitmap lowDst;
+    if (!box_blur(calculate_window(reducedSigma.x()), calculate_window(reducedSigma.y()),
+                  lowSrc, lowSrcBounds, lowDstBounds, &lowDst)) {
+        return false;
+    }
+
+    if (!dst->tryAllocPixels(src.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return false;
+    }
+    SkBlurRescale::Upsample(4, kx, ky,
+                            static_cast<const uint8_t*>(lowDst.getPixels()), lowDst.rowBytes(),
+                            lowDst.width(), lowDst.height(), lowOrigin.x(), lowOrigin.y(),
+                            static_cast<uint8_t*>(dst->getPixels()), dst->rowBytes(),
+                            dst->width(), dst->height(), srcBounds.left(), srcBounds.top());
+    return true;
+}
+
+// TODO: Implement CPU backend for different fTileMode.
+static sk_sp<SkSpecialImage> cpu_blur(
+        SkVector sigma,
+        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds) {
+    auto windowW = calculate_window(sigma.x()),
+         windowH = calculate_window(sigma.y());
+
+    if (windowW <= 1 && windowH <= 1) {
+        return copy_image_with_bounds(source, input, srcBounds, dstBounds);
+    }
+
+    SkBitmap inputBM;
+
+    if (!input->getROPixels(&inputBM)) {
+        return nullptr;
+    }
+
+    if (inputBM.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+
+    SkBitmap src;
+    inputBM.extractSubset(&src, srcBounds);
+
+    // Make everything relative to the destination bounds.
+    srcBounds.offset(-dstBounds.x(), -dstBounds.y());
+    dstBounds.offset(-dstBounds.x(), -dstBounds.y());
+
+    SkBitmap dst;
+    int kx = 0,
+        ky = 0;
+    if (gSkApproximateLargeBlurs.load(std::memory_order_relaxed)) {
+        // Like calculate_window(), treat sigmas past 136 as 136.
+        double reducedX, reducedY;
+        kx = SkBlurRescale::Plan(SkTPin<double>(sigma.x(), 0, 136), &reducedX);
+        ky = SkBlurRescale::Plan(SkTPin<double>(sigma.y(), 0, 136), &reducedY);
+        if ((kx > 0 || ky > 0) &&
+            !rescaled_blur(kx, ky, {SkDoubleToScalar(reducedX), SkDoubleToScalar(reducedY)},
+                           src, srcBounds, dstBounds, &dst)) {
+            return nullptr;
+        }
+    }
+    if (kx == 0 && ky == 0 && !box_blur(windowW, windowH, src, srcBounds, dstBounds, &dst)) {
+        return nullptr;
+    }
+
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
                                                           dstBounds.height()),
                                           dst, &source->props());
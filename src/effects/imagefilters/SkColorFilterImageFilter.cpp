@@ -30,6 +30,7 @@ protected:
                                         SkIPoint* offset) const override;
     bool onIsColorFilterNode(SkColorFilter**) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onIsClipIndependent() const override { return true; }
     bool affectsTransparentBlack() const override;
 
 private:
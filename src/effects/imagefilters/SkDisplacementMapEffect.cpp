@@ -297,7 +297,8 @@ sk_sp<SkSpecialImage> SkDisplacementMapEffectImpl::onFilterImage(SkSpecialImage*
     // color space makes sense, so we ignore color spaces (and gamma) entirely. This may not be
     // ideal, but it's at least consistent and predictable.
     Context displContext(ctx.ctm(), ctx.clipBounds(), ctx.cache(),
-                         OutputProperties(kN32_SkColorType, nullptr));
+                         OutputProperties(kN32_SkColorType, nullptr), ctx.executor(),
+                         ctx.partialCacheHits());
     sk_sp<SkSpecialImage> displ(this->filterInput(0, source, displContext, &displOffset));
     if (!displ) {
         return nullptr;
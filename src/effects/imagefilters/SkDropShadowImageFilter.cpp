@@ -38,6 +38,7 @@ protected:
                                         SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onIsClipIndependent() const override { return true; }
 
 private:
     friend void SkDropShadowImageFilter::RegisterFlattenables();
@@ -11,9 +11,12 @@
 #include "include/core/SkPoint3.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkNx.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -78,6 +81,47 @@ static inline void fast_normalize(SkPoint3* vector) {
     vector->fZ *= scale;
 }
 
+// Vectors for a run of pixels, kept as separate arrays of x, y and z so that they can be processed
+// four pixels at a time. Runs are padded to a multiple of four pixels.
+struct Point3Row {
+    SkScalar* fX;
+    SkScalar* fY;
+    SkScalar* fZ;
+
+    void load(int i, Sk4f* x, Sk4f* y, Sk4f* z) const {
+        *x = Sk4f::Load(fX + i);
+        *y = Sk4f::Load(fY + i);
+        *z = Sk4f::Load(fZ + i);
+    }
+    void store(int i, const Sk4f& x, const Sk4f& y, const Sk4f& z) const {
+        x.store(fX + i);
+        y.store(fY + i);
+        z.store(fZ + i);
+    }
+};
+
+// Matches fast_normalize() lane for lane where SkNx and sk_float_rsqrt() use the same estimate.
+static inline void fast_normalize(Sk4f* x, Sk4f* y, Sk4f* z) {
+    Sk4f scale = (*x * *x + *y * *y + *z * *z + SK_ScalarNearlyZero).rsqrt();
+    *x = *x * scale;
+    *y = *y * scale;
+    *z = *z * scale;
+}
+
+// The normalized vectors from count pixels starting at (x, y), with heights z, to location.
+static void surface_to_location_row(const SkPoint3& location, int x, int y, const int z[],
+                                    int count, SkScalar surfaceScale,
+                                    const Point3Row& surfaceToLight) {
+    const Sk4f dy = location.fY - SkIntToScalar(y);
+    for (int i = 0; i < count; i += 4) {
+        Sk4f dx = location.fX - SkNx_cast<float>(Sk4i(x + i) + Sk4i(0, 1, 2, 3)),
+             dyi = dy,
+             dz = location.fZ - SkNx_cast<float>(Sk4i::Load(z + i)) * surfaceScale;
+        fast_normalize(&dx, &dyi, &dz);
+        surfaceToLight.store(i, dx, dyi, dz);
+    }
+}
+
 static SkPoint3 read_point3(SkReadBuffer& buffer) {
     SkPoint3 point;
     point.fX = buffer.readScalar();
@@ -120,6 +164,17 @@ public:
     virtual SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const = 0;
     virtual SkPoint3 lightColor(const SkPoint3& surfaceToLight) const = 0;
 
+    // surfaceToLight() and lightColor() for the count pixels starting at (x, y), whose heights are
+    // z[0..count). count is a multiple of four.
+    virtual void surfaceToLightRow(int x, int y, const int z[], int count, SkScalar surfaceScale,
+                                   const Point3Row& surfaceToLight) const = 0;
+    virtual void lightColorRow(const Point3Row& surfaceToLight, int count,
+                               const Point3Row& color) const {
+        for (int i = 0; i < count; i += 4) {
+            color.store(i, fColor.fX, fColor.fY, fColor.fZ);
+        }
+    }
+
 protected:
     SkImageFilterLight(SkColor color) {
         fColor = SkPoint3::Make(SkIntToScalar(SkColorGetR(color)),
@@ -147,8 +202,24 @@ public:
 
     virtual SkPMColor light(const SkPoint3& normal, const SkPoint3& surfaceTolight,
                             const SkPoint3& lightColor) const= 0;
+
+    // light() for count pixels at once, where count is a multiple of four.
+    virtual void lightRow(const Point3Row& normal, const Point3Row& surfaceToLight,
+                          const Point3Row& lightColor, int count, SkPMColor dst[]) const = 0;
 };
 
+// SkClampMax(SkScalarRoundToInt(c), 255) for each lane.
+static inline Sk4i round_to_channel(const Sk4f& c) {
+    return SkNx_cast<int32_t>(Sk4f::Min(Sk4f::Max((c + 0.5f).floor(), 0.0f), 255.0f));
+}
+
+static inline void pack_argb(const Sk4i& a, const Sk4i& r, const Sk4i& g, const Sk4i& b,
+                             SkPMColor dst[4]) {
+    Sk4i packed = (a << SK_A32_SHIFT) | (r << SK_R32_SHIFT) |
+                  (g << SK_G32_SHIFT) | (b << SK_B32_SHIFT);
+    packed.store(dst);
+}
+
 class DiffuseLightingType : public BaseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
@@ -163,6 +234,19 @@ public:
                             SkClampMax(SkScalarRoundToInt(color.fY), 255),
                             SkClampMax(SkScalarRoundToInt(color.fZ), 255));
     }
+    void lightRow(const Point3Row& normal, const Point3Row& surfaceToLight,
+                  const Point3Row& lightColor, int count, SkPMColor dst[]) const override {
+        for (int i = 0; i < count; i += 4) {
+            Sk4f nx, ny, nz, sx, sy, sz, r, g, b;
+            normal.load(i, &nx, &ny, &nz);
+            surfaceToLight.load(i, &sx, &sy, &sz);
+            lightColor.load(i, &r, &g, &b);
+            Sk4f colorScale = fKD * (nx * sx + ny * sy + nz * sz);
+            colorScale = Sk4f::Max(Sk4f::Min(colorScale, SK_Scalar1), 0.0f);
+            pack_argb(255, round_to_channel(r * colorScale), round_to_channel(g * colorScale),
+                      round_to_channel(b * colorScale), dst + i);
+        }
+    }
 private:
     SkScalar fKD;
 };
@@ -188,6 +272,29 @@ public:
                             SkClampMax(SkScalarRoundToInt(color.fY), 255),
                             SkClampMax(SkScalarRoundToInt(color.fZ), 255));
     }
+    void lightRow(const Point3Row& normal, const Point3Row& surfaceToLight,
+                  const Point3Row& lightColor, int count, SkPMColor dst[]) const override {
+        for (int i = 0; i < count; i += 4) {
+            Sk4f nx, ny, nz, hx, hy, hz, r, g, b;
+            normal.load(i, &nx, &ny, &nz);
+            surfaceToLight.load(i, &hx, &hy, &hz);
+            lightColor.load(i, &r, &g, &b);
+            hz = hz + SK_Scalar1;
+            fast_normalize(&hx, &hy, &hz);
+            float powers[4];
+            (nx * hx + ny * hy + nz * hz).store(powers);
+            for (float& p : powers) {
+                p = SkScalarPow(p, fShininess);
+            }
+            Sk4f colorScale = fKS * Sk4f::Load(powers);
+            colorScale = Sk4f::Max(Sk4f::Min(colorScale, SK_Scalar1), 0.0f);
+            // Rounding is monotonic, so the largest rounded channel is the rounded largest one.
+            Sk4i ri = round_to_channel(r * colorScale),
+                 gi = round_to_channel(g * colorScale),
+                 bi = round_to_channel(b * colorScale);
+            pack_argb(Sk4i::Max(ri, Sk4i::Max(gi, bi)), ri, gi, bi, dst + i);
+        }
+    }
 private:
     SkScalar fKS;
     SkScalar fShininess;
@@ -234,6 +341,26 @@ static inline SkPoint3 interiorNormal(int m[9], SkScalar surfaceScale) {
                          surfaceScale);
 }
 
+// interiorNormal() for count pixels (a multiple of four), where up, mid and down are the heights
+// in the rows above, at and below the pixels. Each row is read from [-1] to [count].
+static void interiorNormalRow(const int up[], const int mid[], const int down[], int count,
+                              SkScalar surfaceScale, const Point3Row& normal) {
+    for (int i = 0; i < count; i += 4) {
+        Sk4i m0 = Sk4i::Load(up + i - 1), m1 = Sk4i::Load(up + i), m2 = Sk4i::Load(up + i + 1),
+             m3 = Sk4i::Load(mid + i - 1),                         m5 = Sk4i::Load(mid + i + 1),
+             m6 = Sk4i::Load(down + i - 1), m7 = Sk4i::Load(down + i), m8 = Sk4i::Load(down + i + 1);
+        Sk4i dx = m5 - m3,
+             dy = m7 - m1;
+        Sk4f x = SkNx_cast<float>(m2 - m0 + dx + dx + m8 - m6) * gOneQuarter,
+             y = SkNx_cast<float>(m6 - m0 + dy + dy + m8 - m2) * gOneQuarter;
+        x = -x * surfaceScale;
+        y = -y * surfaceScale;
+        Sk4f z = 1.0f;
+        fast_normalize(&x, &y, &z);
+        normal.store(i, x, y, z);
+    }
+}
+
 static inline SkPoint3 rightNormal(int m[9], SkScalar surfaceScale) {
     return pointToNormal(sobel(m[0], m[1], m[3], m[4], m[6], m[7], gOneHalf),
                          sobel(m[0], m[6], m[1], m[7],    0,    0, gOneThird),
@@ -278,13 +405,94 @@ public:
     }
 };
 
+// Images with fewer pixels than this are lit on the calling thread.
+static constexpr int64_t kMinParallelArea = 256 * 256;
+
+// Lights rows [top, bottom) of bounds, which must lie strictly between its first and last rows.
+// The normals, surface-to-light vectors and light colors of each row's interior are computed a
+// row at a time, four pixels at once.
+template <class PixelFetcher>
+static void lightInteriorRows(const BaseLightingType& lightingType,
+                              const SkImageFilterLight* l,
+                              const SkBitmap& src,
+                              SkBitmap* dst,
+                              SkScalar surfaceScale,
+                              const SkIRect& bounds,
+                              int top,
+                              int bottom) {
+    SkASSERT(bounds.top() < top && bottom < bounds.bottom());
+    const int left = bounds.left(), right = bounds.right();
+    const int width = bounds.width();
+    const SkIRect srcBounds = src.bounds();
+
+    // The heights of three rows of pixels, each padded with zeros so that the interior can be
+    // read four pixels at a time. Entry [i] of a row is pixel left + i.
+    const int count = SkAlign4(width - 2);
+    const int rowStride = count + 2;
+    SkAutoTMalloc<int> heights(3 * rowStride);
+    int* rows[3] = { heights.get(), heights.get() + rowStride, heights.get() + 2 * rowStride };
+    auto fetchRow = [&](int* row, int y) {
+        for (int i = 0; i < width; ++i) {
+            row[i] = PixelFetcher::Fetch(src, left + i, y, srcBounds);
+        }
+        for (int i = width; i < rowStride; ++i) {
+            row[i] = 0;
+        }
+    };
+
+    SkAutoTMalloc<SkScalar> vectors(9 * count);
+    Point3Row normal         = { vectors.get(),             vectors.get() + count,
+                                 vectors.get() + 2 * count },
+              surfaceToLight = { vectors.get() + 3 * count, vectors.get() + 4 * count,
+                                 vectors.get() + 5 * count },
+              lightColor     = { vectors.get() + 6 * count, vectors.get() + 7 * count,
+                                 vectors.get() + 8 * count };
+    SkAutoTMalloc<SkPMColor> colors(count);
+
+    fetchRow(rows[1], top - 1);
+    fetchRow(rows[2], top);
+    for (int y = top; y < bottom; ++y) {
+        std::swap(rows[0], rows[1]);
+        std::swap(rows[1], rows[2]);
+        fetchRow(rows[2], y + 1);
+        const int* up = rows[0];
+        const int* mid = rows[1];
+        const int* down = rows[2];
+        SkPMColor* dptr = dst->getAddr32(0, y - bounds.top());
+
+        int m[9];
+        m[1] = up[0];   m[2] = up[1];
+        m[4] = mid[0];  m[5] = mid[1];
+        m[7] = down[0]; m[8] = down[1];
+        SkPoint3 toLight = l->surfaceToLight(left, y, m[4], surfaceScale);
+        dptr[0] = lightingType.light(leftNormal(m, surfaceScale), toLight,
+                                     l->lightColor(toLight));
+
+        if (count > 0) {
+            interiorNormalRow(up + 1, mid + 1, down + 1, count, surfaceScale, normal);
+            l->surfaceToLightRow(left + 1, y, mid + 1, count, surfaceScale, surfaceToLight);
+            l->lightColorRow(surfaceToLight, count, lightColor);
+            lightingType.lightRow(normal, surfaceToLight, lightColor, count, colors.get());
+            memcpy(dptr + 1, colors.get(), (width - 2) * sizeof(SkPMColor));
+        }
+
+        m[0] = up[width - 2];   m[1] = up[width - 1];
+        m[3] = mid[width - 2];  m[4] = mid[width - 1];
+        m[6] = down[width - 2]; m[7] = down[width - 1];
+        toLight = l->surfaceToLight(right - 1, y, m[4], surfaceScale);
+        dptr[width - 1] = lightingType.light(rightNormal(m, surfaceScale), toLight,
+                                             l->lightColor(toLight));
+    }
+}
+
 template <class PixelFetcher>
 static void lightBitmap(const BaseLightingType& lightingType,
                  const SkImageFilterLight* l,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 SkExecutor* executor) {
     SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
     int left = bounds.left(), right = bounds.right();
     int bottom = bounds.bottom();
@@ -316,32 +524,26 @@ static void lightBitmap(const BaseLightingType& lightingType,
                                      l->lightColor(surfaceToLight));
     }
 
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+    // Rows between the first and the last write disjoint rows of dst, so they can be lit in
+    // bands concurrently.
+    static constexpr int kBandHeight = 64;
+    ++y;
+    if (executor && bottom - 1 - y > kBandHeight &&
+        (int64_t)bounds.width() * bounds.height() >= kMinParallelArea) {
+        SkTaskGroup bands(*executor);
+        for (int bandTop = y; bandTop < bottom - 1; bandTop += kBandHeight) {
+            bands.add([&, bandTop] {
+                lightInteriorRows<PixelFetcher>(lightingType, l, src, dst, surfaceScale, bounds,
+                                                bandTop, SkTMin(bandTop + kBandHeight, bottom - 1));
+            });
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
+        bands.wait();
+    } else {
+        lightInteriorRows<PixelFetcher>(lightingType, l, src, dst, surfaceScale, bounds,
+                                        y, bottom - 1);
     }
+    y = SkTMax(y, bottom - 1);
+    dptr = dst->getAddr32(0, y - bounds.top());
 
     {
         int x = left;
@@ -374,13 +576,14 @@ static void lightBitmap(const BaseLightingType& lightingType,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 SkExecutor* executor) {
     if (src.bounds().contains(bounds)) {
         lightBitmap<UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
+            lightingType, light, src, dst, surfaceScale, bounds, executor);
     } else {
         lightBitmap<DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
+            lightingType, light, src, dst, surfaceScale, bounds, executor);
     }
 }
 
@@ -416,6 +619,10 @@ protected:
 
     bool affectsTransparentBlack() const override { return true; }
 
+    // The surface normals along the edges of the output are found with one-sided kernels, so
+    // each tile would have its own edges.
+    bool onCanFilterTiled() const override { return false; }
+
     const SkImageFilterLight* light() const { return fLight.get(); }
     inline sk_sp<const SkImageFilterLight> refLight() const { return fLight; }
     SkScalar surfaceScale() const { return fSurfaceScale; }
@@ -855,6 +1062,12 @@ public:
     SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const override {
         return fDirection;
     }
+    void surfaceToLightRow(int x, int y, const int z[], int count, SkScalar surfaceScale,
+                           const Point3Row& surfaceToLight) const override {
+        for (int i = 0; i < count; i += 4) {
+            surfaceToLight.store(i, fDirection.fX, fDirection.fY, fDirection.fZ);
+        }
+    }
     SkPoint3 lightColor(const SkPoint3&) const override { return this->color(); }
     LightType type() const override { return kDistant_LightType; }
     const SkPoint3& direction() const { return fDirection; }
@@ -912,6 +1125,10 @@ public:
         fast_normalize(&direction);
         return direction;
     }
+    void surfaceToLightRow(int x, int y, const int z[], int count, SkScalar surfaceScale,
+                           const Point3Row& surfaceToLight) const override {
+        surface_to_location_row(fLocation, x, y, z, count, surfaceScale, surfaceToLight);
+    }
     SkPoint3 lightColor(const SkPoint3&) const override { return this->color(); }
     LightType type() const override { return kPoint_LightType; }
     const SkPoint3& location() const { return fLocation; }
@@ -1027,6 +1244,33 @@ public:
         }
         return this->color().makeScale(scale);
     }
+    void surfaceToLightRow(int x, int y, const int z[], int count, SkScalar surfaceScale,
+                           const Point3Row& surfaceToLight) const override {
+        surface_to_location_row(fLocation, x, y, z, count, surfaceScale, surfaceToLight);
+    }
+    void lightColorRow(const Point3Row& surfaceToLight, int count,
+                       const Point3Row& color) const override {
+        for (int i = 0; i < count; i += 4) {
+            Sk4f sx, sy, sz;
+            surfaceToLight.load(i, &sx, &sy, &sz);
+            float cosAngles[4];
+            (-(sx * fS.fX + sy * fS.fY + sz * fS.fZ)).store(cosAngles);
+            float scales[4];
+            for (int j = 0; j < 4; ++j) {
+                SkScalar cosAngle = cosAngles[j];
+                scales[j] = 0;
+                if (cosAngle >= fCosOuterConeAngle) {
+                    scales[j] = SkScalarPow(cosAngle, fSpecularExponent);
+                    if (cosAngle < fCosInnerConeAngle) {
+                        scales[j] *= (cosAngle - fCosOuterConeAngle) * fConeScale;
+                    }
+                }
+            }
+            Sk4f scale = Sk4f::Load(scales);
+            color.store(i, this->color().fX * scale, this->color().fY * scale,
+                        this->color().fZ * scale);
+        }
+    }
     GrGLLight* createGLLight() const override {
 #if SK_SUPPORT_GPU
         return new GrGLSpotLight;
@@ -1311,7 +1555,8 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
                                                              inputBM,
                                                              &dst,
                                                              surfaceScale(),
-                                                             bounds);
+                                                             bounds,
+                                                             ctx.executor());
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
                                           dst);
@@ -1447,7 +1692,8 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
                                                               inputBM,
                                                               &dst,
                                                               surfaceScale(),
-                                                              bounds);
+                                                              bounds,
+                                                              ctx.executor());
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()), dst);
 }
@@ -46,6 +46,9 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(SkSpecialImage* source, const Context&,
                                         SkIPoint* offset) const override;
 
+    // The zoom is set by the size of the whole output.
+    bool onCanFilterTiled() const override { return false; }
+
 private:
     friend void SkMagnifierImageFilter::RegisterFlattenables();
     SK_FLATTENABLE_HOOKS(SkMagnifierImageFilterImpl)
@@ -12,9 +12,11 @@
 #include "include/core/SkTileMode.h"
 #include "include/core/SkUnPreMultiply.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkNx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -25,6 +27,9 @@
 
 namespace {
 
+// The interior of results smaller than this is filtered on the calling thread.
+static constexpr int64_t kMinParallelArea = 256 * 256;
+
 class SkMatrixConvolutionImageFilterImpl final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilterImpl(const SkISize& kernelSize, const SkScalar* kernel,
@@ -44,10 +49,12 @@ public:
         SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
         SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
         SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
+        this->findSeparableKernel();
     }
 
     ~SkMatrixConvolutionImageFilterImpl() override {
         delete[] fKernel;
+        delete[] fSeparableKernel;
     }
 
 protected:
@@ -60,6 +67,11 @@ protected:
                                MapDirection, const SkIRect* inputRect) const override;
     bool affectsTransparentBlack() const override;
 
+    // Repeat and mirror wrap around the bounds of the input, which for a tile is just the tile.
+    bool onCanFilterTiled() const override {
+        return fTileMode != SkTileMode::kRepeat && fTileMode != SkTileMode::kMirror;
+    }
+
 private:
     friend void SkMatrixConvolutionImageFilter::RegisterFlattenables();
     SK_FLATTENABLE_HOOKS(SkMatrixConvolutionImageFilterImpl)
@@ -71,6 +83,13 @@ private:
     SkIPoint    fKernelOffset;
     SkTileMode  fTileMode;
     bool        fConvolveAlpha;
+    // If the kernel is rank-1, the fKernelSize.fWidth weights of the row and fKernelSize.fHeight
+    // weights of the column through its largest weight, whose outer product is the kernel times
+    // fSeparableDivisor (that weight). Otherwise null.
+    SkScalar*   fSeparableKernel = nullptr;
+    SkScalar    fSeparableDivisor = 1;
+
+    void findSeparableKernel();
 
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
@@ -78,6 +97,12 @@ private:
                       SkIVector& offset,
                       const SkIRect& rect,
                       const SkIRect& bounds) const;
+    template <class PixelFetcher, bool convolveAlpha>
+    void filterPixelsSeparable(const SkBitmap& src,
+                               SkBitmap* result,
+                               SkIVector& offset,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
     template <class PixelFetcher>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
@@ -262,6 +287,72 @@ void SkMatrixConvolutionImageFilterImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeBool(fConvolveAlpha);
 }
 
+void SkMatrixConvolutionImageFilterImpl::findSeparableKernel() {
+    const int w = fKernelSize.width(),
+              h = fKernelSize.height();
+    // Two 1-D passes only save work when both are longer than one tap, and not for 2x2.
+    if (w < 2 || h < 2 || w * h <= w + h) {
+        return;
+    }
+
+    // A rank-1 kernel is the outer product of its largest weight's row and column, divided by
+    // that weight. Dividing the sums rather than either 1-D kernel keeps integer kernels exact.
+    int pivot = 0;
+    for (int i = 1; i < w * h; ++i) {
+        if (SkScalarAbs(fKernel[i]) > SkScalarAbs(fKernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const SkScalar maxWeight = fKernel[pivot];
+    if (maxWeight == 0 || !SkScalarIsFinite(maxWeight)) {
+        return;
+    }
+    const int px = pivot % w,
+              py = pivot / w;
+    const SkScalar tolerance = SkScalarAbs(maxWeight) * (1.0f / (1 << 20));
+    for (int cy = 0; cy < h; ++cy) {
+        for (int cx = 0; cx < w; ++cx) {
+            SkScalar product = fKernel[cy * w + px] * fKernel[py * w + cx] / maxWeight;
+            if (!(SkScalarAbs(fKernel[cy * w + cx] - product) <= tolerance)) {
+                return;
+            }
+        }
+    }
+
+    fSeparableKernel = new SkScalar[w + h];
+    for (int cx = 0; cx < w; ++cx) {
+        fSeparableKernel[cx] = fKernel[py * w + cx];
+    }
+    for (int cy = 0; cy < h; ++cy) {
+        fSeparableKernel[w + cy] = fKernel[cy * w + px];
+    }
+    fSeparableDivisor = maxWeight;
+}
+
+// Channel sums are Sk4f in memory order, so this is the lane that holds alpha.
+static constexpr int kAlphaLane = SK_A32_SHIFT / 8;
+
+static inline Sk4f fetch_channels(SkPMColor c) {
+    return SkNx_cast<float>(Sk4b::Load(&c));
+}
+
+// Scales and biases the channel sums, then pins color to [0, alpha] and alpha to [0, 255]. If
+// !convolveAlpha, the result takes its alpha from the source pixel and is premultiplied by it.
+template<bool convolveAlpha>
+static inline SkPMColor pack_sums(const Sk4f& sums, SkScalar gain, SkScalar bias,
+                                  SkPMColor srcPixel) {
+    Sk4f v = Sk4f::Min(Sk4f::Max((sums * gain + bias).floor(), 0.0f), 255.0f);
+    float a = convolveAlpha ? v[kAlphaLane] : 255.0f;
+    Sk4i channels = SkNx_cast<int32_t>(Sk4f::Min(v, a));
+    int r = channels[SK_R32_SHIFT / 8],
+        g = channels[SK_G32_SHIFT / 8],
+        b = channels[SK_B32_SHIFT / 8];
+    if (!convolveAlpha) {
+        return SkPreMultiplyARGB(SkGetPackedA32(srcPixel), r, g, b);
+    }
+    return SkPackARGB32(channels[kAlphaLane], r, g, b);
+}
+
 template<class PixelFetcher, bool convolveAlpha>
 void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
                                                       SkBitmap* result,
@@ -275,34 +366,81 @@ void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            Sk4f sums = 0.0f;
             for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
                 for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
                     SkPMColor s = PixelFetcher::fetch(src,
                                                       x + cx - fKernelOffset.fX,
                                                       y + cy - fKernelOffset.fY,
                                                       bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkGetPackedA32(s) * k;
-                    }
-                    sumR += SkGetPackedR32(s) * k;
-                    sumG += SkGetPackedG32(s) * k;
-                    sumB += SkGetPackedB32(s) * k;
+                    sums = sums + fetch_channels(s) * fKernel[cy * fKernelSize.fWidth + cx];
                 }
             }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(sumA * fGain + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(sumR * fGain + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(sumG * fGain + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(sumB * fGain + fBias), a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+            *dptr++ = pack_sums<convolveAlpha>(sums, fGain, fBias,
+                                               convolveAlpha ? 0
+                                                             : PixelFetcher::fetch(src, x, y,
+                                                                                   bounds));
+        }
+    }
+}
+
+// Every pixel fetcher treats x and y independently, so a separable kernel can run as a pass
+// along each row into a window of fKernelSize.fHeight rows of sums, followed by a pass down the
+// columns of that window.
+template<class PixelFetcher, bool convolveAlpha>
+void SkMatrixConvolutionImageFilterImpl::filterPixelsSeparable(const SkBitmap& src,
+                                                               SkBitmap* result,
+                                                               SkIVector& offset,
+                                                               const SkIRect& r,
+                                                               const SkIRect& bounds) const {
+    SkIRect rect(r);
+    if (!rect.intersect(bounds)) {
+        return;
+    }
+    const int w = fKernelSize.width(),
+              h = fKernelSize.height();
+    const SkScalar* rowKernel = fSeparableKernel;
+    const SkScalar* columnKernel = fSeparableKernel + w;
+
+    // rows[i] holds the row sums for source row (rect.fTop - fKernelOffset.fY + j), where
+    // i == j % h.
+    const int width = rect.width();
+    SkAutoTMalloc<Sk4f> rows(width * h);
+    auto filterRow = [&](int sy, Sk4f* row) {
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            Sk4f sums = 0.0f;
+            for (int cx = 0; cx < w; ++cx) {
+                SkPMColor s = PixelFetcher::fetch(src, x + cx - fKernelOffset.fX, sy, bounds);
+                sums = sums + fetch_channels(s) * rowKernel[cx];
+            }
+            *row++ = sums;
+        }
+    };
+    const int firstRow = rect.fTop - fKernelOffset.fY;
+    for (int j = 0; j < h - 1; ++j) {
+        filterRow(firstRow + j, &rows[j * width]);
+    }
+
+    SkAutoSTMalloc<16, const Sk4f*> window(h);
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        const int j0 = y - rect.fTop;   // the window is rows j0 .. j0 + h - 1
+        filterRow(firstRow + j0 + h - 1, &rows[((j0 + h - 1) % h) * width]);
+        for (int cy = 0; cy < h; ++cy) {
+            window[cy] = &rows[((j0 + cy) % h) * width];
+        }
+
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+        for (int x = 0; x < width; ++x) {
+            Sk4f sums = 0.0f;
+            for (int cy = 0; cy < h; ++cy) {
+                sums = sums + window[cy][x] * columnKernel[cy];
             }
+            sums = sums / fSeparableDivisor;
+            *dptr++ = pack_sums<convolveAlpha>(sums, fGain, fBias,
+                                               convolveAlpha ? 0
+                                                             : PixelFetcher::fetch(
+                                                                       src, x + rect.fLeft, y,
+                                                                       bounds));
         }
     }
 }
@@ -313,7 +451,13 @@ void SkMatrixConvolutionImageFilterImpl::filterPixels(const SkBitmap& src,
                                                       SkIVector& offset,
                                                       const SkIRect& rect,
                                                       const SkIRect& bounds) const {
-    if (fConvolveAlpha) {
+    if (fSeparableKernel) {
+        if (fConvolveAlpha) {
+            filterPixelsSeparable<PixelFetcher, true>(src, result, offset, rect, bounds);
+        } else {
+            filterPixelsSeparable<PixelFetcher, false>(src, result, offset, rect, bounds);
+        }
+    } else if (fConvolveAlpha) {
         filterPixels<PixelFetcher, true>(src, result, offset, rect, bounds);
     } else {
         filterPixels<PixelFetcher, false>(src, result, offset, rect, bounds);
@@ -529,7 +673,22 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilterImpl::onFilterImage(SkSpecia
 
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, top, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, left, srcBounds);
-    this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
+    // Bands of the interior write disjoint rows of dst, so they can be filtered concurrently.
+    static constexpr int kBandHeight = 64;
+    if (ctx.executor() && interior.height() > kBandHeight &&
+        (int64_t)interior.width() * interior.height() >= kMinParallelArea) {
+        SkTaskGroup bands(*ctx.executor());
+        for (int bandTop = interior.top(); bandTop < interior.bottom(); bandTop += kBandHeight) {
+            SkIRect band = SkIRect::MakeLTRB(interior.left(), bandTop, interior.right(),
+                                             SkTMin(bandTop + kBandHeight, interior.bottom()));
+            bands.add([this, &inputBM, &dst, dstContentOffset, band, srcBounds]() mutable {
+                this->filterInteriorPixels(inputBM, &dst, dstContentOffset, band, srcBounds);
+            });
+        }
+        bands.wait();
+    } else {
+        this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
+    }
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, right, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, bottom, srcBounds);
 
@@ -29,6 +29,7 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(SkSpecialImage* source, const Context&,
                                         SkIPoint* offset) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onIsClipIndependent() const override { return true; }
 
 private:
     friend void SkMergeImageFilter::RegisterFlattenables();
@@ -74,9 +75,8 @@ sk_sp<SkSpecialImage> SkMergeImageFilterImpl::onFilterImage(
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
 
     // Filter all of the inputs.
+    this->filterInputs(inputCount, source, ctx, inputs.get(), offsets.get());
     for (int i = 0; i < inputCount; ++i) {
-        offsets[i] = { 0, 0 };
-        inputs[i] = this->filterInput(i, source, ctx, &offsets[i]);
         if (!inputs[i]) {
             continue;
         }
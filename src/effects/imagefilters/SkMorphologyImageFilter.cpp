@@ -10,6 +10,8 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkRect.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkNx.h"
+#include "include/private/SkTemplates.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
@@ -53,6 +55,7 @@ public:
     SkRect computeFastBounds(const SkRect& src) const override;
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onIsClipIndependent() const override { return true; }
 
     /**
      * All morphology procs have the same signature: src is the source buffer, dst the
@@ -622,7 +625,21 @@ static sk_sp<SkSpecialImage> apply_morphology(
 
 namespace {
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // The morphology procs use the van Herk/Gil-Werman algorithm, so their cost per pixel does not
+    // depend on the radius. Each line is padded by radius identity values (0 to dilate, 255 to
+    // erode) on both sides, which leaves the result at the edges unchanged, and cut into blocks of
+    // one window (2 * radius + 1 pixels). Every window then covers the tail of one block and the
+    // head of the next, so its extreme is the extreme of the running values from either end of
+    // those blocks:
+    //
+    //    forward[j]  = extreme of the padded line from the start of j's block up to j
+    //    backward[j] = extreme of the padded line from j to the end of j's block
+    //    dst[x]      = extreme(backward[x], forward[x + window - 1])
+    //
+    // Channels are independent, so several lines are run at once in Sk16b lanes. In the X
+    // direction that gathers four rows. In the Y direction the lines are adjacent columns, so
+    // every step reads and writes a contiguous strip of each row, which keeps the cache lines and
+    // pages touched by the column walk to a minimum.
     template<MorphType type, MorphDirection direction>
     static void morph(const SkPMColor* src, SkPMColor* dst,
                       int radius, int width, int height, int srcStride, int dstStride) {
@@ -631,108 +648,95 @@ namespace {
         const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
         const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
         radius = SkMin32(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                __m128i extreme = (type == MorphType::kDilate) ? _mm_setzero_si128()
-                                                               : _mm_set1_epi32(0xFFFFFFFF);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    __m128i src_pixel = _mm_cvtsi32_si128(*p);
-                    extreme = (type == MorphType::kDilate) ? _mm_max_epu8(src_pixel, extreme)
-                                                           : _mm_min_epu8(src_pixel, extreme);
-                }
-                *dptr = _mm_cvtsi128_si32(extreme);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
-        }
-    }
 
-#elif defined(SK_ARM_HAS_NEON)
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = SkMin32(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                uint8x8_t extreme = vdup_n_u8(type == MorphType::kDilate ? 0 : 255);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    uint8x8_t src_pixel = vreinterpret_u8_u32(vdup_n_u32(*p));
-                    extreme = (type == MorphType::kDilate) ? vmax_u8(src_pixel, extreme)
-                                                           : vmin_u8(src_pixel, extreme);
+        // Sk16b vectors (four pixels each) per step, and the number of lines that makes.
+        constexpr int kVecs  = direction == MorphDirection::kX ? 1 : 8;
+        constexpr int kLines = 4 * kVecs;
+
+        const uint8_t identity = type == MorphType::kDilate ? 0 : 255;
+        auto extreme = [](const Sk16b& a, const Sk16b& b) {
+            return type == MorphType::kDilate ? Sk16b::Max(a, b) : Sk16b::Min(a, b);
+        };
+
+        const int window = 2 * radius + 1;
+        const int paddedWidth = width + 2 * radius;
+        SkAutoTMalloc<Sk16b> forward(paddedWidth * kVecs);
+
+        for (int line = 0; line < height; line += kLines) {
+            const SkPMColor* lineSrc = src + line * srcStrideY;
+            SkPMColor* lineDst = dst + line * dstStrideY;
+            const int lines = SkMin32(kLines, height - line);
+            const bool contiguous = srcStrideY == 1 && dstStrideY == 1 && lines == kLines;
+
+            // Reads padded pixel j of each line.
+            auto load = [&](int j, Sk16b v[kVecs]) {
+                if (j < radius || j >= width + radius) {
+                    for (int i = 0; i < kVecs; ++i) {
+                        v[i] = identity;
+                    }
+                    return;
                 }
-                *dptr = vget_lane_u32(vreinterpret_u32_u8(extreme), 0);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
+                const SkPMColor* p = lineSrc + (j - radius) * srcStrideX;
+                if (contiguous) {
+                    for (int i = 0; i < kVecs; ++i) {
+                        v[i] = Sk16b::Load(p + 4 * i);
+                    }
+                    return;
+                }
+                SkPMColor px[kLines];
+                for (int l = 0; l < kLines; ++l) {
+                    px[l] = l < lines ? p[l * srcStrideY] : 0;
+                }
+                for (int i = 0; i < kVecs; ++i) {
+                    v[i] = Sk16b::Load(px + 4 * i);
+                }
+            };
+            auto store = [&](int x, const Sk16b v[kVecs]) {
+                SkPMColor* p = lineDst + x * dstStrideX;
+                if (contiguous) {
+                    for (int i = 0; i < kVecs; ++i) {
+                        v[i].store(p + 4 * i);
+                    }
+                    return;
+                }
+                SkPMColor px[kLines];
+                for (int i = 0; i < kVecs; ++i) {
+                    v[i].store(px + 4 * i);
+                }
+                for (int l = 0; l < lines; ++l) {
+                    p[l * dstStrideY] = px[l];
+                }
+            };
+
+            // pos is j's offset within its block.
+            Sk16b v[kVecs], run[kVecs];
+            for (int j = 0, pos = 0; j < paddedWidth; ++j) {
+                load(j, v);
+                Sk16b* f = &forward[j * kVecs];
+                for (int i = 0; i < kVecs; ++i) {
+                    run[i] = pos == 0 ? v[i] : extreme(run[i], v[i]);
+                    f[i] = run[i];
+                }
+                pos = pos + 1 == window ? 0 : pos + 1;
             }
-            if (x >= radius) src += srcStrideX;
-            if (x + radius < width - 1) upperSrc += srcStrideX;
-            dst += dstStrideX;
-        }
-    }
-
-#else
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = SkMin32(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                // If we're maxing (dilate), start from 0; if minning (erode), start from 255.
-                const int start = (type == MorphType::kDilate) ? 0 : 255;
-                int B = start, G = start, R = start, A = start;
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    int b = SkGetPackedB32(*p),
-                        g = SkGetPackedG32(*p),
-                        r = SkGetPackedR32(*p),
-                        a = SkGetPackedA32(*p);
-                    if (type == MorphType::kDilate) {
-                        B = SkTMax(b, B);
-                        G = SkTMax(g, G);
-                        R = SkTMax(r, R);
-                        A = SkTMax(a, A);
-                    } else {
-                        B = SkTMin(b, B);
-                        G = SkTMin(g, G);
-                        R = SkTMin(r, R);
-                        A = SkTMin(a, A);
+            // The last block may be partial, so it also starts afresh at the end of the line.
+            for (int j = paddedWidth - 1, pos = j % window; j >= 0; --j) {
+                load(j, v);
+                const bool blockEnd = pos == window - 1 || j == paddedWidth - 1;
+                for (int i = 0; i < kVecs; ++i) {
+                    run[i] = blockEnd ? v[i] : extreme(run[i], v[i]);
+                }
+                pos = pos == 0 ? window - 1 : pos - 1;
+                if (j < width) {
+                    const Sk16b* f = &forward[(j + window - 1) * kVecs];
+                    for (int i = 0; i < kVecs; ++i) {
+                        v[i] = extreme(run[i], f[i]);
                     }
+                    store(j, v);
                 }
-                *dptr = SkPackARGB32(A, R, G, B);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
             }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
         }
     }
-#endif
 }  // namespace
 
 sk_sp<SkSpecialImage> SkMorphologyImageFilterImpl::onFilterImage(SkSpecialImage* source,
@@ -35,6 +35,7 @@ protected:
                                         SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect&, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
+    bool onIsClipIndependent() const override { return true; }
 
 private:
     friend void SkOffsetImageFilter::RegisterFlattenables();
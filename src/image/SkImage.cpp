@@ -8,6 +8,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageGenerator.h"
@@ -291,7 +292,8 @@ sk_sp<SkImage> SkImage::makeWithFilter(GrContext* grContext,
     // the clip bounds (since it is assumed to already be in image space).
     SkImageFilter_Base::Context context(SkMatrix::MakeTrans(-subset.x(), -subset.y()),
                                         clipBounds.makeOffset(-subset.x(), -subset.y()),
-                                        cache.get(), outputProperties);
+                                        cache.get(), outputProperties,
+                                        &SkExecutor::GetDefault());
 
     sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(srcSpecialImage.get(), context,
                                                                offset);
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBoxBlur_opts_DEFINED
+#define SkBoxBlur_opts_DEFINED
+
+#include "include/private/SkNx.h"
+#include "include/private/SkTemplates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SK_OPTS_NS {
+
+// The circular buffers are one less than the window, except that the third is one larger for even
+// windows; see SkBlurImageFilter.cpp.
+static int box_blur_buffer_count(int window) {
+    return (window & 1) == 1 ? 3 * (window - 1) : 3 * (window - 1) + 1;
+}
+
+// The three pass box blur described in SkBlurImageFilter.cpp, run along P lines at once. Every
+// channel of every line is independent, so the results are identical to blurring each line on its
+// own. storage must hold box_blur_buffer_count(window) * P values.
+template <int P>
+static void box_blur_8888_lines(Sk4u* storage, int window, int srcLeft, int srcRight, int dstRight,
+                                const uint32_t* src, int srcXStride, int srcYStride,
+                                      uint32_t* dst, int dstXStride, int dstYStride) {
+    const int pass0Count = window - 1,
+              pass1Count = window - 1,
+              pass2Count = (window & 1) == 1 ? window - 1 : window;
+
+    // Each buffer entry holds the P lines' values for one step.
+    Sk4u* buffer0 = storage;
+    Sk4u* buffer1 = buffer0 + pass0Count * P;
+    Sk4u* buffer2 = buffer1 + pass1Count * P;
+    Sk4u* bufferEnd = buffer2 + pass2Count * P;
+    std::fill(buffer0, bufferEnd, Sk4u(0u));
+
+    // If the window is odd then the divisor is just window ^ 3 otherwise,
+    // it is window * window * (window + 1) = window ^ 3 + window ^ 2;
+    const uint64_t window2 = window * window,
+                   window3 = window2 * window,
+                   divisor = (window & 1) == 1 ? window3 : window3 + window2;
+    const uint32_t weight = static_cast<uint32_t>(round(1.0 / divisor * (1ull << 32)));
+    const uint32_t half = static_cast<uint32_t>((divisor + 1) / 2);
+
+    const int border = (window & 1) == 1 ? 3 * ((window - 1) / 2) : 3 * (window / 2) - 1;
+    const int srcStart = srcLeft - border,
+              srcEnd   = srcRight - border,
+              dstEnd   = dstRight;
+
+    Sk4u sum0[P], sum1[P], sum2[P];
+    for (int i = 0; i < P; ++i) {
+        sum0[i] = 0u;
+        sum1[i] = 0u;
+        sum2[i] = half;
+    }
+    Sk4u* cursor0 = buffer0;
+    Sk4u* cursor1 = buffer1;
+    Sk4u* cursor2 = buffer2;
+
+    // Moves the P windows ahead by one, returning the blurred values for this step.
+    auto processValues = [&](const Sk4u leadingEdge[P], Sk4u values[P]) {
+        for (int i = 0; i < P; ++i) {
+            sum0[i] += leadingEdge[i];
+            sum1[i] += sum0[i];
+            sum2[i] += sum1[i];
+
+            values[i] = sum2[i].mulHi(weight);
+
+            sum2[i] -= cursor2[i];
+            cursor2[i] = sum1[i];
+            sum1[i] -= cursor1[i];
+            cursor1[i] = sum0[i];
+            sum0[i] -= cursor0[i];
+            cursor0[i] = leadingEdge[i];
+        }
+        cursor2 = cursor2 + P < bufferEnd ? cursor2 + P : buffer2;
+        cursor1 = cursor1 + P < buffer2   ? cursor1 + P : buffer1;
+        cursor0 = cursor0 + P < buffer1   ? cursor0 + P : buffer0;
+    };
+
+    auto load = [&](const uint32_t* ptr, Sk4u pixels[P]) {
+        for (int i = 0; i < P; ++i) {
+            pixels[i] = SkNx_cast<uint32_t>(Sk4b::Load(ptr + i * srcYStride));
+        }
+    };
+    auto store = [&](const Sk4u values[P], uint32_t* ptr) {
+        for (int i = 0; i < P; ++i) {
+            SkNx_cast<uint8_t>(values[i]).store(ptr + i * dstYStride);
+        }
+    };
+
+    Sk4u zeros[P], pixels[P], values[P];
+    for (int i = 0; i < P; ++i) {
+        zeros[i] = 0u;
+    }
+
+    int srcIdx = srcStart,
+        dstIdx = 0;
+    const uint32_t* srcCursor = src;
+          uint32_t* dstCursor = dst;
+
+    // The destination pixels are not effected by the src pixels,
+    // change to zero as per the spec.
+    while (dstIdx < srcIdx) {
+        store(zeros, dstCursor);
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+
+    // The edge of the source is before the edge of the destination. Calculate the sums for
+    // the pixels before the start of the destination.
+    while (dstIdx > srcIdx) {
+        if (srcIdx < srcEnd) {
+            load(srcCursor, pixels);
+            processValues(pixels, values);
+        } else {
+            processValues(zeros, values);
+        }
+        srcCursor += srcXStride;
+        srcIdx++;
+    }
+
+    // Consume the source generating pixels to dst.
+    int loopEnd = std::min(dstEnd, srcEnd);
+    while (dstIdx < loopEnd) {
+        load(srcCursor, pixels);
+        processValues(pixels, values);
+        store(values, dstCursor);
+        srcCursor += srcXStride;
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+
+    // The leading edge is beyond the end of the source; it is 0x0000 until the end of dst.
+    while (dstIdx < dstEnd) {
+        processValues(zeros, values);
+        store(values, dstCursor);
+        dstCursor += dstXStride;
+        dstIdx++;
+    }
+}
+
+static void box_blur_8888(int window, int srcLeft, int srcRight, int dstRight,
+                          const uint32_t* src, int srcXStride, int srcYStride, int lines,
+                                uint32_t* dst, int dstXStride, int dstYStride) {
+    // A blur across lines that are adjacent in memory (the vertical pass) walks down the image with
+    // a stride of a whole row, so only a few bytes of each cache line and page it touches are used
+    // by a single column. Blurring 32 columns at once reads and writes two full cache lines a row.
+    // Along rows (the horizontal pass) every line is already contiguous, so go one at a time.
+    constexpr int kAdjacentLines = 32;
+
+    const int P = (srcYStride == 1 && dstYStride == 1) ? kAdjacentLines : 1;
+    SkAutoTMalloc<Sk4u> storage(box_blur_buffer_count(window) * P);
+
+    int line = 0;
+    if (P == kAdjacentLines) {
+        for (; line + kAdjacentLines <= lines; line += kAdjacentLines) {
+            box_blur_8888_lines<kAdjacentLines>(storage.get(), window, srcLeft, srcRight, dstRight,
+                                                src + line, srcXStride, srcYStride,
+                                                dst + line, dstXStride, dstYStride);
+        }
+    }
+    for (; line < lines; line++) {
+        box_blur_8888_lines<1>(storage.get(), window, srcLeft, srcRight, dstRight,
+                               src + line * srcYStride, srcXStride, srcYStride,
+                               dst + line * dstYStride, dstXStride, dstYStride);
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkBoxBlur_opts_DEFINED
@@ -10,6 +10,7 @@
 #define SK_OPTS_NS hsw
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkBoxBlur_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkUtils_opts.h"
 
@@ -20,6 +21,8 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        box_blur_8888 = SK_OPTS_NS::box_blur_8888;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
@@ -2609,6 +2609,77 @@ STAGE(gauss_a_to_rgba, Ctx::None) {
     b = a;
 }
 
+// Fractal noise and turbulence from the SVG spec, as in SkPerlinNoiseShader's noise2D(), with
+// all four channels sharing the lattice lookups of each octave.
+STAGE(perlin_noise, const SkRasterPipeline_PerlinNoiseCtx* c) {
+    // Noise is sampled at whole device pixels moved into noise space, and rounded.
+    F x = floor_(floor_(r) + c->offsetX + 0.5f) * c->baseFrequencyX,
+      y = floor_(floor_(g) + c->offsetY + 0.5f) * c->baseFrequencyY;
+
+    // Lattice coordinates wrap to the 256 entry tables.  This is exact for |v| < 2^24.
+    auto wrap = [](F v) { return trunc_(v - floor_(v * (1/256.0f)) * 256.0f); };
+
+    F sum[4] = {0, 0, 0, 0};
+    float ratio = 1;
+    for (int octave = 0; octave < c->octaves; ++octave) {
+        F px = x + 4096.0f,  // kPerlinNoise
+          py = y + 4096.0f;
+        F x0 = floor_(px),
+          y0 = floor_(py),
+          fx = px - x0,
+          fy = py - y0,
+          x1 = x0 + 1,
+          y1 = y0 + 1;
+        if (c->stitching) {
+            const float* s = c->stitching + 4*octave;
+            x0 = if_then_else(x0 >= s[1], x0 - s[0], x0);
+            x1 = if_then_else(x1 >= s[1], x1 - s[0], x1);
+            y0 = if_then_else(y0 >= s[3], y0 - s[2], y0);
+            y1 = if_then_else(y1 >= s[3], y1 - s[2], y1);
+        }
+        U32 i = gather(c->latticeSelector, wrap(x0)),
+            j = gather(c->latticeSelector, wrap(x1)),
+            iy0 = wrap(y0),
+            iy1 = wrap(y1);
+        U32 b00 = (i + iy0) & 255,
+            b10 = (j + iy0) & 255,
+            b01 = (i + iy1) & 255,
+            b11 = (j + iy1) & 255;
+
+        F sx = fx * fx * (3 - 2 * fx),
+          sy = fy * fy * (3 - 2 * fy);
+        // Pathological inputs (e.g. NaN) make no noise.
+        I32 valid = (sx >= 0) & (sx <= 1) & (sy >= 0) & (sy <= 1);
+
+        for (int channel = 0; channel < 4; ++channel) {
+            const float* gx = c->gradientX[channel];
+            const float* gy = c->gradientY[channel];
+            F u = gather(gx, b00) *  fx      + gather(gy, b00) *  fy,
+              v = gather(gx, b10) * (fx - 1) + gather(gy, b10) *  fy;
+            F A = u + (v - u) * sx;
+            v = gather(gx, b11) * (fx - 1) + gather(gy, b11) * (fy - 1);
+            u = gather(gx, b01) *  fx      + gather(gy, b01) * (fy - 1);
+            F B = u + (v - u) * sx;
+            F noise = if_then_else(valid, A + (B - A) * sy, 0);
+            sum[channel] += (c->fractalNoise ? noise : abs_(noise)) * (1 / ratio);
+        }
+        x *= 2;
+        y *= 2;
+        ratio *= 2;
+    }
+
+    for (int channel = 0; channel < 4; ++channel) {
+        if (c->fractalNoise) {
+            sum[channel] = (sum[channel] + 1) * 0.5f;
+        }
+        sum[channel] = min(max(0, sum[channel]), 1);
+    }
+    a = sum[3];
+    r = sum[0] * a;
+    g = sum[1] * a;
+    b = sum[2] * a;
+}
+
 // A specialized fused image shader for clamp-x, clamp-y, non-sRGB sampling.
 STAGE(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     // (cx,cy) are the center of our sample.
@@ -3969,6 +4040,7 @@ STAGE_PP(swizzle, void* ctx) {
     NOT_IMPLEMENTED(rgb_to_hsl)
     NOT_IMPLEMENTED(hsl_to_rgb)
     NOT_IMPLEMENTED(gauss_a_to_rgba)  // TODO
+    NOT_IMPLEMENTED(perlin_noise)
     NOT_IMPLEMENTED(mirror_x)         // TODO
     NOT_IMPLEMENTED(repeat_x)         // TODO
     NOT_IMPLEMENTED(mirror_y)         // TODO
@@ -4,10 +4,12 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
+#include "src/core/SkPathAccel.h"
+#include "src/core/SkPathPriv.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkPathOpsCommon.h"
 
-bool TightBounds(const SkPath& path, SkRect* result) {
+static bool compute_tight_bounds(const SkPath& path, SkRect* result) {
     SkPath::RawIter iter(path);
     SkRect moveBounds = { SK_ScalarMax, SK_ScalarMax, SK_ScalarMin, SK_ScalarMin };
     bool wellBehaved = true;
@@ -72,3 +74,11 @@ bool TightBounds(const SkPath& path, SkRect* result) {
     }
     return true;
 }
+
+bool TightBounds(const SkPath& path, SkRect* result) {
+    if (path.isEmpty()) {
+        return compute_tight_bounds(path, result);
+    }
+    // Computed at most once per path generation.
+    return SkPathPriv::Accel(path)->tightBounds(path, result, compute_tight_bounds);
+}
@@ -11,8 +11,13 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "include/core/SkUnPreMultiply.h"
+#include "include/private/SkOnce.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkColorSpacePriv.h"
+#include "src/core/SkColorSpaceXformSteps.h"
+#include "src/core/SkEffectPriv.h"
 #include "src/core/SkMakeUnique.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
 
@@ -98,21 +103,9 @@ public:
                      SkScalar baseFrequencyX, SkScalar baseFrequencyY,
                      const SkMatrix& matrix)
         {
-            SkVector tileVec;
-            matrix.mapVector(SkIntToScalar(tileSize.fWidth), SkIntToScalar(tileSize.fHeight),
-                             &tileVec);
-
-            SkSize scale;
-            if (!matrix.decomposeScale(&scale, nullptr)) {
-                scale.set(SK_ScalarNearlyZero, SK_ScalarNearlyZero);
-            }
-            fBaseFrequency.set(baseFrequencyX * SkScalarInvert(scale.width()),
-                               baseFrequencyY * SkScalarInvert(scale.height()));
-            fTileSize.set(SkScalarRoundToInt(tileVec.fX), SkScalarRoundToInt(tileVec.fY));
+            fStitchDataInit = DeviceFrequency(tileSize, baseFrequencyX, baseFrequencyY, matrix,
+                                              &fTileSize, &fBaseFrequency);
             this->init(seed);
-            if (!fTileSize.isEmpty()) {
-                this->stitch();
-            }
 
     #if SK_SUPPORT_GPU
             SkImageInfo info = SkImageInfo::MakeA8(kBlockSize, 1);
@@ -150,6 +143,71 @@ public:
     #endif
         }
 
+        // Only the noise tables, which depend on nothing but the seed.
+        explicit PaintingData(SkScalar seed)
+                : fTileSize(SkISize::Make(0, 0))
+                , fBaseFrequency(SkVector::Make(0, 0)) {
+            this->init(seed);
+        }
+
+        // Maps the tile size and base frequency to device space. When stitching, the frequency
+        // is adjusted so that the tile borders will be continuous, and the initial stitch values
+        // are returned.
+        static StitchData DeviceFrequency(const SkISize& tileSize,
+                                          SkScalar baseFrequencyX, SkScalar baseFrequencyY,
+                                          const SkMatrix& matrix,
+                                          SkISize* deviceTileSize, SkVector* baseFrequency) {
+            SkVector tileVec;
+            matrix.mapVector(SkIntToScalar(tileSize.fWidth), SkIntToScalar(tileSize.fHeight),
+                             &tileVec);
+
+            SkSize scale;
+            if (!matrix.decomposeScale(&scale, nullptr)) {
+                scale.set(SK_ScalarNearlyZero, SK_ScalarNearlyZero);
+            }
+            baseFrequency->set(baseFrequencyX * SkScalarInvert(scale.width()),
+                               baseFrequencyY * SkScalarInvert(scale.height()));
+            deviceTileSize->set(SkScalarRoundToInt(tileVec.fX), SkScalarRoundToInt(tileVec.fY));
+            if (deviceTileSize->isEmpty()) {
+                return StitchData();
+            }
+
+            SkScalar tileWidth  = SkIntToScalar(deviceTileSize->width());
+            SkScalar tileHeight = SkIntToScalar(deviceTileSize->height());
+            SkASSERT(tileWidth > 0 && tileHeight > 0);
+            // When stitching tiled turbulence, the frequencies must be adjusted
+            // so that the tile borders will be continuous.
+            if (baseFrequency->fX) {
+                SkScalar lowFrequencx =
+                    SkScalarFloorToScalar(tileWidth * baseFrequency->fX) / tileWidth;
+                SkScalar highFrequencx =
+                    SkScalarCeilToScalar(tileWidth * baseFrequency->fX) / tileWidth;
+                // BaseFrequency should be non-negative according to the standard.
+                // lowFrequencx can be 0 if baseFrequency->fX is very small.
+                if (sk_ieee_float_divide(baseFrequency->fX, lowFrequencx) <
+                        highFrequencx / baseFrequency->fX) {
+                    baseFrequency->fX = lowFrequencx;
+                } else {
+                    baseFrequency->fX = highFrequencx;
+                }
+            }
+            if (baseFrequency->fY) {
+                SkScalar lowFrequency =
+                    SkScalarFloorToScalar(tileHeight * baseFrequency->fY) / tileHeight;
+                SkScalar highFrequency =
+                    SkScalarCeilToScalar(tileHeight * baseFrequency->fY) / tileHeight;
+                // lowFrequency can be 0 if baseFrequency->fY is very small.
+                if (sk_ieee_float_divide(baseFrequency->fY, lowFrequency) <
+                        highFrequency / baseFrequency->fY) {
+                    baseFrequency->fY = lowFrequency;
+                } else {
+                    baseFrequency->fY = highFrequency;
+                }
+            }
+            // Set up TurbulenceInitial stitch values.
+            return StitchData(tileWidth * baseFrequency->fX, tileHeight * baseFrequency->fY);
+        }
+
     #if SK_SUPPORT_GPU
         PaintingData(const PaintingData& that)
                 : fSeed(that.fSeed)
@@ -265,43 +323,6 @@ public:
             }
         }
 
-        // Only called once. Could be part of the constructor.
-        void stitch() {
-            SkScalar tileWidth  = SkIntToScalar(fTileSize.width());
-            SkScalar tileHeight = SkIntToScalar(fTileSize.height());
-            SkASSERT(tileWidth > 0 && tileHeight > 0);
-            // When stitching tiled turbulence, the frequencies must be adjusted
-            // so that the tile borders will be continuous.
-            if (fBaseFrequency.fX) {
-                SkScalar lowFrequencx =
-                    SkScalarFloorToScalar(tileWidth * fBaseFrequency.fX) / tileWidth;
-                SkScalar highFrequencx =
-                    SkScalarCeilToScalar(tileWidth * fBaseFrequency.fX) / tileWidth;
-                // BaseFrequency should be non-negative according to the standard.
-                // lowFrequencx can be 0 if fBaseFrequency.fX is very small.
-                if (sk_ieee_float_divide(fBaseFrequency.fX, lowFrequencx) < highFrequencx / fBaseFrequency.fX) {
-                    fBaseFrequency.fX = lowFrequencx;
-                } else {
-                    fBaseFrequency.fX = highFrequencx;
-                }
-            }
-            if (fBaseFrequency.fY) {
-                SkScalar lowFrequency =
-                    SkScalarFloorToScalar(tileHeight * fBaseFrequency.fY) / tileHeight;
-                SkScalar highFrequency =
-                    SkScalarCeilToScalar(tileHeight * fBaseFrequency.fY) / tileHeight;
-                // lowFrequency can be 0 if fBaseFrequency.fY is very small.
-                if (sk_ieee_float_divide(fBaseFrequency.fY, lowFrequency) < highFrequency / fBaseFrequency.fY) {
-                    fBaseFrequency.fY = lowFrequency;
-                } else {
-                    fBaseFrequency.fY = highFrequency;
-                }
-            }
-            // Set up TurbulenceInitial stitch values.
-            fStitchDataInit = StitchData(tileWidth * fBaseFrequency.fX,
-                                         tileHeight * fBaseFrequency.fY);
-        }
-
     public:
 
 #if SK_SUPPORT_GPU
@@ -343,6 +364,7 @@ public:
                       SkScalar baseFrequencyY, int numOctaves, SkScalar seed,
                       const SkISize* tileSize);
 
+    // Improved noise is computed here; the others have a raster pipeline stage.
     class PerlinNoiseShaderContext : public Context {
     public:
         PerlinNoiseShaderContext(const SkPerlinNoiseShaderImpl& shader, const ContextRec&);
@@ -350,16 +372,30 @@ public:
         void shadeSpan(int x, int y, SkPMColor[], int count) override;
 
     private:
-        SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-                                                  int channel,
-                                                  StitchData& stitchData, const SkPoint& point) const;
+        SkPMColor shade(const SkPoint& point) const;
         SkScalar calculateImprovedNoiseValueForPoint(int channel, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
 
         SkMatrix     fMatrix;
-        PaintingData fPaintingData;
+
+        typedef Context INHERITED;
+    };
+
+    // Shades fractal noise and turbulence spans with the perlin_noise stage, for legacy blitters
+    // and for shaders that wrap a context, like SkLightingShader.
+    class PipelineContext : public Context {
+    public:
+        PipelineContext(const SkPerlinNoiseShaderImpl& shader, const ContextRec& rec,
+                        std::function<void(size_t, size_t, size_t, size_t)> shade,
+                        SkRasterPipeline_MemoryCtx* dst)
+            : INHERITED(shader, rec)
+            , fShade(std::move(shade))
+            , fDst(dst) {}
+
+        void shadeSpan(int x, int y, SkPMColor[], int count) override;
+
+    private:
+        std::function<void(size_t, size_t, size_t, size_t)> fShade;
+        SkRasterPipeline_MemoryCtx*                          fDst;
 
         typedef Context INHERITED;
     };
@@ -373,10 +409,21 @@ protected:
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
     Context* onMakeContext(const ContextRec&, SkArenaAlloc*) const override;
 #endif
+    bool onAppendStages(const SkStageRec&) const override;
 
 private:
     SK_FLATTENABLE_HOOKS(SkPerlinNoiseShaderImpl)
 
+    // PaintingData's lattice selector and gradients, laid out for the perlin_noise stage.
+    struct NoiseTables {
+        uint32_t fLatticeSelector[kBlockSize];
+        float    fGradientX[4][kBlockSize];
+        float    fGradientY[4][kBlockSize];
+    };
+
+    // Built once, on first use, since they depend only on the seed.
+    const NoiseTables& noiseTables() const;
+
     const SkPerlinNoiseShaderImpl::Type fType;
     const SkScalar                  fBaseFrequencyX;
     const SkScalar                  fBaseFrequencyY;
@@ -385,32 +432,14 @@ private:
     const SkISize                   fTileSize;
     const bool                      fStitchTiles;
 
+    mutable SkOnce                       fNoiseTablesOnce;
+    mutable std::unique_ptr<NoiseTables> fNoiseTables;
+
     friend class ::SkPerlinNoiseShader;
 
     typedef SkShaderBase INHERITED;
 };
 
-namespace {
-
-// noiseValue is the color component's value (or color)
-// limitValue is the maximum perlin noise array index value allowed
-// newValue is the current noise dimension (either width or height)
-inline int checkNoise(int noiseValue, int limitValue, int newValue) {
-    // If the noise value would bring us out of bounds of the current noise array while we are
-    // stiching noise tiles together, wrap the noise around the current dimension of the noise to
-    // stay within the array bounds in a continuous fashion (so that tiling lines are not visible)
-    if (noiseValue >= limitValue) {
-        noiseValue -= newValue;
-    }
-    return noiseValue;
-}
-
-inline SkScalar smoothCurve(SkScalar t) {
-    return t * t * (3 - 2 * t);
-}
-
-} // end namespace
-
 SkPerlinNoiseShaderImpl::SkPerlinNoiseShaderImpl(SkPerlinNoiseShaderImpl::Type type,
                                                  SkScalar baseFrequencyX,
                                                  SkScalar baseFrequencyY,
@@ -466,107 +495,6 @@ void SkPerlinNoiseShaderImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
-    struct Noise {
-        int noisePositionIntegerValue;
-        int nextNoisePositionIntegerValue;
-        SkScalar noisePositionFractionValue;
-        Noise(SkScalar component)
-        {
-            SkScalar position = component + kPerlinNoise;
-            noisePositionIntegerValue = SkScalarFloorToInt(position);
-            noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
-            nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
-        }
-    };
-    Noise noiseX(noiseVector.x());
-    Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
-    // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
-        noiseX.noisePositionIntegerValue =
-            checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.noisePositionIntegerValue =
-            checkNoise(noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-        noiseX.nextNoisePositionIntegerValue =
-            checkNoise(noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.nextNoisePositionIntegerValue =
-            checkNoise(noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-    }
-    noiseX.noisePositionIntegerValue &= kBlockMask;
-    noiseY.noisePositionIntegerValue &= kBlockMask;
-    noiseX.nextNoisePositionIntegerValue &= kBlockMask;
-    noiseY.nextNoisePositionIntegerValue &= kBlockMask;
-    int i = fPaintingData.fLatticeSelector[noiseX.noisePositionIntegerValue];
-    int j = fPaintingData.fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
-    int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
-
-    if (sx < 0 || sy < 0 || sx > 1 || sy > 1) {
-        return 0;  // Check for pathological inputs.
-    }
-
-    // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData.fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData.fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData.fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData.fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
-}
-
-SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
-    if (perlinNoiseShader.fStitchTiles) {
-        // Set up TurbulenceInitial stitch values.
-        stitchData = fPaintingData.fStitchDataInit;
-    }
-    SkScalar turbulenceFunctionResult = 0;
-    SkPoint noiseVector(SkPoint::Make(point.x() * fPaintingData.fBaseFrequency.fX,
-                                      point.y() * fPaintingData.fBaseFrequency.fY));
-    SkScalar ratio = SK_Scalar1;
-    for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        SkScalar numer = (perlinNoiseShader.fType == kFractalNoise_Type) ?
-                            noise : SkScalarAbs(noise);
-        turbulenceFunctionResult += numer / ratio;
-        noiseVector.fX *= 2;
-        noiseVector.fY *= 2;
-        ratio *= 2;
-        if (perlinNoiseShader.fStitchTiles) {
-            // Update stitch values
-            stitchData = StitchData(SkIntToScalar(stitchData.fWidth)  * 2,
-                                    SkIntToScalar(stitchData.fHeight) * 2);
-        }
-    }
-
-    // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
-    // by fractalNoise and (turbulenceFunctionResult) by turbulence.
-    if (perlinNoiseShader.fType == kFractalNoise_Type) {
-        turbulenceFunctionResult = SkScalarHalf(turbulenceFunctionResult + 1);
-    }
-
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult *= SkIntToScalar(getPaintAlpha()) / 255;
-    }
-
-    // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
-}
-
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Improved Perlin Noise based on Java implementation found at http://mrl.nyu.edu/~perlin/noise/
 static SkScalar fade(SkScalar t) {
@@ -629,9 +557,7 @@ SkScalar SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::calculateImprovedNoi
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
-    const SkPerlinNoiseShaderImpl& perlinNoiseShader = static_cast<const SkPerlinNoiseShaderImpl&>(fShader);
+SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(const SkPoint& point) const {
     SkPoint newPoint;
     fMatrix.mapPoints(&newPoint, &point, 1);
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
@@ -639,13 +565,7 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
 
     U8CPU rgba[4];
     for (int channel = 3; channel >= 0; --channel) {
-        SkScalar value;
-        if (perlinNoiseShader.fType == kImprovedNoise_Type) {
-            value = calculateImprovedNoiseValueForPoint(channel, newPoint);
-        }
-        else {
-            value = calculateTurbulenceValueForPoint(channel, stitchData, newPoint);
-        }
+        SkScalar value = calculateImprovedNoiseValueForPoint(channel, newPoint);
         rgba[channel] = SkScalarFloorToInt(255 * value);
     }
     return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
@@ -654,6 +574,23 @@ SkPMColor SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shade(
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
 SkShaderBase::Context* SkPerlinNoiseShaderImpl::onMakeContext(const ContextRec& rec,
                                                               SkArenaAlloc* alloc) const {
+    if (kImprovedNoise_Type != fType) {
+        auto pipeline = alloc->make<SkRasterPipeline>(alloc);
+        SkStageRec stageRec = {pipeline, alloc, rec.fDstColorType, sk_srgb_singleton(),
+                               *rec.fPaint, rec.fLocalMatrix, *rec.fMatrix};
+        if (!this->onAppendStages(stageRec)) {
+            return nullptr;
+        }
+        // Shader contexts apply the paint's alpha themselves.
+        if (rec.fPaint->getAlpha() != SK_AlphaOPAQUE) {
+            pipeline->append(SkRasterPipeline::scale_1_float,
+                             alloc->make<float>(rec.fPaint->getAlphaf()));
+        }
+        // shadeSpan() points this at its span, so it is addressed by x alone.
+        auto dst = alloc->make<SkRasterPipeline_MemoryCtx>();
+        pipeline->append_store(kN32_SkColorType, dst);
+        return alloc->make<PipelineContext>(*this, rec, pipeline->compile(), dst);
+    }
     // should we pay attention to rec's device-colorspace?
     return alloc->make<PerlinNoiseShaderContext>(*this, rec);
 }
@@ -673,8 +610,6 @@ SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
         const SkPerlinNoiseShaderImpl& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
     , fMatrix(total_matrix(rec, shader)) // used for temp storage, adjusted below
-    , fPaintingData(shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX,
-                    shader.fBaseFrequencyY, fMatrix)
 {
     // This (1,1) translation is due to WebKit's 1 based coordinates for the noise
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
@@ -685,13 +620,91 @@ SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
 void SkPerlinNoiseShaderImpl::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
     for (int i = 0; i < count; ++i) {
-        result[i] = shade(point, stitchData);
+        result[i] = shade(point);
         point.fX += SK_Scalar1;
     }
 }
 
+void SkPerlinNoiseShaderImpl::PipelineContext::shadeSpan(int x, int y, SkPMColor result[],
+                                                          int count) {
+    fDst->pixels = result - x;
+    fShade(x, y, count, 1);
+}
+
+const SkPerlinNoiseShaderImpl::NoiseTables& SkPerlinNoiseShaderImpl::noiseTables() const {
+    fNoiseTablesOnce([this] {
+        PaintingData paintingData(fSeed);
+        auto tables = skstd::make_unique<NoiseTables>();
+        for (int i = 0; i < kBlockSize; ++i) {
+            tables->fLatticeSelector[i] = paintingData.fLatticeSelector[i];
+            for (int channel = 0; channel < 4; ++channel) {
+                tables->fGradientX[channel][i] = paintingData.fGradient[channel][i].fX;
+                tables->fGradientY[channel][i] = paintingData.fGradient[channel][i].fY;
+            }
+        }
+        fNoiseTables = std::move(tables);
+    });
+    return *fNoiseTables;
+}
+
+bool SkPerlinNoiseShaderImpl::onAppendStages(const SkStageRec& rec) const {
+    if (kImprovedNoise_Type == fType) {
+        return INHERITED::onAppendStages(rec);
+    }
+
+    // Like the shader context this replaces, draw nothing for perspective or singular matrices.
+    SkMatrix matrix = SkMatrix::Concat(rec.fCTM, this->getLocalMatrix());
+    if (rec.fLocalM) {
+        matrix.preConcat(*rec.fLocalM);
+    }
+    if (matrix.hasPerspective() || !matrix.invert(nullptr)) {
+        return false;
+    }
+
+    const NoiseTables& tables = this->noiseTables();
+    auto ctx = rec.fAlloc->make<SkRasterPipeline_PerlinNoiseCtx>();
+    ctx->latticeSelector = tables.fLatticeSelector;
+    for (int channel = 0; channel < 4; ++channel) {
+        ctx->gradientX[channel] = tables.fGradientX[channel];
+        ctx->gradientY[channel] = tables.fGradientY[channel];
+    }
+
+    SkISize tileSize;
+    SkVector baseFrequency;
+    StitchData stitchData = PaintingData::DeviceFrequency(fTileSize, fBaseFrequencyX,
+                                                          fBaseFrequencyY, matrix,
+                                                          &tileSize, &baseFrequency);
+    ctx->stitching = nullptr;
+    if (fStitchTiles) {
+        float* stitching = rec.fAlloc->makeArrayDefault<float>(4 * fNumOctaves);
+        for (int octave = 0; octave < fNumOctaves; ++octave) {
+            stitching[4 * octave + 0] = stitchData.fWidth;
+            stitching[4 * octave + 1] = stitchData.fWrapX;
+            stitching[4 * octave + 2] = stitchData.fHeight;
+            stitching[4 * octave + 3] = stitchData.fWrapY;
+            stitchData = StitchData(SkIntToScalar(stitchData.fWidth)  * 2,
+                                    SkIntToScalar(stitchData.fHeight) * 2);
+        }
+        ctx->stitching = stitching;
+    }
+    ctx->baseFrequencyX = baseFrequency.fX;
+    ctx->baseFrequencyY = baseFrequency.fY;
+    // This (1,1) translation is due to WebKit's 1 based coordinates for the noise
+    // (as opposed to 0 based, usually).
+    ctx->offsetX = -matrix.getTranslateX() + SK_Scalar1;
+    ctx->offsetY = -matrix.getTranslateY() + SK_Scalar1;
+    ctx->octaves = fNumOctaves;
+    ctx->fractalNoise = kFractalNoise_Type == fType;
+
+    rec.fPipeline->append(SkRasterPipeline::seed_shader);
+    rec.fPipeline->append(SkRasterPipeline::perlin_noise, ctx);
+    rec.fAlloc->make<SkColorSpaceXformSteps>(sk_srgb_singleton(), kPremul_SkAlphaType,
+                                             rec.fDstCS,          kPremul_SkAlphaType)
+        ->apply(rec.fPipeline, true);
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
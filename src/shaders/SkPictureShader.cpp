@@ -9,15 +9,25 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTArray.h"
 #include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBitmapCache.h"
 #include "src/core/SkMatrixUtils.h"
+#include "src/core/SkMipMap.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkResourceCache.h"
+#include "src/image/SkImage_Base.h"
 #include "src/shaders/SkBitmapProcShader.h"
 #include "src/shaders/SkImageShader.h"
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+
+std::atomic<SkExecutor*> gSkPictureShaderTileExecutor{nullptr};
 
 #if SK_SUPPORT_GPU
 #include "include/private/GrRecordingContext.h"
@@ -43,13 +53,16 @@ sk_sp<SkShader> SkPicture::makeShader(SkTileMode tmx, SkTileMode tmy,
 
 namespace {
 static unsigned gBitmapShaderKeyNamespaceLabel;
+// Tiles cached by their power-of-two scale level, rather than their exact scale.
+static unsigned gBitmapShaderLevelKeyNamespaceLabel;
 
 struct BitmapShaderKey : public SkResourceCache::Key {
 public:
     BitmapShaderKey(SkColorSpace* colorSpace,
                     SkImage::BitDepth bitDepth,
                     uint32_t shaderID,
-                    const SkSize& scale)
+                    const SkSize& scale,
+                    void* nameSpace = &gBitmapShaderKeyNamespaceLabel)
         : fColorSpaceXYZHash(colorSpace->toXYZD50Hash())
         , fColorSpaceTransferFnHash(colorSpace->transferFnHash())
         , fBitDepth(bitDepth)
@@ -61,7 +74,7 @@ public:
                                       sizeof(fScale);
         // This better be packed.
         SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - &fColorSpaceXYZHash) == keySize);
-        this->init(&gBitmapShaderKeyNamespaceLabel, MakeSharedID(shaderID), keySize);
+        this->init(nameSpace, MakeSharedID(shaderID), keySize);
     }
 
     static uint64_t MakeSharedID(uint32_t shaderID) {
@@ -78,34 +91,77 @@ private:
     SkDEBUGCODE(uint32_t fEndOfStruct;)
 };
 
+// A tile shader, and the scale its tile was rasterized at.
+struct CachedTile {
+    sk_sp<SkShader> fShader;
+    SkSize          fScale;
+};
+
 struct BitmapShaderRec : public SkResourceCache::Rec {
-    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader)
+    BitmapShaderRec(const BitmapShaderKey& key, SkShader* tileShader, const SkSize& tileScale,
+                    size_t pixelBytes = 0)
         : fKey(key)
-        , fShader(SkRef(tileShader)) {}
+        , fShader(SkRef(tileShader))
+        , fTileScale(tileScale)
+        , fPixelBytes(pixelBytes) {}
 
     BitmapShaderKey fKey;
     sk_sp<SkShader> fShader;
+    SkSize          fTileScale;
+    size_t          fPixelBytes;
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override {
-        // Just the record overhead -- the actual pixels are accounted by SkImage_Lazy.
-        return sizeof(fKey) + sizeof(SkImageShader);
+        // The record overhead, and the pixels of tiles rasterized up front. The pixels of lazy
+        // tiles are accounted by SkImage_Lazy.
+        return sizeof(fKey) + sizeof(SkImageShader) + fPixelBytes;
     }
     const char* getCategory() const override { return "bitmap-shader"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
 
-    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextShader) {
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextTile) {
         const BitmapShaderRec& rec = static_cast<const BitmapShaderRec&>(baseRec);
-        sk_sp<SkShader>* result = reinterpret_cast<sk_sp<SkShader>*>(contextShader);
+        CachedTile* result = reinterpret_cast<CachedTile*>(contextTile);
 
-        *result = rec.fShader;
+        result->fShader = rec.fShader;
+        result->fScale  = rec.fTileScale;
 
-        // The bitmap shader is backed by an image generator, thus it can always re-generate its
-        // pixels if discarded.
+        // The bitmap shader is backed by an image generator or by its own pixels, thus it can
+        // always re-generate its pixels if discarded.
         return true;
     }
 };
 
+// The power-of-two level a tile scale falls in, offset by some levels, as a key scale.
+SkSize tile_level(const SkSize& scale, int offset) {
+    return SkSize::Make(std::ceil(std::log2(scale.width()))  + offset,
+                        std::ceil(std::log2(scale.height())) + offset);
+}
+
+sk_sp<SkImage> make_tile_image(sk_sp<SkPicture> picture, const SkRect& tile,
+                               const SkISize& tileSize, SkImage::BitDepth bitDepth,
+                               sk_sp<SkColorSpace> colorSpace) {
+    SkMatrix tileMatrix;
+    tileMatrix.setRectToRect(tile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+                             SkMatrix::kFill_ScaleToFit);
+    return SkImage::MakeFromPicture(std::move(picture), tileSize, &tileMatrix, nullptr, bitDepth,
+                                    std::move(colorSpace));
+}
+
+bool find_nearest_level(SkColorSpace* colorSpace, SkImage::BitDepth bitDepth, uint32_t shaderID,
+                        const SkSize& tileScale, CachedTile* tile) {
+    // Prefer scaling a finer tile down to scaling a coarser one up.
+    for (int offset : {0, 1, -1, 2, -2}) {
+        const BitmapShaderKey levelKey(colorSpace, bitDepth, shaderID,
+                                       tile_level(tileScale, offset),
+                                       &gBitmapShaderLevelKeyNamespaceLabel);
+        if (SkResourceCache::Find(levelKey, BitmapShaderRec::Visitor, tile)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 uint32_t next_id() {
     static std::atomic<uint32_t> nextID{1};
 
@@ -118,6 +174,15 @@ uint32_t next_id() {
 
 } // namespace
 
+// The exact scale tiles of a shader being rasterized on gSkPictureShaderTileExecutor. The tasks
+// share this with the shader, so they only cache their tiles while it is alive to purge them.
+struct SkPictureShader::TileTasks : public SkNVRefCnt<TileTasks> {
+    SkMutex                   fMutex;
+    bool                      fShaderAlive = true;
+    bool                      fAddedToCache = false;
+    SkTArray<BitmapShaderKey> fPending;
+};
+
 SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, SkTileMode tmx, SkTileMode tmy,
                                  const SkMatrix* localMatrix, const SkRect* tile)
     : INHERITED(localMatrix)
@@ -129,7 +194,13 @@ SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, SkTileMode tmx, SkTil
     , fAddedToCache(false) {}
 
 SkPictureShader::~SkPictureShader() {
-    if (fAddedToCache.load()) {
+    bool addedToCache = fAddedToCache.load();
+    if (fTileTasks) {
+        SkAutoMutexExclusive lock(fTileTasks->fMutex);
+        fTileTasks->fShaderAlive = false;
+        addedToCache |= fTileTasks->fAddedToCache;
+    }
+    if (addedToCache) {
         SkResourceCache::PostPurgeSharedID(BitmapShaderKey::MakeSharedID(fUniqueID));
     }
 }
@@ -245,29 +316,84 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix,
 
     BitmapShaderKey key(imgCS.get(), bitDepth, fUniqueID, tileScale);
 
-    sk_sp<SkShader> tileShader;
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkMatrix tileMatrix;
-        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
-                                 SkMatrix::kFill_ScaleToFit);
-
-        sk_sp<SkImage> tileImage = SkImage::MakeFromPicture(fPicture, tileSize, &tileMatrix,
-                                                            nullptr, bitDepth, std::move(imgCS));
-        if (!tileImage) {
-            return nullptr;
+    CachedTile tile;
+    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tile)) {
+        SkExecutor* executor = gSkPictureShaderTileExecutor.load(std::memory_order_relaxed);
+        const BitmapShaderKey levelKey(imgCS.get(), bitDepth, fUniqueID,
+                                       tile_level(tileScale, 0),
+                                       &gBitmapShaderLevelKeyNamespaceLabel);
+
+        if (executor && find_nearest_level(imgCS.get(), bitDepth, fUniqueID, tileScale, &tile)) {
+            // Draw with the nearest level for now, and rasterize this scale in the background.
+            fTileTasksOnce([this] { fTileTasks = sk_make_sp<TileTasks>(); });
+            bool pending;
+            {
+                SkAutoMutexExclusive lock(fTileTasks->fMutex);
+                pending = std::find(fTileTasks->fPending.begin(), fTileTasks->fPending.end(),
+                                    key) != fTileTasks->fPending.end();
+                if (!pending) {
+                    fTileTasks->fPending.push_back(key);
+                }
+            }
+            if (!pending) {
+                executor->add([tasks = fTileTasks, picture = fPicture, pictureTile = fTile,
+                               tmx = fTmx, tmy = fTmy, key, levelKey, tileSize, tileScale,
+                               bitDepth, imgCS] {
+                    // Rasterize the tile and build its mips here, so that draws never have to.
+                    sk_sp<SkImage> tileImage = make_tile_image(picture, pictureTile, tileSize,
+                                                               bitDepth, imgCS);
+                    if (tileImage) {
+                        tileImage = tileImage->makeRasterImage();
+                    }
+                    if (tileImage) {
+                        SkSafeUnref(SkMipMapCache::AddAndRef(as_IB(tileImage.get())));
+                    }
+
+                    bool shaderAlive;
+                    {
+                        SkAutoMutexExclusive lock(tasks->fMutex);
+                        auto& pendingKeys = tasks->fPending;
+                        pendingKeys.removeShuffle(SkToInt(
+                                std::find(pendingKeys.begin(), pendingKeys.end(), key) -
+                                pendingKeys.begin()));
+                        shaderAlive = tasks->fShaderAlive;
+                        tasks->fAddedToCache |= tileImage && shaderAlive;
+                    }
+                    // Add outside the lock: purging the cache can destroy picture shaders.
+                    if (tileImage && shaderAlive) {
+                        sk_sp<SkShader> tileShader = tileImage->makeShader(tmx, tmy);
+                        const size_t pixelBytes = tileImage->imageInfo().computeMinByteSize();
+                        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get(),
+                                                                 tileScale, pixelBytes));
+                        SkResourceCache::Add(new BitmapShaderRec(levelKey, tileShader.get(),
+                                                                 tileScale, pixelBytes));
+                    }
+                });
+                // An executor that runs work right away has cached the exact tile already.
+                SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tile);
+            }
+        } else {
+            sk_sp<SkImage> tileImage = make_tile_image(fPicture, fTile, tileSize, bitDepth,
+                                                       std::move(imgCS));
+            if (!tileImage) {
+                return nullptr;
+            }
+
+            tile = {tileImage->makeShader(fTmx, fTmy), tileScale};
+
+            SkResourceCache::Add(new BitmapShaderRec(key, tile.fShader.get(), tileScale));
+            if (executor) {
+                SkResourceCache::Add(new BitmapShaderRec(levelKey, tile.fShader.get(), tileScale));
+            }
+            fAddedToCache.store(true);
         }
-
-        tileShader = tileImage->makeShader(fTmx, fTmy);
-
-        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get()));
-        fAddedToCache.store(true);
     }
 
-    if (tileScale.width() != 1 || tileScale.height() != 1) {
-        localMatrix->writable()->preScale(1 / tileScale.width(), 1 / tileScale.height());
+    if (tile.fScale.width() != 1 || tile.fScale.height() != 1) {
+        localMatrix->writable()->preScale(1 / tile.fScale.width(), 1 / tile.fScale.height());
     }
 
-    return tileShader;
+    return tile.fShader;
 }
 
 bool SkPictureShader::onAppendStages(const SkStageRec& rec) const {
@@ -9,13 +9,18 @@
 #define SkPictureShader_DEFINED
 
 #include "include/core/SkTileMode.h"
+#include "include/private/SkOnce.h"
 #include "src/shaders/SkShaderBase.h"
 #include <atomic>
 
 class SkArenaAlloc;
 class SkBitmap;
+class SkExecutor;
 class SkPicture;
 
+// Set by SkGraphics::SetPictureShaderTileExecutor(); null by default.
+extern std::atomic<SkExecutor*> gSkPictureShaderTileExecutor;
+
 /*
  * An SkPictureShader can be used to draw SkPicture-based patterns.
  *
@@ -75,6 +80,11 @@ private:
     const uint32_t            fUniqueID;
     mutable std::atomic<bool> fAddedToCache;
 
+    // Tiles being rasterized on gSkPictureShaderTileExecutor, created on first use.
+    struct TileTasks;
+    mutable SkOnce            fTileTasksOnce;
+    mutable sk_sp<TileTasks>  fTileTasks;
+
     typedef SkShaderBase INHERITED;
 };
 
@@ -7,9 +7,11 @@
 
 #include "include/core/SkPathMeasure.h"
 #include "include/core/SkStrokeRec.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
 #include "src/utils/SkDashPathPriv.h"
 
+#include <functional>
 #include <utility>
 
 static inline int is_even(int x) {
@@ -226,7 +228,7 @@ static bool cull_path(const SkPath& srcPath, const SkStrokeRec& rec,
 class SpecialLineRec {
 public:
     bool init(const SkPath& src, SkPath* dst, SkStrokeRec* rec,
-              int intervalCount, SkScalar intervalLength) {
+              int intervalCount, SkScalar intervalLength, SkScalar maxSegments) {
         if (rec->isHairlineStyle() || !src.isLine(fPts)) {
             return false;
         }
@@ -253,7 +255,7 @@ public:
         //     resulting points = 4 * segments
 
         SkScalar ptCount = pathLength * intervalCount / (float)intervalLength;
-        ptCount = SkTMin(ptCount, SkDashPath::kMaxDashCount);
+        ptCount = SkTMin(ptCount, maxSegments);
         int n = SkScalarCeilToInt(ptCount) << 2;
         dst->incReserve(n);
 
@@ -291,11 +293,15 @@ private:
 };
 
 
-bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
-                                const SkRect* cullRect, const SkScalar aIntervals[],
-                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
-                                SkScalar intervalLength,
-                                StrokeRecApplication strokeRecApplication) {
+// Does the work of InternalFilter() and StreamDashPath(). Without a sink, every dash is added to
+// dst. With one, dst is handed to the sink and rewound whenever it holds kStreamBatchCount dashes
+// and another is about to start, and once more at the end if it isn't empty.
+static bool dash_path(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                      const SkRect* cullRect, const SkScalar aIntervals[],
+                      int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
+                      SkScalar intervalLength,
+                      SkDashPath::StrokeRecApplication strokeRecApplication,
+                      const std::function<void(const SkPath&)>* sink) {
     // we must always have an even number of intervals
     SkASSERT(is_even(count));
 
@@ -361,8 +367,19 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     }
 
     SpecialLineRec lineRec;
-    bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
-                       lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
+    bool specialLine = (SkDashPath::StrokeRecApplication::kAllow == strokeRecApplication) &&
+                       lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength,
+                                    sink ? SkDashPath::kStreamBatchCount
+                                         : SkDashPath::kMaxDashCount);
+    int batchCount = 0;
+    auto flushBatch = [&]() {
+        if (batchCount > 1) {
+            dst->setConvexity(SkPath::kConcave_Convexity);
+        }
+        (*sink)(*dst);
+        dst->rewind();
+        batchCount = 0;
+    };
 
     SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
 
@@ -381,7 +398,9 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
         dashCount += length * (count >> 1) / intervalLength;
-        if (dashCount > kMaxDashCount) {
+        if (dashCount > SkDashPath::kMaxDashCount) {
+            // StreamDashPath() checks this up front, as it can't take back what it has streamed.
+            SkASSERT(!sink);
             dst->reset();
             return false;
         }
@@ -395,8 +414,12 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
             SkASSERT(dlen >= 0);
             addedSegment = false;
             if (is_even(index) && !skipFirstSegment) {
+                if (sink && batchCount >= SkDashPath::kStreamBatchCount) {
+                    flushBatch();
+                }
                 addedSegment = true;
                 ++segCount;
+                ++batchCount;
 
                 if (specialLine) {
                     lineRec.addSegment(SkDoubleToScalar(distance),
@@ -427,11 +450,24 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
         if (meas.isClosed() && is_even(initialDashIndex) &&
             initialDashLength >= 0) {
+            // When addedSegment is set this extends the last dash, so it must land in the same
+            // batch as that dash; the sink only ever flushes before a new dash is started.
+            if (sink && !addedSegment && batchCount >= SkDashPath::kStreamBatchCount) {
+                flushBatch();
+            }
             meas.getSegment(0, initialDashLength, dst, !addedSegment);
             ++segCount;
+            ++batchCount;
         }
     } while (meas.nextContour());
 
+    if (sink) {
+        if (!dst->isEmpty()) {
+            flushBatch();
+        }
+        return true;
+    }
+
     if (segCount > 1) {
         dst->setConvexity(SkPath::kConcave_Convexity);
     }
@@ -439,6 +475,73 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     return true;
 }
 
+bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                                const SkRect* cullRect, const SkScalar aIntervals[],
+                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
+                                SkScalar intervalLength,
+                                StrokeRecApplication strokeRecApplication) {
+    return dash_path(dst, src, rec, cullRect, aIntervals, count, initialDashLength,
+                     initialDashIndex, intervalLength, strokeRecApplication, nullptr);
+}
+
+// The length of a contour never exceeds that of its control polygon (closing line included), so
+// this bounds the total length SkPathMeasure will report for the path without measuring it.
+static SkScalar control_polygon_length(const SkPath& path) {
+    SkScalar length = 0;
+    SkPath::RawIter iter(path);
+    SkPath::Verb verb;
+    SkPoint pts[4];
+    SkPoint moveTo = {0, 0},
+            lastPt = {0, 0};
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                moveTo = lastPt = pts[0];
+                break;
+            case SkPath::kClose_Verb:
+                length += SkPoint::Distance(lastPt, moveTo);
+                lastPt = moveTo;
+                break;
+            default: {
+                int n = SkPathPriv::PtsInIter(verb);
+                for (int i = 1; i < n; ++i) {
+                    length += SkPoint::Distance(pts[i - 1], pts[i]);
+                }
+                lastPt = pts[n - 1];
+            } break;
+        }
+    }
+    return length;
+}
+
+bool SkDashPath::StreamDashPath(const SkPath& src, SkStrokeRec* rec, const SkRect* cullRect,
+                                const SkPathEffect::DashInfo& info,
+                                const std::function<void(const SkPath&)>& sink) {
+    if (!ValidDashPath(info.fPhase, info.fIntervals, info.fCount)) {
+        return false;
+    }
+    SkScalar initialDashLength = 0;
+    int32_t initialDashIndex = 0;
+    SkScalar intervalLength = 0;
+    CalcDashParameters(info.fPhase, info.fIntervals, info.fCount,
+                       &initialDashLength, &initialDashIndex, &intervalLength);
+
+    // InternalFilter() gives up (and the path is drawn undashed) past kMaxDashCount dashes. We
+    // can't find that out part way through, having already streamed some of them, so leave any
+    // path that might get there to InternalFilter(). The headroom covers the tiny join that
+    // dashing a closed rect may add.
+    SkScalar dashBound = control_polygon_length(src) * (info.fCount >> 1) / intervalLength;
+    if (!SkScalarIsFinite(dashBound) || dashBound * 1.01f > kMaxDashCount) {
+        return false;
+    }
+
+    SkPath batch;
+    batch.setIsVolatile(true);
+    return dash_path(&batch, src, rec, cullRect, info.fIntervals, info.fCount,
+                     initialDashLength, initialDashIndex, intervalLength,
+                     StrokeRecApplication::kAllow, &sink);
+}
+
 bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
                                 const SkRect* cullRect, const SkPathEffect::DashInfo& info) {
     if (!ValidDashPath(info.fPhase, info.fIntervals, info.fCount)) {
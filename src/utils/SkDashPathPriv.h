@@ -10,6 +10,8 @@
 
 #include "include/core/SkPathEffect.h"
 
+#include <functional>
+
 namespace SkDashPath {
     /**
      * Calculates the initialDashLength, initialDashIndex, and intervalLength based on the
@@ -46,6 +48,23 @@ namespace SkDashPath {
                         SkScalar intervalLength,
                         StrokeRecApplication = StrokeRecApplication::kAllow);
 
+    /** The most dashes StreamDashPath() hands to its sink at once. */
+    const int kStreamBatchCount = 256;
+
+    /**
+     * Dashes src as FilterDashPath() would, but rather than accumulating every dash in one path,
+     * hands them to sink in order, in batches of at most kStreamBatchCount dashes. No dash is
+     * split between batches, and the path passed to sink is reused for the next batch. As with
+     * FilterDashPath(), rec may be changed (to fill style) before the first batch.
+     *
+     * Returns false, without calling sink, if info is invalid or the path might produce so many
+     * dashes that FilterDashPath() would give up on it; the caller should then fall back to
+     * FilterDashPath().
+     */
+    bool StreamDashPath(const SkPath& src, SkStrokeRec* rec, const SkRect* cullRect,
+                        const SkPathEffect::DashInfo& info,
+                        const std::function<void(const SkPath&)>& sink);
+
     bool ValidDashPath(SkScalar phase, const SkScalar intervals[], int32_t count);
 }
 
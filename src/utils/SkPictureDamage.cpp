@@ -0,0 +1,248 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkPictureDamage.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRegion.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecords.h"
+
+#include <string.h>
+
+namespace {
+
+using namespace SkRecords;
+
+template <typename T>
+bool same_optional(const Optional<T>& a, const Optional<T>& b) {
+    return a == b || (a && b && *a == *b);
+}
+
+template <typename T>
+bool same_array(const T* a, const T* b, int count) {
+    return a == b || (a && b && 0 == memcmp(a, b, count * sizeof(T)));
+}
+
+// Ops are the same if they draw the same way in the same state. Any op not listed differs.
+template <typename T>
+bool same(const T&, const T&) { return false; }
+
+bool same(const NoOp&, const NoOp&) { return true; }
+bool same(const Save&, const Save&) { return true; }
+bool same(const Restore& a, const Restore& b) { return a.matrix == b.matrix; }
+bool same(const SaveLayer& a, const SaveLayer& b) {
+    return same_optional(a.bounds, b.bounds) && same_optional(a.paint, b.paint) &&
+           a.backdrop == b.backdrop && a.clipMask == b.clipMask &&
+           same_optional(a.clipMatrix, b.clipMatrix) && a.saveLayerFlags == b.saveLayerFlags;
+}
+bool same(const SetMatrix& a, const SetMatrix& b) { return a.matrix == b.matrix; }
+bool same(const Concat& a, const Concat& b) { return a.matrix == b.matrix; }
+bool same(const Translate& a, const Translate& b) { return a.dx == b.dx && a.dy == b.dy; }
+
+bool same(const ClipOpAndAA& a, const ClipOpAndAA& b) {
+    return a.op() == b.op() && a.aa() == b.aa();
+}
+bool same(const ClipPath& a, const ClipPath& b) {
+    return a.path == b.path && same(a.opAA, b.opAA);
+}
+bool same(const ClipRRect& a, const ClipRRect& b) {
+    return a.rrect == b.rrect && same(a.opAA, b.opAA);
+}
+bool same(const ClipRect& a, const ClipRect& b) {
+    return a.rect == b.rect && same(a.opAA, b.opAA);
+}
+bool same(const ClipRegion& a, const ClipRegion& b) {
+    return a.region == b.region && a.op == b.op;
+}
+
+bool same(const DrawArc& a, const DrawArc& b) {
+    return a.paint == b.paint && a.oval == b.oval && a.startAngle == b.startAngle &&
+           a.sweepAngle == b.sweepAngle && a.useCenter == b.useCenter;
+}
+bool same(const DrawDRRect& a, const DrawDRRect& b) {
+    return a.paint == b.paint && a.outer == b.outer && a.inner == b.inner;
+}
+bool same(const DrawImage& a, const DrawImage& b) {
+    return same_optional(a.paint, b.paint) && a.image == b.image &&
+           a.left == b.left && a.top == b.top;
+}
+bool same(const DrawImageRect& a, const DrawImageRect& b) {
+    return same_optional(a.paint, b.paint) && a.image == b.image &&
+           same_optional(a.src, b.src) && a.dst == b.dst && a.constraint == b.constraint;
+}
+bool same(const DrawImageNine& a, const DrawImageNine& b) {
+    return same_optional(a.paint, b.paint) && a.image == b.image &&
+           a.center == b.center && a.dst == b.dst;
+}
+bool same(const DrawOval& a, const DrawOval& b) {
+    return a.paint == b.paint && a.oval == b.oval;
+}
+bool same(const DrawPaint& a, const DrawPaint& b) { return a.paint == b.paint; }
+bool same(const DrawPath& a, const DrawPath& b) {
+    return a.paint == b.paint && a.path == b.path;
+}
+bool same(const DrawPicture& a, const DrawPicture& b) {
+    return same_optional(a.paint, b.paint) && a.picture == b.picture && a.matrix == b.matrix;
+}
+bool same(const DrawPoints& a, const DrawPoints& b) {
+    return a.paint == b.paint && a.mode == b.mode && a.count == b.count &&
+           same_array(a.pts, b.pts, a.count);
+}
+bool same(const DrawRRect& a, const DrawRRect& b) {
+    return a.paint == b.paint && a.rrect == b.rrect;
+}
+bool same(const DrawRect& a, const DrawRect& b) {
+    return a.paint == b.paint && a.rect == b.rect;
+}
+bool same(const DrawRegion& a, const DrawRegion& b) {
+    return a.paint == b.paint && a.region == b.region;
+}
+bool same(const DrawTextBlob& a, const DrawTextBlob& b) {
+    return a.paint == b.paint && a.blob == b.blob && a.x == b.x && a.y == b.y;
+}
+bool same(const DrawVertices& a, const DrawVertices& b) {
+    return a.paint == b.paint && a.vertices == b.vertices && a.boneCount == b.boneCount &&
+           same_array<SkVertices::Bone>(a.bones, b.bones, a.boneCount) &&
+           a.bmode == b.bmode;
+}
+
+// Compares an op of one record with an op of another, of any types.
+class OpComparer {
+public:
+    OpComparer(const SkRecord& other, int otherIndex) : fOther(other), fIndex(otherIndex) {}
+
+    template <typename T>
+    bool operator()(const T& op) {
+        return fOther.visit(fIndex, [&op](const auto& other) { return compare(op, other); });
+    }
+
+private:
+    template <typename T, typename U>
+    static bool compare(const T&, const U&) { return false; }
+
+    template <typename T>
+    static bool compare(const T& a, const T& b) { return same(a, b); }
+
+    const SkRecord& fOther;
+    int             fIndex;
+};
+
+// The ops of a picture and their bounds, if it has an SkRecord.
+struct PictureOps {
+    explicit PictureOps(const SkPicture& picture) {
+        if (const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(sk_ref_sp(&picture))) {
+            fRecord = big->record();
+            fBounds.reset(fRecord->count());
+            SkRecordFillBounds(picture.cullRect(), *fRecord, fBounds);
+        }
+    }
+
+    int count() const { return fRecord ? fRecord->count() : 0; }
+
+    const SkRecord*       fRecord = nullptr;
+    SkAutoTMalloc<SkRect> fBounds;
+};
+
+bool same_op(const PictureOps& a, int i, const PictureOps& b, int j) {
+    return a.fBounds[i] == b.fBounds[j] && a.fRecord->visit(i, OpComparer(*b.fRecord, j));
+}
+
+void add_rect(const SkRect& rect, SkRegion* damage) {
+    SkIRect pixels;
+    rect.roundOut(&pixels);
+    if (!pixels.isEmpty()) {
+        damage->op(pixels, SkRegion::kUnion_Op);
+    }
+}
+
+}  // namespace
+
+void SkPictureDamage::Compute(const SkPicture& before, const SkPicture& after, SkRegion* damage,
+                              int maxRects) {
+    damage->setEmpty();
+    if (&before == &after) {
+        return;
+    }
+
+    const PictureOps a(before), b(after);
+    if (!a.fRecord || !b.fRecord) {
+        // Small pictures have no SkRecord to compare; assume everything changed.
+        add_rect(before.cullRect(), damage);
+        add_rect(after.cullRect(), damage);
+        return;
+    }
+
+    // Skip past the ops both pictures start and end with.
+    const int n = a.count(),
+              m = b.count();
+    int prefix = 0;
+    while (prefix < n && prefix < m && same_op(a, prefix, b, prefix)) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix &&
+           same_op(a, n - 1 - suffix, b, m - 1 - suffix)) {
+        suffix++;
+    }
+
+    if (n == m) {
+        // Most frames of an animation draw the same ops with some arguments changed, so compare
+        // them one for one.
+        for (int i = prefix; i < n - suffix; ++i) {
+            if (!same_op(a, i, b, i)) {
+                add_rect(a.fBounds[i], damage);
+                add_rect(b.fBounds[i], damage);
+            }
+        }
+    } else {
+        for (int i = prefix; i < n - suffix; ++i) {
+            add_rect(a.fBounds[i], damage);
+        }
+        for (int i = prefix; i < m - suffix; ++i) {
+            add_rect(b.fBounds[i], damage);
+        }
+    }
+
+    int rects = 0;
+    for (SkRegion::Iterator iter(*damage); !iter.done(); iter.next()) {
+        rects++;
+    }
+    if (rects > maxRects) {
+        damage->setRect(damage->getBounds());
+    }
+}
+
+void SkPictureDamage::AddOps(const SkPicture& picture, int start, int stop, SkRegion* damage) {
+    const PictureOps ops(picture);
+    if (!ops.fRecord) {
+        if (start < stop) {
+            add_rect(picture.cullRect(), damage);
+        }
+        return;
+    }
+    start = SkTMax(start, 0);
+    stop  = SkTMin(stop, ops.count());
+    for (int i = start; i < stop; ++i) {
+        add_rect(ops.fBounds[i], damage);
+    }
+}
+
+void SkPictureDamage::Replay(const SkPicture& picture, const SkRegion& damage, SkCanvas* canvas,
+                             SkColor background) {
+    for (SkRegion::Iterator iter(damage); !iter.done(); iter.next()) {
+        SkAutoCanvasRestore acr(canvas, true);
+        canvas->clipRect(SkRect::Make(iter.rect()));
+        canvas->drawColor(background, SkBlendMode::kSrc);
+        canvas->drawPicture(&picture);
+    }
+}
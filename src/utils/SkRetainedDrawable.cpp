@@ -0,0 +1,167 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkRetainedDrawable.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/private/SkTHash.h"
+#include "include/utils/SkNoDrawCanvas.h"
+#include "src/core/SkBBoxHierarchy.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecordOpts.h"
+#include "src/core/SkRecorder.h"
+
+#include <string.h>
+
+static bool is_retained(SkDrawable* drawable) {
+    // Without RTTI, go by the name.
+    const char* name = drawable->getTypeName();
+    return name && 0 == strcmp(name, "SkRetainedDrawable");
+}
+
+sk_sp<SkRetainedDrawable> SkRetainedDrawable::Make(const SkRect& bounds) {
+    return sk_sp<SkRetainedDrawable>(new SkRetainedDrawable(bounds));
+}
+
+SkRetainedDrawable::SkRetainedDrawable(const SkRect& bounds)
+    : fBounds(bounds.isFinite() ? bounds : SkRect::MakeEmpty()) {}
+
+SkRetainedDrawable::~SkRetainedDrawable() {}
+
+SkCanvas* SkRetainedDrawable::beginRecording() {
+    if (!fRecorder) {
+        fRecorder.reset(new SkRecorder(nullptr, fBounds));
+    }
+    fPendingRecord = sk_make_sp<SkRecord>();
+    fRecorder->reset(fPendingRecord.get(), fBounds, SkRecorder::Record_DrawPictureMode);
+    return fRecorder.get();
+}
+
+void SkRetainedDrawable::finishRecording() {
+    if (!fPendingRecord) {
+        return;
+    }
+    fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
+
+    SkRecordOptimize(fPendingRecord.get());
+
+    const int count = fPendingRecord->count();
+    SkAutoTMalloc<SkRect> bounds(count);
+    SkRecordFillBounds(fBounds, *fPendingRecord, bounds);
+
+    SkRect contentBounds = SkRect::MakeEmpty();
+    for (int i = 0; i < count; ++i) {
+        contentBounds.join(bounds[i]);
+    }
+    contentBounds.intersect(fBounds);
+
+    fBBH.reset(SkRTreeFactory()());
+    fBBH->insert(bounds, count);
+
+    fDirty.join(fContentBounds);
+    fDirty.join(contentBounds);
+    fContentBounds = contentBounds;
+
+    fRecord = std::move(fPendingRecord);
+    fDrawableList = fRecorder->detachDrawableList();
+    fRecorder->forgetRecord();
+
+    this->findChildren();
+    this->notifyDrawingChanged();
+}
+
+void SkRetainedDrawable::findChildren() {
+    // Plays the ops back, noting the drawables they draw and the full matrix they draw them with.
+    class ChildFinder final : public SkNoDrawCanvas {
+    public:
+        ChildFinder(const SkRect& bounds, SkTArray<Child>* children)
+            : SkNoDrawCanvas(bounds.roundOut())
+            , fChildren(children) {}
+
+    protected:
+        void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+            SkMatrix total = this->getTotalMatrix();
+            if (matrix) {
+                total.preConcat(*matrix);
+            }
+            fChildren->push_back({drawable, total, drawable->getGenerationID()});
+        }
+
+    private:
+        SkTArray<Child>* fChildren;
+    };
+
+    fChildren.reset();
+    if (fDrawableList && fDrawableList->count() > 0) {
+        ChildFinder finder(fBounds, &fChildren);
+        SkRecordDraw(*fRecord, &finder, nullptr, fDrawableList->begin(), fDrawableList->count(),
+                     nullptr, nullptr);
+    }
+}
+
+void SkRetainedDrawable::invalidate(const SkRect& rect) {
+    if (rect.isFinite()) {
+        fDirty.join(rect);
+    }
+}
+
+SkRect SkRetainedDrawable::detachDirtyRect() {
+    SkRect dirty = fDirty;
+    fDirty.setEmpty();
+
+    // Collect each drawable's changes once, however many times it is drawn.
+    SkTHashMap<SkDrawable*, SkRect> childDirty;
+    for (Child& child : fChildren) {
+        SkRect* rect = childDirty.find(child.fDrawable);
+        if (!rect) {
+            SkRect changed = SkRect::MakeEmpty();
+            if (is_retained(child.fDrawable)) {
+                changed = static_cast<SkRetainedDrawable*>(child.fDrawable)->detachDirtyRect();
+            } else if (child.fDrawable->getGenerationID() != child.fGenerationID) {
+                changed = child.fDrawable->getBounds();
+            }
+            rect = childDirty.set(child.fDrawable, changed);
+        }
+        child.fGenerationID = child.fDrawable->getGenerationID();
+        if (!rect->isEmpty()) {
+            dirty.join(child.fMatrix.mapRect(*rect));
+        }
+    }
+    dirty.intersect(fBounds);
+    return dirty;
+}
+
+void SkRetainedDrawable::onDraw(SkCanvas* canvas) {
+    if (!fRecord) {
+        return;
+    }
+    SkDrawable* const* drawables = nullptr;
+    int drawableCount = 0;
+    if (fDrawableList) {
+        drawables = fDrawableList->begin();
+        drawableCount = fDrawableList->count();
+    }
+    SkRecordDraw(*fRecord, canvas, nullptr, drawables, drawableCount, fBBH.get(), nullptr);
+}
+
+SkPicture* SkRetainedDrawable::onNewPictureSnapshot() {
+    if (!fRecord) {
+        return this->INHERITED::onNewPictureSnapshot();
+    }
+    SkBigPicture::SnapshotArray* pictList =
+            fDrawableList ? fDrawableList->newDrawableSnapshot() : nullptr;
+
+    size_t subPictureBytes = 0;
+    for (int i = 0; pictList && i < pictList->count(); i++) {
+        subPictureBytes += pictList->begin()[i]->approximateBytesUsed();
+    }
+    // SkBigPicture takes a ref on both fRecord and fBBH, and we keep ours.
+    return new SkBigPicture(fBounds, SkRef(fRecord.get()), pictList, SkSafeRef(fBBH.get()),
+                            subPictureBytes);
+}
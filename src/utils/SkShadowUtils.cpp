@@ -5,6 +5,7 @@
 * found in the LICENSE file.
 */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkMaskFilter.h"
@@ -353,7 +354,20 @@ public:
 #if SK_SUPPORT_GPU
             , fShapeForKey(*path, GrStyle::SimpleFill())
 #endif
-    {}
+    {
+#if !SK_SUPPORT_GPU
+        SkRect rect;
+        if (path->isRRect(&fRRect)) {
+            fIsRRect = true;
+        } else if (path->isOval(&rect)) {
+            fRRect.setOval(rect);
+            fIsRRect = true;
+        } else if (path->isRect(&rect)) {
+            fRRect.setRect(rect);
+            fIsRRect = true;
+        }
+#endif
+    }
 
     const SkPath& path() const { return *fPath; }
     const SkMatrix& viewMatrix() const { return *fViewMatrix; }
@@ -365,9 +379,26 @@ public:
     }
     bool isRRect(SkRRect* rrect) { return fShapeForKey.asRRect(rrect, nullptr, nullptr, nullptr); }
 #else
-    int keyBytes() const { return -1; }
-    void writeKey(void* key) const { SK_ABORT("Should never be called"); }
-    bool isRRect(SkRRect* rrect) { return false; }
+    // Like GrShape, key rects, ovals and rrects by their geometry, so that separate paths of the
+    // same shape share tessellations, and other paths by their generation ID.
+    int keyBytes() const {
+        return sizeof(uint32_t) + (fIsRRect ? SkRRect::kSizeInMemory : sizeof(uint32_t));
+    }
+    void writeKey(void* key) const {
+        uint32_t* words = reinterpret_cast<uint32_t*>(key);
+        words[0] = (static_cast<uint32_t>(fPath->getFillType()) << 1) | fIsRRect;
+        if (fIsRRect) {
+            fRRect.writeToMemory(words + 1);
+        } else {
+            words[1] = fPath->getGenerationID();
+        }
+    }
+    bool isRRect(SkRRect* rrect) {
+        if (fIsRRect) {
+            *rrect = fRRect;
+        }
+        return fIsRRect;
+    }
 #endif
 
 private:
@@ -375,6 +406,9 @@ private:
     const SkMatrix* fViewMatrix;
 #if SK_SUPPORT_GPU
     GrShape fShapeForKey;
+#else
+    SkRRect fRRect;
+    bool    fIsRRect = false;
 #endif
 };
 
@@ -406,14 +440,105 @@ private:
     std::unique_ptr<uint8_t[]> fKey;
 };
 
+// Another domain of keys in SkResourceCache, for the shadow masks below.
+static void* kMaskNamespace;
+
+// Larger shadows are rare, and cost as much to blit as to shade.
+static constexpr int kMaxShadowMaskPixels = 1024 * 1024;
+
+/**
+ * Raster devices shade the shadow vertices with SkGaussianColorFilter at every pixel. Vertices
+ * from the tessellation cache are drawn again and again, though, and only their translation and
+ * color change. So their coverage is rendered once into an A8 mask, which lives in SkResourceCache
+ * keyed by the vertices and the subpixel part of the translation, and reused at any whole pixel
+ * offset. The vertices' unique ID stands for everything they were built from: the path's
+ * generation ID, the z-plane, the light and the matrix's scale and skew.
+ */
+struct ShadowMaskKey : public SkResourceCache::Key {
+    ShadowMaskKey(uint32_t verticesID, SkScalar subpixelX, SkScalar subpixelY)
+            : fVerticesID(verticesID)
+            , fSubpixelX(subpixelX)
+            , fSubpixelY(subpixelY) {
+        this->init(&kMaskNamespace, resource_cache_shared_id(),
+                   sizeof(fVerticesID) + sizeof(fSubpixelX) + sizeof(fSubpixelY));
+    }
+
+    uint32_t fVerticesID;
+    SkScalar fSubpixelX;
+    SkScalar fSubpixelY;
+};
+
+class ShadowMaskRec : public SkResourceCache::Rec {
+public:
+    ShadowMaskRec(const ShadowMaskKey& key, const SkBitmap& mask, SkIPoint origin)
+            : fKey(key), fMask(mask), fOrigin(origin) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fMask.computeByteSize(); }
+    const char* getCategory() const override { return "shadow masks"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const ShadowMaskRec& rec = static_cast<const ShadowMaskRec&>(baseRec);
+        ShadowMaskRec* result = static_cast<ShadowMaskRec*>(context);
+        result->fMask = rec.fMask;
+        result->fOrigin = rec.fOrigin;
+        return true;
+    }
+
+    ShadowMaskKey fKey;
+    SkBitmap      fMask;
+    SkIPoint      fOrigin;    // of the mask, relative to the whole pixel part of the translation
+};
+
+/**
+ * Finds or renders the coverage of 'vertices' drawn translated by (tx, ty). On success 'mask' is
+ * an A8 bitmap to be drawn at 'position' in the shadow's color.
+ */
+bool find_or_make_shadow_mask(const SkVertices* vertices, SkScalar tx, SkScalar ty,
+                              SkBitmap* mask, SkIPoint* position) {
+    SkScalar wholeX = SkScalarFloorToScalar(tx),
+             wholeY = SkScalarFloorToScalar(ty);
+    // Also rejects NaNs.
+    if (!(SkScalarAbs(wholeX) < (1 << 30) && SkScalarAbs(wholeY) < (1 << 30))) {
+        return false;
+    }
+    ShadowMaskKey key(vertices->uniqueID(), tx - wholeX, ty - wholeY);
+
+    ShadowMaskRec found(key, SkBitmap(), {0, 0});
+    if (!SkResourceCache::Find(key, ShadowMaskRec::Visitor, &found)) {
+        SkIRect bounds = vertices->bounds().makeOffset(key.fSubpixelX, key.fSubpixelY).roundOut();
+        if (bounds.isEmpty() || (int64_t)bounds.width() * bounds.height() > kMaxShadowMaskPixels ||
+            !found.fMask.tryAllocPixels(SkImageInfo::MakeA8(bounds.width(), bounds.height()))) {
+            return false;
+        }
+        found.fMask.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(found.fMask);
+        canvas.translate(key.fSubpixelX - bounds.fLeft, key.fSubpixelY - bounds.fTop);
+        SkPaint paint;
+        paint.setColorFilter(SkGaussianColorFilter::Make());
+        canvas.drawVertices(vertices, SkBlendMode::kModulate, paint);
+        found.fMask.setImmutable();
+        found.fOrigin = bounds.topLeft();
+        SkResourceCache::Add(new ShadowMaskRec(key, found.fMask, found.fOrigin));
+    }
+
+    *mask = found.fMask;
+    *position = found.fOrigin + SkIPoint::Make(SkScalarTruncToInt(wholeX),
+                                               SkScalarTruncToInt(wholeY));
+    return true;
+}
+
 /**
  * Draws a shadow to 'canvas'. The vertices used to draw the shadow are created by 'factory' unless
- * they are first found in SkResourceCache.
+ * they are first found in SkResourceCache. If 'drawMaskProc' is set, vertices found there are
+ * drawn through it as a cached coverage mask instead.
  */
 template <typename FACTORY>
 bool draw_shadow(const FACTORY& factory,
                  std::function<void(const SkVertices*, SkBlendMode, const SkPaint&,
-                 SkScalar tx, SkScalar ty, bool)> drawProc, ShadowedPath& path, SkColor color) {
+                 SkScalar tx, SkScalar ty, bool)> drawProc,
+                 const std::function<void(const SkBitmap&, SkIPoint, SkColor)>& drawMaskProc,
+                 ShadowedPath& path, SkColor color) {
     FindContext<FACTORY> context(&path.viewMatrix(), &factory);
 
     SkResourceCache::Key* key = nullptr;
@@ -447,7 +572,12 @@ bool draw_shadow(const FACTORY& factory,
                 return false;
             }
             auto rec = new CachedTessellationsRec(*key, std::move(tessellations));
-            SkPathPriv::AddGenIDChangeListener(path.path(), sk_make_sp<ShadowInvalidator>(*key));
+            // Keys made from an rrect's geometry never go stale.
+            SkRRect rrect;
+            if (!path.isRRect(&rrect)) {
+                SkPathPriv::AddGenIDChangeListener(path.path(),
+                                                   sk_make_sp<ShadowInvalidator>(*key));
+            }
             SkResourceCache::Add(rec);
         } else {
             vertices = factory.makeVertices(path.path(), path.viewMatrix(),
@@ -458,6 +588,21 @@ bool draw_shadow(const FACTORY& factory,
         }
     }
 
+    // Only vertices that have already been reused are likely to be drawn again.
+    if (drawMaskProc && foundInCache && vertices->vertexCount()) {
+        // Perspective shadows are computed in device space and drawn untranslated.
+        bool hasPerspective = path.viewMatrix().hasPerspective();
+        SkBitmap mask;
+        SkIPoint position;
+        if (find_or_make_shadow_mask(vertices.get(),
+                                     hasPerspective ? 0 : context.fTranslate.fX,
+                                     hasPerspective ? 0 : context.fTranslate.fY,
+                                     &mask, &position)) {
+            drawMaskProc(mask, position, color);
+            return true;
+        }
+    }
+
     SkPaint paint;
     // Run the vertex color through a GaussianColorFilter and then modulate the grayscale result of
     // that against our 'color' param.
@@ -580,6 +725,20 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
         }
     };
 
+    // Devices we can rasterize into directly blit cached coverage masks of the shadows instead.
+    std::function<void(const SkBitmap&, SkIPoint, SkColor)> drawMaskProc;
+    SkPixmap pixmap;
+    if (this->peekPixels(&pixmap)) {
+        drawMaskProc = [this](const SkBitmap& mask, SkIPoint position, SkColor color) {
+            SkPaint paint;
+            paint.setColor(color);
+            this->drawBitmapRect(mask, nullptr,
+                                 SkRect::Make(SkIRect::MakeXYWH(position.fX, position.fY,
+                                                                mask.width(), mask.height())),
+                                 paint, SkCanvas::kFast_SrcRectConstraint);
+        };
+    }
+
     if (!validate_rec(rec)) {
         return;
     }
@@ -627,7 +786,8 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
                 factory.fOffset.fY = viewMatrix.getTranslateY();
             }
 
-            if (!draw_shadow(factory, drawVertsProc, shadowedPath, rec.fAmbientColor)) {
+            if (!draw_shadow(factory, drawVertsProc, drawMaskProc, shadowedPath,
+                             rec.fAmbientColor)) {
                 // Pretransform the path to avoid transforming the stroke, below.
                 SkPath devSpacePath;
                 path.transform(viewMatrix, &devSpacePath);
@@ -744,7 +904,7 @@ void SkBaseDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
                     break;
             }
 #endif
-            if (!draw_shadow(factory, drawVertsProc, shadowedPath, color)) {
+            if (!draw_shadow(factory, drawVertsProc, drawMaskProc, shadowedPath, color)) {
                 // draw with blur
                 SkMatrix shadowMatrix;
                 if (!SkDrawShadowMetrics::GetSpotShadowTransform(devLightPos, lightRadius,
@@ -12,6 +12,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkDrawLooper.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -28,11 +29,13 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkBlurDrawLooper.h"
+#include "include/effects/SkImageFilters.h"
 #include "include/effects/SkLayerDrawLooper.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/private/SkFloatBits.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkBlurPriv.h"
+#include "src/core/SkBlurRescale.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
@@ -703,6 +706,63 @@ DEF_TEST(BlurZeroSigma, reporter) {
 }
 
 
+// With SkGraphics::SetApproximateLargeBlurs(), large blurs are computed at a reduced resolution
+// but must stay within SkBlurRescale::kMaxError of the full resolution result.
+DEF_TEST(BlurApproximateLargeSigma, reporter) {
+    auto draw = [](bool approximate, bool imageFilter, SkScalar sigma) {
+        bool wasApproximate = SkGraphics::SetApproximateLargeBlurs(approximate);
+        SkBitmap bm;
+        bm.allocN32Pixels(301, 203);
+        SkCanvas canvas(bm);
+        canvas.clear(0);
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        if (imageFilter) {
+            // Crop to exercise a destination that does not contain the blurred source.
+            const SkIRect crop = SkIRect::MakeLTRB(37, 11, 260, 190);
+            SkPaint layerPaint;
+            layerPaint.setImageFilter(SkImageFilters::Blur(sigma, sigma, nullptr, &crop));
+            canvas.saveLayer(nullptr, &layerPaint);
+        } else {
+            paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma));
+        }
+        paint.setColor(0xFF3366CC);
+        canvas.drawRect(SkRect::MakeXYWH(70, 50, 120, 60), paint);
+        paint.setColor(0x80CC2222);
+        canvas.drawCircle(180, 120, 50, paint);
+        paint.setColor(SK_ColorBLACK);
+        canvas.drawRect(SkRect::MakeXYWH(40, 140, 3, 40), paint);
+        if (imageFilter) {
+            canvas.restore();
+        }
+
+        SkGraphics::SetApproximateLargeBlurs(wasApproximate);
+        return bm;
+    };
+
+    for (bool imageFilter : {false, true}) {
+        for (SkScalar sigma : {16.0f, 37.0f, 100.0f}) {
+            SkBitmap exact = draw(false, imageFilter, sigma),
+                     approx = draw(true, imageFilter, sigma);
+            int maxError = 0;
+            for (int y = 0; y < exact.height(); ++y) {
+                for (int x = 0; x < exact.width(); ++x) {
+                    uint32_t e = *exact.getAddr32(x, y),
+                             a = *approx.getAddr32(x, y);
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        maxError = SkTMax(maxError, SkTAbs((int)((e >> shift) & 0xFF) -
+                                                           (int)((a >> shift) & 0xFF)));
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, maxError <= SkBlurRescale::kMaxError,
+                            "%s sigma %g: error %d", imageFilter ? "image filter" : "mask filter",
+                            sigma, maxError);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BlurMaskBiggerThanDest, reporter, ctxInfo) {
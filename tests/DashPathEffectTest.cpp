@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -19,6 +20,8 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "src/core/SkPathPriv.h"
+#include "src/utils/SkDashPathPriv.h"
 #include "tests/Test.h"
 
 // crbug.com/348821 was rooted in SkDashPathEffect refusing to flatten and unflatten itself when
@@ -140,3 +143,147 @@ DEF_TEST(DashCrazy_crbug_875494, r) {
     paint.setPathEffect(SkDashPathEffect::Make(vals, N, 222));
     paint.getFillPath(path, &path2, &cull);
 }
+
+// Streaming the dashes in batches must produce the same geometry, in the same order, as dashing
+// the whole path at once.
+DEF_TEST(DashPathEffectTest_stream, r) {
+    SkPath open, closed;
+    open.moveTo(10, 10);
+    for (int i = 1; i <= 50; ++i) {
+        open.cubicTo(10 + i * 20, 0, 10 + i * 20, 200, 20 + i * 20, 100);
+    }
+    closed.addCircle(100, 100, 90);
+    closed.addRoundRect(SkRect::MakeLTRB(20, 20, 300, 200), 10, 10);
+
+    const SkScalar intervals[] = { 1, 0.5f, 3, 0.5f };
+    SkPathEffect::DashInfo info;
+    info.fIntervals = const_cast<SkScalar*>(intervals);
+    info.fCount = SK_ARRAY_COUNT(intervals);
+    info.fPhase = 0.25f;
+
+    for (const SkPath& path : { open, closed }) {
+        for (SkScalar width : { 0.0f, 2.0f }) {
+            SkStrokeRec filterRec(SkStrokeRec::kHairline_InitStyle);
+            filterRec.setStrokeStyle(width);
+            SkPath filtered;
+            REPORTER_ASSERT(r, SkDashPath::FilterDashPath(&filtered, path, &filterRec, nullptr,
+                                                          info));
+
+            SkStrokeRec streamRec(SkStrokeRec::kHairline_InitStyle);
+            streamRec.setStrokeStyle(width);
+            SkPath streamed;
+            int batches = 0;
+            REPORTER_ASSERT(r, SkDashPath::StreamDashPath(path, &streamRec, nullptr, info,
+                                                          [&](const SkPath& batch) {
+                ++batches;
+                int contours = 0;
+                for (SkPath::Verb verb : SkPathPriv::Verbs(batch)) {
+                    contours += SkPath::kMove_Verb == verb;
+                }
+                REPORTER_ASSERT(r, contours <= SkDashPath::kStreamBatchCount);
+                streamed.addPath(batch);
+            }));
+
+            REPORTER_ASSERT(r, batches > 1);
+            REPORTER_ASSERT(r, filterRec.getStyle() == streamRec.getStyle());
+            REPORTER_ASSERT(r, filtered.countVerbs() == streamed.countVerbs());
+            REPORTER_ASSERT(r, filtered.countPoints() == streamed.countPoints());
+            if (filtered.countPoints() == streamed.countPoints()) {
+                for (int i = 0; i < filtered.countPoints(); ++i) {
+                    REPORTER_ASSERT(r, filtered.getPoint(i) == streamed.getPoint(i));
+                }
+            }
+        }
+    }
+}
+
+// Raster draws stream the dashes straight to the blitter. Where no two dashes overlap, that must
+// draw exactly what drawing the pre-dashed path does.
+DEF_TEST(DashPathEffectTest_streamDraw, r) {
+    // Rows joined at right angles, far enough apart, and gaps wide enough for a 3 pixel stroke.
+    SkPath path;
+    path.moveTo(5, 10);
+    for (int i = 0; i < 12; ++i) {
+        SkScalar x = i & 1 ? 5 : 250;
+        path.lineTo(x, 10.f + i * 20);
+        path.lineTo(x, 30.f + i * 20);
+    }
+
+    const SkScalar intervals[] = { 2, 6 };
+    for (SkScalar width : { 0.0f, 3.0f }) {
+        for (bool aa : { false, true }) {
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(width);
+            paint.setAntiAlias(aa);
+            paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+
+            SkPaint fillPaint(paint);
+            fillPaint.setPathEffect(nullptr);
+            SkPath dashed;
+            bool doFill = paint.getFillPath(path, &dashed);
+            fillPaint.setStyle(doFill ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+            fillPaint.setStrokeWidth(0);
+
+            auto info = SkImageInfo::MakeN32Premul(256, 256);
+            sk_sp<SkSurface> streamed = SkSurface::MakeRaster(info),
+                             expected = SkSurface::MakeRaster(info);
+            streamed->getCanvas()->clear(SK_ColorWHITE);
+            expected->getCanvas()->clear(SK_ColorWHITE);
+            streamed->getCanvas()->drawPath(path, paint);
+            expected->getCanvas()->drawPath(dashed, fillPaint);
+
+            SkBitmap a, b;
+            a.allocPixels(info);
+            b.allocPixels(info);
+            streamed->readPixels(a, 0, 0);
+            expected->readPixels(b, 0, 0);
+            REPORTER_ASSERT(r, !memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()));
+        }
+    }
+}
+
+// Where dashes in different batches overlap, translucent or antialiased dashes must still be
+// blended once, as when the whole dashed path is filled.
+DEF_TEST(DashPathEffectTest_streamOverlap, r) {
+    // A zig-zag crossing itself many times, long enough for thousands of dashes.
+    SkPath path;
+    path.moveTo(5, 8);
+    for (int i = 1; i <= 50; ++i) {
+        path.lineTo(i & 1 ? 250 : 5, 8.f + (i * 37) % 240);
+    }
+
+    const SkScalar intervals[] = { 2, 3 };
+    for (SkAlpha alpha : { 0x80, 0xFF }) {
+        for (bool aa : { false, true }) {
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(3);
+            paint.setAntiAlias(aa);
+            paint.setAlpha(alpha);
+            paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+
+            SkPaint fillPaint(paint);
+            fillPaint.setPathEffect(nullptr);
+            fillPaint.setStyle(SkPaint::kFill_Style);
+            SkPath dashed;
+            REPORTER_ASSERT(r, paint.getFillPath(path, &dashed));
+            int dashes = 0;
+            for (SkPath::Verb verb : SkPathPriv::Verbs(dashed)) {
+                dashes += SkPath::kMove_Verb == verb;
+            }
+            REPORTER_ASSERT(r, dashes > 2 * SkDashPath::kStreamBatchCount);
+
+            SkBitmap streamed, expected;
+            streamed.allocN32Pixels(256, 256);
+            expected.allocN32Pixels(256, 256);
+            streamed.eraseColor(SK_ColorWHITE);
+            expected.eraseColor(SK_ColorWHITE);
+            SkCanvas(streamed).drawPath(path, paint);
+            SkCanvas(expected).drawPath(dashed, fillPaint);
+            REPORTER_ASSERT(r, !memcmp(streamed.getPixels(), expected.getPixels(),
+                                       streamed.computeByteSize()),
+                            "alpha %d aa %d", alpha, aa);
+        }
+    }
+}
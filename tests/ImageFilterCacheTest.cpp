@@ -9,11 +9,14 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkImageFilterCache.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkSpecialImage.h"
 
 static const int kSmallerSize = 10;
@@ -147,6 +150,119 @@ static void test_explicit_purging(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter, !cache->get(key2, &foundOffset));
 }
 
+// A result is reused, cropped to the clip, for clips inside the one it was computed for.
+static void test_find_contained_clip(skiatest::Reporter* reporter,
+                                     const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    auto filter = make_filter();
+    cache->set(key, image.get(), offset, filter.get());
+
+    // The result covers (3, 4) to (19, 20).
+    SkImageFilterCacheKey inner(0, SkMatrix::I(), SkIRect::MakeLTRB(5, 6, 9, 26),
+                                image->uniqueID(), image->subset());
+    SkIPoint foundOffset;
+    sk_sp<SkSpecialImage> foundImage = cache->get(inner, &foundOffset);
+    REPORTER_ASSERT(reporter, foundImage);
+    if (foundImage) {
+        REPORTER_ASSERT(reporter, SkIPoint::Make(5, 6) == foundOffset);
+        REPORTER_ASSERT(reporter, 4 == foundImage->width() && 14 == foundImage->height());
+    }
+
+    SkImageFilterCacheKey outer(0, SkMatrix::I(), SkIRect::MakeLTRB(50, 50, 120, 60),
+                                image->uniqueID(), image->subset());
+    REPORTER_ASSERT(reporter, !cache->get(outer, &foundOffset));
+    // The filter reads its source, which doesn't move with the CTM.
+    SkImageFilterCacheKey translated(0, SkMatrix::MakeTrans(1, 0), SkIRect::MakeLTRB(5, 6, 9, 26),
+                                     image->uniqueID(), image->subset());
+    REPORTER_ASSERT(reporter, !cache->get(translated, &foundOffset));
+}
+
+// Without a source, a CTM and clip moved by whole pixels find the result moved with them.
+static void test_find_translated(skiatest::Reporter* reporter,
+                                 const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    const SkIRect noSubset = SkIRect::MakeEmpty();
+    SkImageFilterCacheKey key(0, SkMatrix::MakeTrans(10, 20), SkIRect::MakeWH(100, 100),
+                              0, noSubset);
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    auto filter = make_filter();
+    cache->set(key, image.get(), offset, filter.get());
+
+    SkImageFilterCacheKey panned(0, SkMatrix::MakeTrans(13, 25),
+                                 SkIRect::MakeXYWH(3, 5, 100, 100), 0, noSubset);
+    SkIPoint foundOffset;
+    sk_sp<SkSpecialImage> foundImage = cache->get(panned, &foundOffset);
+    REPORTER_ASSERT(reporter, foundImage);
+    if (foundImage) {
+        REPORTER_ASSERT(reporter, SkIPoint::Make(6, 9) == foundOffset);
+        REPORTER_ASSERT(reporter, image->width() == foundImage->width() &&
+                                  image->height() == foundImage->height());
+    }
+
+    SkImageFilterCacheKey subpixel(0, SkMatrix::MakeTrans(13.5f, 25),
+                                   SkIRect::MakeXYWH(3, 5, 100, 100), 0, noSubset);
+    REPORTER_ASSERT(reporter, !cache->get(subpixel, &foundOffset));
+}
+
+class TestStatsDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char*, const char* valueName, const char*,
+                          uint64_t value) override {
+        if (0 == strcmp(valueName, "size")) {
+            fSize = value;
+        } else if (0 == strcmp(valueName, "entry_count")) {
+            fEntries = value;
+        } else if (0 == strcmp(valueName, "hit_count")) {
+            fHits = value;
+        } else if (0 == strcmp(valueName, "partial_hit_count")) {
+            fPartialHits = value;
+        } else if (0 == strcmp(valueName, "miss_count")) {
+            fMisses = value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override { return kLight_LevelOfDetail; }
+
+    uint64_t fSize = 0, fEntries = 0, fHits = 0, fPartialHits = 0, fMisses = 0;
+};
+
+// The cache reports its size and how often lookups hit.
+static void test_dump_statistics(skiatest::Reporter* reporter,
+                                 const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey inner(0, SkMatrix::I(), SkIRect::MakeWH(10, 10),
+                                image->uniqueID(), image->subset());
+    SkImageFilterCacheKey other(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    auto filter = make_filter();
+    SkIPoint foundOffset;
+    REPORTER_ASSERT(reporter, !cache->get(key, &foundOffset));
+    cache->set(key, image.get(), SkIPoint::Make(0, 0), filter.get());
+    REPORTER_ASSERT(reporter, cache->get(key, &foundOffset));
+    REPORTER_ASSERT(reporter, cache->get(key, &foundOffset));
+    REPORTER_ASSERT(reporter, cache->get(inner, &foundOffset));
+    REPORTER_ASSERT(reporter, !cache->get(other, &foundOffset));
+
+    TestStatsDump dump;
+    cache->dumpMemoryStatistics(&dump, "image_filter_cache");
+    REPORTER_ASSERT(reporter, image->getSize() == dump.fSize);
+    REPORTER_ASSERT(reporter, 1 == dump.fEntries);
+    REPORTER_ASSERT(reporter, 2 == dump.fHits);
+    REPORTER_ASSERT(reporter, 1 == dump.fPartialHits);
+    REPORTER_ASSERT(reporter, 2 == dump.fMisses);
+}
+
 DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     SkBitmap srcBM = create_bm();
 
@@ -162,6 +278,9 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_find_contained_clip(reporter, fullImg);
+    test_find_translated(reporter, fullImg);
+    test_dump_statistics(reporter, fullImg);
 }
 
 
@@ -181,6 +300,9 @@ static void test_image_backed(skiatest::Reporter* reporter,
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_find_contained_clip(reporter, fullImg);
+    test_find_translated(reporter, fullImg);
+    test_dump_statistics(reporter, fullImg);
 }
 
 DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
@@ -191,6 +313,64 @@ DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
     test_image_backed(reporter, nullptr, srcImage);
 }
 
+// Filtering a clip inside one already cached gives the pixels an uncached filter would, whether
+// or not the cached result can be reused for it.
+DEF_TEST(ImageFilterCache_PartialHitMatchesCold, reporter) {
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(64, 64);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            *srcBM.getAddr32(x, y) = SkPackARGB32(0xFF, x * 4, y * 4, (x * y) & 0xFF);
+        }
+    }
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(64, 64), srcBM));
+
+    const SkScalar kernel[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+    const struct {
+        sk_sp<SkImageFilter> fFilter;
+        bool fPartialHit;
+    } cases[] = {
+        { SkImageFilters::Blur(2, 2, nullptr), true },
+        // Repeat wraps around its input, which is only computed for the clip's neighbourhood, so
+        // neither it nor the offset below it may be served from the larger clip's results.
+        { SkImageFilters::MatrixConvolution({3, 3}, kernel, 0.3f, 0, {1, 1}, SkTileMode::kRepeat,
+                                            true, SkImageFilters::Offset(0, 0, nullptr)), false },
+    };
+
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+    const SkIRect clip = SkIRect::MakeLTRB(20, 24, 36, 40);
+    for (const auto& c : cases) {
+        const SkImageFilter_Base* filter = as_IFB(c.fFilter);
+        sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(1000000));
+        SkIPoint offset;
+        filter->filterImage(src.get(), SkImageFilter_Base::Context(
+                SkMatrix::I(), SkIRect::MakeWH(64, 64), cache.get(), noColorSpace), &offset);
+
+        SkIPoint warmOffset, coldOffset;
+        sk_sp<SkSpecialImage> warm = filter->filterImage(src.get(), SkImageFilter_Base::Context(
+                SkMatrix::I(), clip, cache.get(), noColorSpace), &warmOffset);
+        sk_sp<SkSpecialImage> cold = filter->filterImage(src.get(), SkImageFilter_Base::Context(
+                SkMatrix::I(), clip, nullptr, noColorSpace), &coldOffset);
+
+        TestStatsDump dump;
+        cache->dumpMemoryStatistics(&dump, "image_filter_cache");
+        REPORTER_ASSERT(reporter, (c.fPartialHit ? 1u : 0u) == dump.fPartialHits);
+
+        SkBitmap warmBM, coldBM;
+        if (!warm || !cold || !warm->getROPixels(&warmBM) || !cold->getROPixels(&coldBM)) {
+            ERRORF(reporter, "filter failed");
+            continue;
+        }
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            for (int x = clip.fLeft; x < clip.fRight; ++x) {
+                SkColor w = warmBM.getColor(x - warmOffset.fX, y - warmOffset.fY),
+                        k = coldBM.getColor(x - coldOffset.fX, y - coldOffset.fY);
+                REPORTER_ASSERT(reporter, w == k, "(%d, %d): 0x%08x vs 0x%08x", x, y, w, k);
+            }
+        }
+    }
+}
+
 #include "include/gpu/GrContext.h"
 #include "include/gpu/GrTexture.h"
 #include "src/gpu/GrContextPriv.h"
@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -18,6 +19,7 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/effects/SkTableColorFilter.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
@@ -1872,3 +1874,344 @@ DEF_TEST(ImageSourceBounds, reporter) {
                                                              &input));
 }
 
+
+// Filtering the independent inputs of merge, xfermode and arithmetic filters on an executor must
+// give the same pixels as filtering them one after another.
+DEF_TEST(ImageFilterParallelInputs, reporter) {
+    sk_sp<SkImageFilter> blur(SkImageFilters::Blur(3, 3, nullptr));
+    sk_sp<SkImageFilter> branches[] = {
+        blur,
+        SkImageFilters::DropShadow(4, 4, 2, 2, SK_ColorBLUE, nullptr),
+        make_grayscale(blur, nullptr),
+        nullptr,
+        blur,       // repeated inputs are only filtered once
+        SkImageFilters::Xfermode(SkBlendMode::kMultiply, make_blue(nullptr, nullptr),
+                                 SkImageFilters::Blur(1, 5, nullptr)),
+        SkImageFilters::Arithmetic(0.25f, 0.5f, 0.5f, 0, true, blur,
+                                   SkImageFilters::Offset(3, -2, nullptr)),
+    };
+    sk_sp<SkImageFilter> merge(SkImageFilters::Merge(branches, SK_ARRAY_COUNT(branches)));
+
+    SkBitmap gradient = make_gradient_circle(64, 64);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(64, 64), gradient));
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(4);
+    SkBitmap results[2];
+    for (int i = 0; i < 2; ++i) {
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(64, 64), nullptr,
+                                        noColorSpace, i ? pool.get() : nullptr);
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result(as_IFB(merge)->filterImage(src.get(), ctx, &offset));
+        REPORTER_ASSERT(reporter, result && result->getROPixels(&results[i]));
+    }
+    REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(results[0], results[1]));
+}
+
+// Filtering tile by tile must reproduce the untiled result inside every tile.
+DEF_TEST(ImageFilterTiled, reporter) {
+    const SkScalar kernel[9] = { 1, 2, 1, 2, 4, 2, 1, 2, 1 };
+    sk_sp<SkImageFilter> blur(SkImageFilters::Blur(4, 2, nullptr));
+    sk_sp<SkImageFilter> branches[] = {
+        SkImageFilters::Offset(7, -5, blur),
+        SkImageFilters::Dilate(3, 1, blur),
+        SkImageFilters::MatrixConvolution(SkISize::Make(3, 3), kernel, 1.0f / 16, 0,
+                                          SkIPoint::Make(1, 1), SkTileMode::kClamp, true,
+                                          SkImageFilters::Erode(1, 2, nullptr)),
+        SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kG, 8, blur, nullptr),
+        SkImageFilters::DropShadow(-3, 6, 2, 2, SK_ColorGREEN, nullptr),
+    };
+    sk_sp<SkImageFilter> merge(SkImageFilters::Merge(branches, SK_ARRAY_COUNT(branches)));
+
+    // Lighting and the magnifier depend on the edges of the whole output, so they (and any DAG
+    // containing them) come back as a single tile.
+    const SkPoint3 direction = SkPoint3::Make(1, -1, 2);
+    const SkPoint3 location = SkPoint3::Make(30, 40, 20);
+    const struct {
+        sk_sp<SkImageFilter> fFilter;
+        int                  fTiles;
+    } filters[] = {
+        { merge, 49 },
+        { SkImageFilters::DistantLitDiffuse(direction, SK_ColorWHITE, 2, 1, blur), 1 },
+        { SkImageFilters::PointLitSpecular(location, SK_ColorCYAN, 3, 1, 8, blur), 1 },
+        { SkImageFilters::DistantLitDiffuse(direction, SK_ColorYELLOW, 1, 2, nullptr), 1 },
+        { SkImageFilters::Magnifier(SkRect::MakeXYWH(20, 25, 50, 40), 10, blur), 1 },
+        { SkImageFilters::Offset(3, 4, SkImageFilters::Magnifier(SkRect::MakeXYWH(10, 10, 60, 60),
+                                                                  5, nullptr)), 1 },
+        // Decal, like clamp, only reads inside the input bounds it asks for; repeat and mirror
+        // wrap around them.
+        { SkImageFilters::MatrixConvolution(SkISize::Make(3, 3), kernel, 1.0f / 16, 0,
+                                            SkIPoint::Make(1, 1), SkTileMode::kDecal, true,
+                                            blur), 49 },
+        { SkImageFilters::MatrixConvolution(SkISize::Make(3, 3), kernel, 1.0f / 16, 0,
+                                            SkIPoint::Make(1, 1), SkTileMode::kRepeat, true,
+                                            blur), 1 },
+        { SkImageFilters::MatrixConvolution(SkISize::Make(3, 3), kernel, 1.0f / 16, 0,
+                                            SkIPoint::Make(0, 2), SkTileMode::kMirror, false,
+                                            blur), 1 },
+    };
+
+    SkBitmap gradient = make_gradient_circle(100, 100);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(100, 100),
+                                                             gradient));
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(3);
+
+    for (const auto& filter : filters) {
+        SkBitmap expected;
+        expected.allocN32Pixels(100, 100);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(100, 100), nullptr,
+                                            noColorSpace);
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result(as_IFB(filter.fFilter)->filterImage(src.get(), ctx,
+                                                                             &offset));
+            REPORTER_ASSERT(reporter, result);
+            SkCanvas canvas(expected);
+            result->draw(&canvas, offset.x(), offset.y(), nullptr);
+        }
+
+        for (SkExecutor* executor : { (SkExecutor*)nullptr, pool.get() }) {
+            SkBitmap actual;
+            actual.allocN32Pixels(100, 100);
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(actual);
+
+            SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(100, 100), nullptr,
+                                            noColorSpace, executor);
+            int tiles = 0;
+            as_IFB(filter.fFilter)->filterImageTiled(src.get(), ctx, 16,
+                    [&](SkSpecialImage* image, const SkIPoint& offset, const SkIRect& tile) {
+                REPORTER_ASSERT(reporter, SkIRect::MakeWH(100, 100).contains(tile));
+                canvas.save();
+                canvas.clipRect(SkRect::Make(tile));
+                image->draw(&canvas, offset.x(), offset.y(), nullptr);
+                canvas.restore();
+                ++tiles;
+            });
+            REPORTER_ASSERT(reporter, tiles == filter.fTiles, "%d != %d", tiles, filter.fTiles);
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual));
+        }
+    }
+}
+
+// The raster morphology's cost doesn't depend on the radius, so check it against a brute force
+// search over radii that reach past the edges of the image.
+DEF_TEST(ImageFilterMorphologyLargeRadius, reporter) {
+    const int kWidth = 45, kHeight = 38;
+    SkRandom rand;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *bitmap.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+        }
+    }
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight),
+                                                             bitmap));
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+    SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr,
+                                    noColorSpace);
+
+    const SkISize radii[] = { {1, 0}, {0, 3}, {5, 7}, {19, 2}, {22, 30}, {64, 1}, {100, 100} };
+    for (bool dilate : { false, true }) {
+        for (SkISize radius : radii) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radius.width(), radius.height(), nullptr)
+                           : SkImageFilters::Erode(radius.width(), radius.height(), nullptr);
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result(as_IFB(filter)->filterImage(src.get(), ctx, &offset));
+            REPORTER_ASSERT(reporter, result);
+            SkBitmap actual;
+            if (!result || !result->getROPixels(&actual)) {
+                ERRORF(reporter, "No result for radius %d,%d", radius.width(), radius.height());
+                continue;
+            }
+
+            // The input is padded with transparent black out to the result's bounds, and the
+            // window is clamped to those bounds. The extreme over a rectangle is the extreme of
+            // its rows' extremes, so search along x and then along y.
+            const int w = actual.width(), h = actual.height();
+            auto search = [&](const SkPMColor* in, int step, int lo, int hi) {
+                uint8_t channels[4];
+                memset(channels, dilate ? 0 : 255, 4);
+                for (int j = lo; j <= hi; ++j) {
+                    const uint8_t* p = (const uint8_t*)&in[j * step];
+                    for (int c = 0; c < 4; ++c) {
+                        channels[c] = dilate ? SkTMax(channels[c], p[c])
+                                             : SkTMin(channels[c], p[c]);
+                    }
+                }
+                SkPMColor pixel;
+                memcpy(&pixel, channels, 4);
+                return pixel;
+            };
+            SkAutoTMalloc<SkPMColor> padded(w * h), rows(w * h);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    int sx = x + offset.x(), sy = y + offset.y();
+                    padded[y * w + x] = SkIRect::MakeWH(kWidth, kHeight).contains(sx, sy)
+                                      ? *bitmap.getAddr32(sx, sy) : 0;
+                }
+            }
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    rows[y * w + x] = search(&padded[y * w + x], 1, -SkTMin(x, radius.width()),
+                                             SkTMin(w - 1 - x, radius.width()));
+                }
+            }
+            int mismatches = 0;
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    SkPMColor expected = search(&rows[y * w + x], w, -SkTMin(y, radius.height()),
+                                                SkTMin(h - 1 - y, radius.height()));
+                    mismatches += expected != *actual.getAddr32(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == mismatches, "%s %d,%d: %d mismatches",
+                            dilate ? "dilate" : "erode", radius.width(), radius.height(),
+                            mismatches);
+        }
+    }
+}
+
+// A separable kernel is applied as a row pass and a column pass, and large images are filtered in
+// bands on the executor. Neither may change the result, which for integer weights is exact.
+DEF_TEST(ImageFilterMatrixConvolutionSeparable, reporter) {
+    const int kWidth = 300, kHeight = 280;
+    SkRandom rand;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight),
+                                                             bitmap));
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+
+    const int rowWeights[5] = { 1, 2, 3, 2, 1 },
+              colWeights[3] = { 1, 2, 1 };
+    SkScalar kernel[15];
+    for (int y = 0; y < 3; ++y) {
+        for (int x = 0; x < 5; ++x) {
+            kernel[y * 5 + x] = SkIntToScalar(rowWeights[x] * colWeights[y]);
+        }
+    }
+    const SkScalar gain = 1.0f / 36, bias = 0.1f;
+    sk_sp<SkImageFilter> filter(SkImageFilters::MatrixConvolution(
+            SkISize::Make(5, 3), kernel, gain, bias, SkIPoint::Make(2, 1), SkTileMode::kClamp,
+            true, nullptr));
+
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(3);
+    for (SkExecutor* executor : { (SkExecutor*)nullptr, pool.get() }) {
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr,
+                                        noColorSpace, executor);
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result(as_IFB(filter)->filterImage(src.get(), ctx, &offset));
+        SkBitmap actual;
+        if (!result || !result->getROPixels(&actual)) {
+            ERRORF(reporter, "No result");
+            continue;
+        }
+
+        int mismatches = 0;
+        for (int y = 0; y < actual.height(); ++y) {
+            for (int x = 0; x < actual.width(); ++x) {
+                int sums[4] = { 0, 0, 0, 0 };
+                for (int cy = 0; cy < 3; ++cy) {
+                    for (int cx = 0; cx < 5; ++cx) {
+                        // The input is padded with transparent black out to the result's
+                        // bounds, and the padded input is clamped.
+                        int sx = SkTPin(x + cx - 2, 0, actual.width() - 1) + offset.x(),
+                            sy = SkTPin(y + cy - 1, 0, actual.height() - 1) + offset.y();
+                        if (!SkIRect::MakeWH(kWidth, kHeight).contains(sx, sy)) {
+                            continue;
+                        }
+                        const uint8_t* p = (const uint8_t*)bitmap.getAddr32(sx, sy);
+                        for (int c = 0; c < 4; ++c) {
+                            sums[c] += p[c] * rowWeights[cx] * colWeights[cy];
+                        }
+                    }
+                }
+                uint8_t channels[4];
+                for (int c = 0; c < 4; ++c) {
+                    channels[c] = SkTPin(sk_float_floor2int(sums[c] * gain + bias), 0, 255);
+                }
+                const int alpha = channels[SK_A32_SHIFT / 8];
+                for (int c = 0; c < 4; ++c) {
+                    channels[c] = SkTMin<int>(channels[c], alpha);
+                }
+                SkPMColor expected;
+                memcpy(&expected, channels, 4);
+                mismatches += expected != *actual.getAddr32(x, y);
+            }
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches, "%s: %d mismatches",
+                        executor ? "executor" : "serial", mismatches);
+    }
+}
+
+// The raster lighting filters light each row's interior four pixels at a time and large images in
+// bands on the executor. A flat surface faces the viewer everywhere, so a distant light shades it
+// evenly, borders included; and banding must not change any filter's result.
+DEF_TEST(ImageFilterLightingRows, reporter) {
+    const int kWidth = 301, kHeight = 290;
+    SkBitmap flat;
+    flat.allocN32Pixels(kWidth, kHeight);
+    flat.eraseColor(SK_ColorWHITE);
+    SkBitmap bumpy;
+    bumpy.allocN32Pixels(kWidth, kHeight);
+    SkRandom rand;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *bumpy.getAddr32(x, y) = SkPreMultiplyARGB(rand.nextULessThan(256), 255, 255, 255);
+        }
+    }
+    SkImageFilter_Base::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+    std::unique_ptr<SkExecutor> pool = SkExecutor::MakeFIFOThreadPool(3);
+
+    auto filter = [&](const sk_sp<SkImageFilter>& f, const SkBitmap& bitmap, SkExecutor* executor,
+                      SkBitmap* result) {
+        sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(
+                SkIRect::MakeWH(kWidth, kHeight), bitmap));
+        SkImageFilter_Base::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr,
+                                        noColorSpace, executor);
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> image(as_IFB(f)->filterImage(src.get(), ctx, &offset));
+        return image && image->getROPixels(result);
+    };
+
+    const SkPoint3 direction = SkPoint3::Make(0.6f, 0, 0.8f);
+    SkBitmap lit;
+    REPORTER_ASSERT(reporter, filter(SkImageFilters::DistantLitDiffuse(direction, SK_ColorWHITE,
+                                                                       3, 1, nullptr),
+                                     flat, pool.get(), &lit));
+    const SkPMColor expected = SkPackARGB32(255, 204, 204, 204);
+    int mismatches = 0;
+    for (int y = 0; y < lit.height(); ++y) {
+        for (int x = 0; x < lit.width(); ++x) {
+            mismatches += expected != *lit.getAddr32(x, y);
+        }
+    }
+    REPORTER_ASSERT(reporter, 0 == mismatches, "%d mismatches", mismatches);
+
+    const SkPoint3 location = SkPoint3::Make(40, 60, 50),
+                   target = SkPoint3::Make(200, 150, 0);
+    sk_sp<SkImageFilter> filters[] = {
+        SkImageFilters::DistantLitDiffuse(direction, SK_ColorWHITE, 2, 1.5f, nullptr),
+        SkImageFilters::PointLitDiffuse(location, SK_ColorCYAN, 1.5f, 2, nullptr),
+        SkImageFilters::SpotLitDiffuse(location, target, 1.5f, 30, SK_ColorWHITE, 1, 2, nullptr),
+        SkImageFilters::DistantLitSpecular(direction, SK_ColorWHITE, 2, 1, 8, nullptr),
+        SkImageFilters::PointLitSpecular(location, SK_ColorYELLOW, 1.5f, 1, 20, nullptr),
+        SkImageFilters::SpotLitSpecular(location, target, 2, 40, SK_ColorWHITE, 1, 1, 5, nullptr),
+    };
+    for (const sk_sp<SkImageFilter>& f : filters) {
+        SkBitmap serial, banded;
+        REPORTER_ASSERT(reporter, filter(f, bumpy, nullptr, &serial));
+        REPORTER_ASSERT(reporter, filter(f, bumpy, pool.get(), &banded));
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(serial, banded));
+    }
+}
@@ -6,6 +6,8 @@
  */
 
 #include "include/core/SkPathMeasure.h"
+#include "include/private/SkTemplates.h"
+#include "src/core/SkPointPriv.h"
 #include "tests/Test.h"
 
 static void test_small_segment3() {
@@ -306,3 +308,49 @@ DEF_TEST(contour_measure, reporter) {
     test_empty_contours(reporter);
     test_MLM_contours(reporter);
 }
+
+DEF_TEST(contour_measure_batch, reporter) {
+    SkPath path;
+    path.moveTo(10, 10).lineTo(50, 10)
+        .quadTo(90, 10, 90, 50)
+        .conicTo(90, 90, 50, 90, 0.5f)
+        .cubicTo(30, 90, 10, 60, 10, 40)
+        .cubicTo(10, 10, 10, 10, 30, 20)   // degenerate tangent at t == 0
+        .close();
+
+    SkContourMeasureIter fact(path, false);
+    auto cm = fact.next();
+    REPORTER_ASSERT(reporter, cm);
+
+    // Sorted, with out-of-range, repeated, and end point distances.
+    const SkScalar length = cm->length();
+    SkTDArray<SkScalar> distances;
+    distances.push_back(-5);
+    distances.push_back(0);
+    for (int i = 0; i <= 1000; ++i) {
+        distances.push_back(length * i / 1000);
+    }
+    distances.push_back(length);
+    distances.push_back(length + 5);
+
+    const int count = distances.count();
+    SkAutoTMalloc<SkPoint>  pos(count);
+    SkAutoTMalloc<SkVector> tan(count);
+    REPORTER_ASSERT(reporter, cm->getPosTan(distances.begin(), count, pos.get(), tan.get()));
+
+    for (int i = 0; i < count; ++i) {
+        SkPoint  p;
+        SkVector v;
+        REPORTER_ASSERT(reporter, cm->getPosTan(distances[i], &p, &v));
+        REPORTER_ASSERT(reporter, SkPointPriv::EqualsWithinTolerance(p, pos[i]));
+        REPORTER_ASSERT(reporter, SkPointPriv::EqualsWithinTolerance(v, tan[i]));
+    }
+
+    // Either output may be skipped.
+    SkAutoTMalloc<SkPoint>  pos2(count);
+    REPORTER_ASSERT(reporter, cm->getPosTan(distances.begin(), count, pos2.get(), nullptr));
+    REPORTER_ASSERT(reporter, !memcmp(pos.get(), pos2.get(), count * sizeof(SkPoint)));
+
+    const SkScalar bad[] = { 0, SK_ScalarNaN };
+    REPORTER_ASSERT(reporter, !cm->getPosTan(bad, 2, pos.get(), tan.get()));
+}
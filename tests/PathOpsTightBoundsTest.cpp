@@ -199,3 +199,19 @@ DEF_TEST(PathOpsTightBoundsIllBehavedScaled, reporter) {
     REPORTER_ASSERT(reporter, tight.right() == 1048576);
     REPORTER_ASSERT(reporter, tight.bottom() == 1048576);
 }
+
+DEF_TEST(PathOpsTightBoundsCached, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.quadTo(50, 100, 100, 0);
+    SkRect first, second;
+    REPORTER_ASSERT(reporter, TightBounds(path, &first));
+    REPORTER_ASSERT(reporter, TightBounds(path, &second));
+    REPORTER_ASSERT(reporter, first == second);
+    REPORTER_ASSERT(reporter, first.fBottom < 100);
+
+    // Editing the path must not return the stale bounds.
+    path.lineTo(0, 200);
+    REPORTER_ASSERT(reporter, TightBounds(path, &second));
+    REPORTER_ASSERT(reporter, second.fBottom == 200);
+}
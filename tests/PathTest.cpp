@@ -21,7 +21,9 @@
 #include "include/utils/SkRandom.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkPathAccel.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkReadBuffer.h"
 #include "src/core/SkReader32.h"
 #include "src/core/SkWriter32.h"
 #include "tests/Test.h"
@@ -4622,6 +4624,70 @@ DEF_TEST(PathContains, reporter) {
     test_contains(reporter);
 }
 
+// Large paths queried repeatedly use SkPathAccel's winding tree; it must agree with a plain walk.
+DEF_TEST(PathContainsWindingTree, reporter) {
+    SkRandom rand;
+    SkPath path;
+    for (int c = 0; c < 20; ++c) {
+        path.moveTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        for (int i = 0; i < 10; ++i) {
+            switch (rand.nextULessThan(4)) {
+                case 0:
+                    // integer coordinates make for lots of on-curve and end point queries
+                    path.lineTo(rand.nextULessThan(100), rand.nextULessThan(100));
+                    break;
+                case 1:
+                    path.quadTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                                rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+                    break;
+                case 2:
+                    path.conicTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                                 rand.nextRangeF(0, 100), rand.nextRangeF(0, 100), 2);
+                    break;
+                default:
+                    path.cubicTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                                 rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                                 rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+                    break;
+            }
+        }
+        if (c & 1) {
+            path.close();
+        }
+    }
+    REPORTER_ASSERT(reporter, path.countVerbs() >= SkPathAccel::kMinVerbsForWindingTree);
+
+    for (auto fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType,
+                           SkPath::kInverseWinding_FillType }) {
+        path.setFillType(fillType);
+        for (int i = 0; i < 2000; ++i) {
+            SkPoint pt = i & 1 ? SkPoint::Make(rand.nextULessThan(101), rand.nextULessThan(101))
+                               : SkPoint::Make(rand.nextRangeF(-1, 101), rand.nextRangeF(-1, 101));
+            if (i % 10 == 0) {
+                pt = path.getPoint(rand.nextULessThan(path.countPoints()));
+            }
+            // A fresh path ref has never been queried, so it walks all of its segments.
+            SkPath fresh;
+            fresh.addPath(path);
+            fresh.setFillType(fillType);
+            REPORTER_ASSERT(reporter, path.contains(pt.fX, pt.fY) == fresh.contains(pt.fX, pt.fY));
+        }
+    }
+    REPORTER_ASSERT(reporter, SkPathPriv::Accel(path)->windingTree(path));
+
+    // Editing the path discards the tree.
+    path.setFillType(SkPath::kWinding_FillType);
+    path.transform(SkMatrix::MakeScale(0.5f));
+    path.addRect(SkRect::MakeLTRB(60, 60, 100, 100));
+    for (int i = 0; i < 200; ++i) {
+        SkPoint pt = SkPoint::Make(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        SkPath fresh;
+        fresh.addPath(path);
+        REPORTER_ASSERT(reporter, path.contains(pt.fX, pt.fY) == fresh.contains(pt.fX, pt.fY));
+    }
+    REPORTER_ASSERT(reporter, path.contains(80, 80));
+}
+
 DEF_TEST(Paths, reporter) {
     test_fuzz_crbug_647922();
     test_fuzz_crbug_643933();
@@ -4915,6 +4981,149 @@ DEF_TEST(PathRefSerialization, reporter) {
     }
 }
 
+static void check_points_near(skiatest::Reporter* reporter, const SkPath& a, const SkPath& b,
+                              SkScalar tolerance) {
+    REPORTER_ASSERT(reporter, a.countPoints() == b.countPoints());
+    REPORTER_ASSERT(reporter, a.countVerbs() == b.countVerbs());
+    REPORTER_ASSERT(reporter, a.getFillType() == b.getFillType());
+    REPORTER_ASSERT(reporter, !memcmp(SkPathPriv::VerbData(a), SkPathPriv::VerbData(b),
+                                      SkTMin(a.countVerbs(), b.countVerbs())));
+    for (int i = 0; i < SkTMin(a.countPoints(), b.countPoints()); ++i) {
+        SkVector d = a.getPoint(i) - b.getPoint(i);
+        REPORTER_ASSERT(reporter, SkScalarAbs(d.fX) <= tolerance &&
+                                  SkScalarAbs(d.fY) <= tolerance);
+    }
+}
+
+DEF_TEST(PathCompactSerialization, reporter) {
+    SkRandom rand;
+    SkPath path;
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    for (int i = 0; i < 50; ++i) {
+        path.moveTo(rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500));
+        path.lineTo(rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500));
+        path.quadTo(rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500),
+                    rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500));
+        path.conicTo(rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500),
+                     rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500), 0.7f);
+        path.cubicTo(rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500),
+                     rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500),
+                     rand.nextRangeF(-500, 500), rand.nextRangeF(-500, 500));
+        if (i & 1) {
+            path.close();
+        }
+    }
+
+    sk_sp<SkData> floatData = SkPathPriv::Serialize(path, SkPathPriv::PointEncoding::kFloat);
+    sk_sp<SkData> halfData = SkPathPriv::Serialize(path, SkPathPriv::PointEncoding::kHalf);
+    sk_sp<SkData> fixedData = SkPathPriv::Serialize(path, SkPathPriv::PointEncoding::kQuantized, 6);
+    REPORTER_ASSERT(reporter, floatData->equals(path.serialize().get()));
+    REPORTER_ASSERT(reporter, halfData->size() < floatData->size());
+    REPORTER_ASSERT(reporter, fixedData->size() < floatData->size());
+
+    const struct {
+        sk_sp<SkData> fData;
+        SkScalar      fTolerance;
+    } recs[] = {
+        { floatData, 0 },
+        { halfData,  0.25f },   // half-floats have 10 fractional bits; |coords| < 512
+        { fixedData, 0.5f / 64 },
+    };
+    for (const auto& rec : recs) {
+        SkPath copied;
+        size_t bytesRead = copied.readFromMemory(rec.fData->data(), rec.fData->size());
+        REPORTER_ASSERT(reporter, bytesRead == rec.fData->size());
+        check_points_near(reporter, path, copied, rec.fTolerance);
+
+        SkPath fromData;
+        bytesRead = SkPathPriv::ReadFromData(&fromData, rec.fData);
+        REPORTER_ASSERT(reporter, bytesRead == rec.fData->size());
+        REPORTER_ASSERT(reporter, fromData == copied);
+
+        // The restored path must continue the same way as the original.
+        SkPath original = path;
+        original.lineTo(7, 8);
+        fromData.lineTo(7, 8);
+        check_points_near(reporter, original, fromData, rec.fTolerance);
+
+        for (size_t length = 0; length < rec.fData->size(); length += 4) {
+            SkPath tooShort;
+            REPORTER_ASSERT(reporter, !tooShort.readFromMemory(rec.fData->data(), length));
+            REPORTER_ASSERT(reporter, tooShort.isEmpty());
+        }
+    }
+
+    // Float data is referenced in place, until the path is edited.
+    {
+        SkPath borrowed;
+        REPORTER_ASSERT(reporter, SkPathPriv::ReadFromData(&borrowed, floatData));
+        REPORTER_ASSERT(reporter, borrowed == path);
+        const void* pts = SkPathPriv::PointData(borrowed);
+        REPORTER_ASSERT(reporter, pts > floatData->data() &&
+                                  pts < floatData->bytes() + floatData->size());
+        REPORTER_ASSERT(reporter, borrowed.getBounds() == path.getBounds());
+
+        SkPath shared = borrowed;
+        borrowed.transform(SkMatrix::MakeTrans(10, 10));
+        borrowed.lineTo(0, 0);
+        REPORTER_ASSERT(reporter, SkPathPriv::PointData(borrowed) != pts);
+        REPORTER_ASSERT(reporter, SkPathPriv::PointData(shared) == pts);
+        REPORTER_ASSERT(reporter, shared == path);
+
+        SkPath rewound = shared;
+        shared.rewind();
+        REPORTER_ASSERT(reporter, shared.isEmpty());
+        REPORTER_ASSERT(reporter, rewound == path);
+    }
+
+    // So is a path read through an SkReadBuffer backed by the data, as pictures read lazily are.
+    {
+        SkBinaryWriteBuffer writer;
+        writer.writeInt(0);  // so the path doesn't start the data
+        writer.writePath(path);
+        sk_sp<SkData> data = SkData::MakeUninitialized(writer.bytesWritten());
+        writer.writeToMemory(data->writable_data());
+        SkReadBuffer reader(data->data(), data->size());
+        reader.setBackingData(data);
+        SkPath borrowed;
+        reader.readInt();
+        reader.readPath(&borrowed);
+        REPORTER_ASSERT(reporter, reader.isValid() && reader.eof());
+        REPORTER_ASSERT(reporter, borrowed == path);
+        const void* pts = SkPathPriv::PointData(borrowed);
+        REPORTER_ASSERT(reporter, pts > data->data() && pts < data->bytes() + data->size());
+    }
+
+    // A path that alone refers to the data can still be transformed in place.
+    {
+        SkPath borrowed;
+        REPORTER_ASSERT(reporter, SkPathPriv::ReadFromData(&borrowed, floatData));
+        borrowed.transform(SkMatrix::MakeTrans(10, 10));
+
+        SkPath expected;
+        path.transform(SkMatrix::MakeTrans(10, 10), &expected);
+        REPORTER_ASSERT(reporter, borrowed == expected);
+        REPORTER_ASSERT(reporter, borrowed.getBounds() == expected.getBounds());
+    }
+
+    // Points that don't fit a lossy encoding fall back to floats.
+    {
+        SkPath big;
+        big.moveTo(0, 0);
+        big.lineTo(1e6f, 1e6f);
+        big.lineTo(SK_ScalarNaN, 2);
+        for (auto encoding : { SkPathPriv::PointEncoding::kHalf,
+                               SkPathPriv::PointEncoding::kQuantized }) {
+            sk_sp<SkData> data = SkPathPriv::Serialize(big, encoding, 16);
+            SkPath readBack;
+            REPORTER_ASSERT(reporter, readBack.readFromMemory(data->data(), data->size()));
+            REPORTER_ASSERT(reporter, readBack.countPoints() == 3);
+            REPORTER_ASSERT(reporter, readBack.getPoint(1) == big.getPoint(1));
+            REPORTER_ASSERT(reporter, SkScalarIsNaN(readBack.getPoint(2).fX));
+        }
+    }
+}
+
 DEF_TEST(NonFinitePathIteration, reporter) {
     SkPath path;
     path.moveTo(SK_ScalarInfinity, SK_ScalarInfinity);
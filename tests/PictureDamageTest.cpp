@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRegion.h"
+#include "include/utils/SkPictureDamage.h"
+#include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+// A frame of an animation: a background and some shapes that stay put, and sprites that move.
+static sk_sp<SkPicture> make_frame(const SkScalar spriteX[], int spriteCount, bool extraOp) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(256, 256);
+    canvas->drawColor(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorGRAY);
+    for (int i = 0; i < 8; ++i) {
+        canvas->drawCircle(16 + i * 30, 200, 12, paint);
+    }
+    paint.setAntiAlias(false);
+    paint.setColor(SK_ColorBLUE);
+    for (int i = 0; i < spriteCount; ++i) {
+        canvas->save();
+        canvas->translate(spriteX[i], i * 12);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+        canvas->restore();
+    }
+    if (extraOp) {
+        canvas->drawRect(SkRect::MakeXYWH(100, 100, 5, 5), paint);
+    }
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(0, 240, 256, 16), paint);
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw(const SkPicture& picture) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(256, 256);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas(bitmap).drawPicture(&picture);
+    return bitmap;
+}
+
+DEF_TEST(PictureDamage, r) {
+    const SkScalar x0[] = { 10, 50, 90, 130 },
+                   x1[] = { 10, 50, 95, 130 };
+    sk_sp<SkPicture> before = make_frame(x0, 4, false),
+                     after  = make_frame(x1, 4, false);
+
+    SkRegion damage;
+    SkPictureDamage::Compute(*before, *before, &damage);
+    REPORTER_ASSERT(r, damage.isEmpty());
+
+    // Only the moved sprite is damaged.
+    SkPictureDamage::Compute(*before, *after, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(90, 24, 105, 34));
+
+    // Drawing just the damage over the old frame gives the new frame.
+    SkBitmap incremental = draw(*before);
+    {
+        SkCanvas canvas(incremental);
+        SkPictureDamage::Replay(*after, damage, &canvas);
+    }
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(incremental, draw(*after)));
+
+    // When ops are added, everything between the ops both frames start and end with is damaged.
+    sk_sp<SkPicture> extra = make_frame(x0, 4, true);
+    SkPictureDamage::Compute(*before, *extra, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(100, 100, 105, 105));
+    SkPictureDamage::Compute(*after, *extra, &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(90, 24, 140, 105));
+
+    // Many changes are merged into their bounds.
+    const SkScalar x2[] = { 12, 52, 92, 132 };
+    sk_sp<SkPicture> moved = make_frame(x2, 4, false);
+    SkPictureDamage::Compute(*before, *moved, &damage);
+    REPORTER_ASSERT(r, !damage.isRect());
+    SkPictureDamage::Compute(*before, *moved, &damage, 2);
+    REPORTER_ASSERT(r, damage.isRect());
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(10, 0, 142, 46));
+
+    // Damage for a range of ops is their bounds.
+    damage.setEmpty();
+    SkPictureDamage::AddOps(*before, before->approximateOpCount() - 1,
+                            before->approximateOpCount(), &damage);
+    REPORTER_ASSERT(r, damage.getBounds() == SkIRect::MakeLTRB(0, 240, 256, 256));
+}
@@ -5,13 +5,19 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "src/shaders/SkPictureShader.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+#include <vector>
 
 // Test that the SkPictureShader cache is purged on shader deletion.
 DEF_TEST(PictureShader_caching, reporter) {
@@ -46,3 +52,84 @@ DEF_TEST(PictureShader_caching, reporter) {
     // All but the local ref should be gone now.
     REPORTER_ASSERT(reporter, picture->unique());
 }
+
+namespace {
+// Runs work only when asked to.
+class DeferredExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { fWork.push_back(std::move(work)); }
+
+    int count() const { return SkToInt(fWork.size()); }
+
+    void run() {
+        std::vector<std::function<void(void)>> work;
+        work.swap(fWork);
+        for (auto& w : work) {
+            w();
+        }
+    }
+
+private:
+    std::vector<std::function<void(void)>> fWork;
+};
+
+// Runs work right away.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { work(); }
+};
+}  // namespace
+
+// Test that with a tile executor, picture shaders draw new scales with a tile of a nearby level
+// until the exact tile has been rasterized, and then draw just as they do without one.
+DEF_TEST(PictureShader_tileExecutor, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recording = recorder.beginRecording(64, 64);
+    recording->drawColor(SK_ColorWHITE);
+    SkPaint circlePaint;
+    circlePaint.setColor(SK_ColorBLUE);
+    circlePaint.setAntiAlias(true);
+    recording->drawCircle(32, 32, 20, circlePaint);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    auto draw = [](const sk_sp<SkShader>& shader, SkScalar scale) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(128, 128);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        canvas.scale(scale, scale);
+        SkPaint paint;
+        paint.setShader(shader);
+        canvas.drawPaint(paint);
+        return bitmap;
+    };
+    auto makeShader = [&] { return picture->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat); };
+
+    const SkBitmap expected = draw(makeShader(), 1.1f);
+
+    {
+        InlineExecutor executor;
+        SkGraphics::SetPictureShaderTileExecutor(&executor);
+        sk_sp<SkShader> shader = makeShader();
+        draw(shader, 1);
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(draw(shader, 1.1f), expected));
+    }
+    {
+        DeferredExecutor executor;
+        SkGraphics::SetPictureShaderTileExecutor(&executor);
+        sk_sp<SkShader> shader = makeShader();
+        draw(shader, 1);
+        REPORTER_ASSERT(reporter, executor.count() == 0);
+
+        // The tile drawn at scale 1 stands in for the one at 1.1, which is rasterized only once.
+        SkBitmap nearby = draw(shader, 1.1f);
+        draw(shader, 1.1f);
+        REPORTER_ASSERT(reporter, executor.count() == 1, "%d", executor.count());
+        REPORTER_ASSERT(reporter, nearby.getColor(64, 64) != SK_ColorTRANSPARENT);
+
+        executor.run();
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(draw(shader, 1.1f), expected));
+        REPORTER_ASSERT(reporter, executor.count() == 0);
+    }
+    SkGraphics::SetPictureShaderTileExecutor(nullptr);
+}
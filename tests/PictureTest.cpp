@@ -11,20 +11,27 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFontStyle.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkMultiPictureDraw.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/utils/SkNWayCanvas.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBBoxHierarchy.h"
 #include "src/core/SkBigPicture.h"
@@ -33,7 +40,9 @@
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
+#include <atomic>
 #include <memory>
 
 class SkRRect;
@@ -713,6 +722,121 @@ DEF_TEST(Picture_SkipBBH, r) {
     REPORTER_ASSERT(r, bbh.searchCalls == 1);
 }
 
+// Pictures played back a few times switch to an SkRecordPlan, which must draw just the same.
+DEF_TEST(Picture_PlaybackPlan, r) {
+    auto draw = [](SkCanvas* canvas, bool outsideCull) {
+        SkRandom rand;
+        SkPaint paint;
+        for (int i = 0; i < 40; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            paint.setAntiAlias(rand.nextBool());
+            canvas->save();
+                canvas->translate(rand.nextRangeScalar(0, 320), rand.nextRangeScalar(0, 240));
+                canvas->rotate(rand.nextRangeScalar(0, 90));
+                canvas->clipRect(SkRect::MakeWH(40, 40));
+                canvas->drawCircle(20, 20, rand.nextRangeScalar(5, 30), paint);
+            canvas->restore();
+        }
+        paint.setAlpha(0x80);
+        canvas->saveLayer(nullptr, &paint);
+            canvas->clipRect(SkRect::MakeXYWH(100, 100, 120, 60));
+            canvas->drawColor(SK_ColorBLUE);
+        canvas->restore();
+        if (outsideCull) {
+            // Only a BBH may cull this away.
+            canvas->drawRect(SkRect::MakeXYWH(330, 250, 20, 20), SkPaint());
+        }
+    };
+
+    SkRTreeFactory factory;
+    for (SkBBHFactory* bbhFactory : {(SkBBHFactory*)nullptr, (SkBBHFactory*)&factory}) {
+        SkPictureRecorder recorder;
+        draw(recorder.beginRecording(SkRect::MakeWH(320, 240), bbhFactory), !bbhFactory);
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        const size_t bytesWithoutPlan = picture->approximateBytesUsed();
+
+        for (SkRect clip : {SkRect::MakeWH(400, 300), SkRect::MakeXYWH(30, 40, 128, 128),
+                            SkRect::MakeXYWH(300, 200, 60, 60)}) {
+            SkBitmap expected;
+            expected.allocN32Pixels(400, 300);
+            expected.eraseColor(SK_ColorWHITE);
+            SkCanvas expectedCanvas(expected);
+            expectedCanvas.clipRect(clip);
+            draw(&expectedCanvas, !bbhFactory);
+
+            for (int i = 0; i < 4; i++) {
+                SkBitmap actual;
+                actual.allocN32Pixels(400, 300);
+                actual.eraseColor(SK_ColorWHITE);
+                SkCanvas actualCanvas(actual);
+                actualCanvas.clipRect(clip);
+                picture->playback(&actualCanvas);
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual),
+                                "bbh %d, clip %g %g, playback %d",
+                                bbhFactory != nullptr, clip.fLeft, clip.fTop, i);
+            }
+        }
+
+        // The plan keeps a function and an op pointer for each op.
+        REPORTER_ASSERT(r, picture->approximateBytesUsed() >=
+                           bytesWithoutPlan + picture->approximateOpCount() * 2 * sizeof(void*));
+    }
+
+    // A BBH still finds the ops for clipped playbacks once the picture has a plan.
+    SkRect bound = SkRect::MakeWH(320, 240);
+    CountingBBH bbh(bound);
+    SpoonFedBBHFactory countingFactory(&bbh);
+    SkPictureRecorder recorder;
+    draw(recorder.beginRecording(bound, &countingFactory), false);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    SkCanvas big(640, 480), small(300, 200);
+    for (int i = 0; i < 4; i++) {
+        picture->playback(&big);
+        picture->playback(&small);
+    }
+    REPORTER_ASSERT(r, bbh.searchCalls == 4, "%d searches", bbh.searchCalls);
+}
+
+// Serializing plays the picture into a recording canvas whose clip starts at the origin, whatever
+// the cull rect. However often the picture was drawn before, that must not drop any ops.
+DEF_TEST(Picture_PlaybackPlanSerialize, r) {
+    const SkRect cull = SkRect::MakeLTRB(-10, -10, 90, 90);
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeLTRB(-10, -10, -5, -5), paint);
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeLTRB(40, 40, 60, 60), paint);
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeLTRB(85, 85, 90, 90), paint);
+    };
+    SkPictureRecorder recorder;
+    draw(recorder.beginRecording(cull));
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    auto render = [](const SkPicture* picture) {
+        SkBitmap bm;
+        bm.allocN32Pixels(100, 100);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        canvas.translate(10, 10);
+        canvas.drawPicture(picture);
+        return bm;
+    };
+    const SkBitmap expected = render(picture.get());
+    for (int i = 0; i < 3; i++) {
+        render(picture.get());
+    }
+
+    sk_sp<SkData> data = picture->serialize();
+    sk_sp<SkPicture> back = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, back && back->approximateOpCount() == picture->approximateOpCount(),
+                    "%d ops", back ? back->approximateOpCount() : -1);
+    if (back) {
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, render(back.get())));
+    }
+}
+
 DEF_TEST(Picture_BitmapLeak, r) {
     SkBitmap mut, immut;
     mut.allocN32Pixels(300, 200);
@@ -879,3 +1003,281 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+DEF_TEST(Picture_MakeFromDataLazily, r) {
+    constexpr int kCells = 10,
+                  kCellSize = 100;
+
+    SkPictureRecorder subRecorder;
+    SkCanvas* subCanvas = subRecorder.beginRecording(SkRect::MakeWH(kCellSize, kCellSize));
+    SkBitmap subBitmap;
+    make_bm(&subBitmap, 8, 8, SK_ColorMAGENTA, true);
+    subCanvas->drawRect(SkRect::MakeXYWH(10, 10, 30, 30), SkPaint());
+    subCanvas->drawImageRect(SkImage::MakeFromBitmap(subBitmap), SkRect::MakeXYWH(50, 50, 40, 40),
+                             nullptr);
+    sk_sp<SkPicture> sub = subRecorder.finishRecordingAsPicture();
+
+    // A grid of cells, each clipped to itself with its own path and image.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kCells * kCellSize, kCells * kCellSize);
+    for (int y = 0; y < kCells; ++y) {
+        for (int x = 0; x < kCells; ++x) {
+            SkColor color = SkColorSetRGB(x * 25, y * 25, 128);
+            SkBitmap bm;
+            make_bm(&bm, 8, 8, color, true);
+
+            canvas->save();
+            canvas->translate(x * kCellSize, y * kCellSize);
+            canvas->clipRect(SkRect::MakeWH(kCellSize, kCellSize));
+            SkPath path;
+            path.addCircle(50, 50, SkIntToScalar(10 + x + y));
+            SkPaint paint;
+            paint.setColor(color ^ 0x00FFFFFF);
+            paint.setAntiAlias(true);
+            canvas->drawPath(path, paint);
+            canvas->drawImageRect(SkImage::MakeFromBitmap(bm), SkRect::MakeXYWH(20, 20, 60, 60),
+                                  nullptr);
+            if (x == y && (x == 0 || x == kCells - 1)) {
+                canvas->drawPicture(sub);
+            }
+            canvas->restore();
+        }
+    }
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    // Images are written as their color, and counted as they are read back.
+    SkSerialProcs serialProcs;
+    serialProcs.fIndexPictureOps = true;
+    serialProcs.fImageProc = [](SkImage* image, void*) {
+        SkPixmap pixmap;
+        SkColor color = image->peekPixels(&pixmap) ? pixmap.getColor(0, 0) : SK_ColorTRANSPARENT;
+        return SkData::MakeWithCopy(&color, sizeof(color));
+    };
+    int decodes = 0;
+    SkDeserialProcs deserialProcs;
+    deserialProcs.fImageCtx = &decodes;
+    deserialProcs.fImageProc = [](const void* data, size_t size, void* ctx) -> sk_sp<SkImage> {
+        *static_cast<int*>(ctx) += 1;
+        SkColor color;
+        if (size != sizeof(color)) {
+            return nullptr;
+        }
+        memcpy(&color, data, sizeof(color));
+        SkBitmap bm;
+        make_bm(&bm, 8, 8, color, true);
+        return SkImage::MakeFromBitmap(bm);
+    };
+
+    auto draw = [](const SkPicture* picture, const SkIRect& tile) {
+        SkBitmap bm;
+        bm.allocN32Pixels(tile.width(), tile.height());
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        canvas.translate(-SkIntToScalar(tile.x()), -SkIntToScalar(tile.y()));
+        canvas.drawPicture(picture);
+        return bm;
+    };
+
+    sk_sp<SkData> data = pic->serialize(&serialProcs);
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(data.get(), &deserialProcs);
+    REPORTER_ASSERT(r, eager && SkPicturePriv::AsSkBigPicture(eager));
+    decodes = 0;
+    sk_sp<SkPicture> lazy = SkPicture::MakeFromDataLazily(data, &deserialProcs);
+    REPORTER_ASSERT(r, lazy && !SkPicturePriv::AsSkBigPicture(lazy));
+    REPORTER_ASSERT(r, decodes == 0, "%d images read up front", decodes);
+
+    // The tile overlaps the images of cells 3 to 5 along each axis.
+    const SkIRect tile = SkIRect::MakeXYWH(320, 320, 256, 256);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw(lazy.get(), tile), draw(pic.get(), tile)));
+    REPORTER_ASSERT(r, decodes == 9, "%d images read for the tile", decodes);
+
+    // Drawing everything reads each image once, including the shared one in the sub-picture.
+    const SkIRect all = SkIRect::MakeWH(kCells * kCellSize, kCells * kCellSize);
+    const SkBitmap expected = draw(pic.get(), all);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw(lazy.get(), all), expected));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw(lazy.get(), all), expected));
+    REPORTER_ASSERT(r, decodes == kCells * kCells + 1, "%d images read in all", decodes);
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw(eager.get(), all), expected));
+
+    // Without the index, pictures are read as MakeFromData() reads them.
+    serialProcs.fIndexPictureOps = false;
+    sk_sp<SkPicture> unindexed = SkPicture::MakeFromDataLazily(pic->serialize(&serialProcs),
+                                                               &deserialProcs);
+    REPORTER_ASSERT(r, unindexed && SkPicturePriv::AsSkBigPicture(unindexed));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(draw(unindexed.get(), all), expected));
+
+    // The lazy picture serializes like any other.
+    sk_sp<SkPicture> roundTrip = SkPicture::MakeFromData(lazy->serialize(&serialProcs).get(),
+                                                         &deserialProcs);
+    REPORTER_ASSERT(r, roundTrip && ToolUtils::equal_pixels(draw(roundTrip.get(), all), expected));
+}
+
+DEF_TEST(Picture_SerializeWithExecutor, r) {
+    auto image = [](SkColor color) {
+        SkBitmap bm;
+        make_bm(&bm, 16, 16, color, true);
+        return SkImage::MakeFromBitmap(bm);
+    };
+
+    // Sub-pictures two deep, each with images of their own, and one shared between them.
+    sk_sp<SkImage> shared = image(SK_ColorGREEN);
+    sk_sp<SkPicture> inner;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(64, 64);
+        canvas->drawImage(image(SK_ColorRED), 0, 0);
+        canvas->drawImage(shared, 32, 32);
+        inner = recorder.finishRecordingAsPicture();
+    }
+    sk_sp<SkPicture> middle;
+    {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(128, 128);
+        canvas->drawPicture(inner);
+        canvas->translate(64, 64);
+        canvas->drawPicture(inner);
+        canvas->drawImage(image(SK_ColorBLUE), 0, 0);
+        middle = recorder.finishRecordingAsPicture();
+    }
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(256, 256);
+    for (int i = 0; i < 16; ++i) {
+        canvas->drawImage(image(SkColorSetRGB(i * 16, 255 - i * 16, 64)), (i % 4) * 64,
+                          (i / 4) * 64);
+    }
+    canvas->drawImage(shared, 100, 100);
+    canvas->drawPicture(middle);
+    canvas->translate(128, 128);
+    canvas->drawPicture(middle);
+    SkPaint paint;
+    paint.setShader(shared->makeShader());
+    canvas->drawRect(SkRect::MakeWH(64, 64), paint);
+    sk_sp<SkPicture> pic = recorder.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Images are written as their color.
+    SkSerialImageProc colorProc = [](SkImage* image, void*) {
+        SkPixmap pixmap;
+        SkColor color = image->peekPixels(&pixmap) ? pixmap.getColor(0, 0) : SK_ColorTRANSPARENT;
+        return SkData::MakeWithCopy(&color, sizeof(color));
+    };
+
+    // The output does not depend on the executor, whether images are encoded by Skia or a proc.
+    for (bool index : {false, true}) {
+        for (bool proc : {false, true}) {
+            SkSerialProcs procs;
+            procs.fIndexPictureOps = index;
+            procs.fImageProc = proc ? colorProc : nullptr;
+            sk_sp<SkData> serial = pic->serialize(&procs);
+            procs.fExecutor = executor.get();
+            sk_sp<SkData> parallel = pic->serialize(&procs);
+            REPORTER_ASSERT(r, serial->equals(parallel.get()), "index %d, proc %d", index, proc);
+        }
+    }
+
+    // Images decode on the executor into the same picture.
+    std::atomic<int> decodes{0};
+    SkDeserialProcs procs;
+    procs.fExecutor = executor.get();
+    procs.fImageCtx = &decodes;
+    procs.fImageProc = [](const void* data, size_t size, void* ctx) -> sk_sp<SkImage> {
+        static_cast<std::atomic<int>*>(ctx)->fetch_add(1);
+        SkColor color;
+        if (size != sizeof(color)) {
+            return nullptr;
+        }
+        memcpy(&color, data, sizeof(color));
+        SkBitmap bm;
+        make_bm(&bm, 16, 16, color, true);
+        return SkImage::MakeFromBitmap(bm);
+    };
+    SkSerialProcs serialProcs;
+    serialProcs.fImageProc = colorProc;
+    sk_sp<SkPicture> back = SkPicture::MakeFromData(pic->serialize(&serialProcs).get(), &procs);
+    REPORTER_ASSERT(r, back);
+    // 17 at the top and one more in the shader, one in middle and two in inner.
+    REPORTER_ASSERT(r, decodes == 21, "%d images decoded", decodes.load());
+
+    auto draw = [](const SkPicture* picture) {
+        SkBitmap bm;
+        bm.allocN32Pixels(256, 256);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        canvas.drawPicture(picture);
+        return bm;
+    };
+    SkBitmap expected = draw(pic.get()),
+             actual = draw(back.get());
+    REPORTER_ASSERT(r, !memcmp(expected.getPixels(), actual.getPixels(),
+                               expected.computeByteSize()));
+}
+
+DEF_TEST(Picture_MultiPictureDrawRaster, r) {
+    // The default executor may run everything inline, so draw on a pool of our own. Other tests
+    // running meanwhile may pick it up too, so it's never destroyed.
+    static SkExecutor* gPool = SkExecutor::MakeFIFOThreadPool(4).release();
+    SkExecutor& defaultExecutor = SkExecutor::GetDefault();
+    SkExecutor::SetDefault(gPool);
+
+    auto fill = [](SkColor color, const SkRect& rect) {
+        SkPictureRecorder recorder;
+        SkPaint paint;
+        paint.setColor(color);
+        recorder.beginRecording(64, 64)->drawRect(rect, paint);
+        return recorder.finishRecordingAsPicture();
+    };
+    sk_sp<SkPicture> red   = fill(SK_ColorRED,   SkRect::MakeWH(64, 64)),
+                     green = fill(SK_ColorGREEN, SkRect::MakeWH(64, 32)),
+                     blue  = fill(SK_ColorBLUE,  SkRect::MakeWH(32, 32)),
+                     cyan  = fill(SK_ColorCYAN,  SkRect::MakeWH(16, 16)),
+                     black = fill(SK_ColorBLACK, SkRect::MakeWH(8, 8));
+
+    // Three canvases draw into one bitmap, one of them without pixels of its own, and their draws
+    // must stay in order.
+    SkBitmap shared;
+    shared.allocN32Pixels(64, 64);
+    shared.eraseColor(SK_ColorWHITE);
+    SkCanvas first(shared), second(shared), third(shared);
+    SkNWayCanvas forwarding(64, 64);
+    forwarding.addCanvas(&third);
+
+    sk_sp<SkSurface> surfaces[8];
+    for (sk_sp<SkSurface>& surface : surfaces) {
+        surface = SkSurface::MakeRasterN32Premul(64, 64);
+        surface->getCanvas()->clear(SK_ColorWHITE);
+    }
+    SkPictureRecorder recorder;
+    SkCanvas* recording = recorder.beginRecording(64, 64);
+
+    SkMultiPictureDraw mpd;
+    mpd.add(&first, red.get());
+    for (int i = 0; i < 8; ++i) {
+        mpd.add(surfaces[i]->getCanvas(), i % 2 ? red.get() : green.get());
+    }
+    mpd.add(&second, green.get());
+    mpd.add(recording, blue.get());
+    mpd.add(&first, blue.get());
+    for (int i = 0; i < 8; ++i) {
+        mpd.add(surfaces[i]->getCanvas(), blue.get());
+    }
+    mpd.add(&forwarding, cyan.get());
+    mpd.add(&second, black.get());
+    mpd.draw(true);
+    SkExecutor::SetDefault(&defaultExecutor);
+
+    REPORTER_ASSERT(r, shared.getColor( 0,  0) == SK_ColorBLACK);
+    REPORTER_ASSERT(r, shared.getColor(12, 12) == SK_ColorCYAN);
+    REPORTER_ASSERT(r, shared.getColor(20, 20) == SK_ColorBLUE);
+    REPORTER_ASSERT(r, shared.getColor(40,  0) == SK_ColorGREEN);
+    REPORTER_ASSERT(r, shared.getColor( 0, 40) == SK_ColorRED);
+    for (int i = 0; i < 8; ++i) {
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        surfaces[i]->readPixels(bm, 0, 0);
+        REPORTER_ASSERT(r, bm.getColor( 0,  0) == SK_ColorBLUE);
+        REPORTER_ASSERT(r, bm.getColor(40,  0) == (i % 2 ? SK_ColorRED : SK_ColorGREEN));
+        REPORTER_ASSERT(r, bm.getColor( 0, 40) == (i % 2 ? SK_ColorRED : SK_ColorWHITE));
+    }
+    REPORTER_ASSERT(r, recorder.finishRecordingAsPicture()->approximateOpCount() > 0);
+}
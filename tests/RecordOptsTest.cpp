@@ -13,6 +13,7 @@
 #include "include/core/SkSurface.h"
 #include "include/effects/SkImageFilters.h"
 #include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
 #include "src/core/SkRecords.h"
@@ -359,6 +360,235 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     index += 4;
 }
 
+// Records draw twice, applies pass to one of the records, and checks that they both play back to
+// the same pixels.
+static void assert_draws_same(skiatest::Reporter* r, void (*draw)(SkCanvas*),
+                              void (*pass)(SkRecord*)) {
+    SkRecord original, optimized;
+    SkRecorder originalRecorder(&original, W, H),
+               optimizedRecorder(&optimized, W, H);
+    draw(&originalRecorder);
+    draw(&optimizedRecorder);
+    pass(&optimized);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(256, 256);
+    actual.allocN32Pixels(256, 256);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected),
+             actualCanvas(actual);
+    SkRecordDraw(original, &expectedCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+    SkRecordDraw(optimized, &actualCanvas, nullptr, nullptr, 0, nullptr, nullptr);
+
+    for (int y = 0; y < expected.height(); y++) {
+        for (int x = 0; x < expected.width(); x++) {
+            if (*expected.getAddr32(x, y) != *actual.getAddr32(x, y)) {
+                ERRORF(r, "Pixel (%d, %d) is %08x, expected %08x",
+                       x, y, *actual.getAddr32(x, y), *expected.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+static sk_sp<SkImage> make_checker_image() {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            *bitmap.getAddr32(x, y) = (x + y) & 1 ? SK_ColorBLUE : SK_ColorYELLOW;
+        }
+    }
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
+DEF_TEST(RecordOpts_NoopOverdrawnDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, aa;
+    opaque.setColor(SK_ColorRED);
+    translucent.setColor(0x80008000);
+    aa.setAntiAlias(true);
+
+    // 0-4: An opaque DrawPaint overwrites what was drawn since the last clip, but not before.
+    recorder.drawRect(SkRect::MakeWH(200, 200), SkPaint());
+    recorder.clipRect(SkRect::MakeWH(100, 100));
+    recorder.drawOval(SkRect::MakeWH(50, 50), aa);
+    recorder.drawRect(SkRect::MakeWH(300, 300), translucent);
+    recorder.drawPaint(opaque);
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::DrawOval>(r, record, 2);
+    SkRecordNoopOverdrawnDraws(&record);
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::ClipRect>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::NoOp>(r, record, 3);
+    assert_type<SkRecords::DrawPaint>(r, record, 4);
+
+    // 5-9: ... nor what was drawn before the layer it draws into.  A translucent DrawPaint
+    // overwrites nothing.
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.saveLayer(nullptr, nullptr);
+    recorder.drawPaint(translucent);
+    recorder.drawPaint(opaque);
+    recorder.restore();
+    SkRecordNoopOverdrawnDraws(&record);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+    assert_type<SkRecords::NoOp>(r, record, 7);
+    assert_type<SkRecords::DrawPaint>(r, record, 8);
+
+    // 10-14: An opaque aliased DrawRect overwrites aliased draws inside it.
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 10, 10), SkPaint());
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 10, 10), aa);
+    recorder.drawRect(SkRect::MakeXYWH(60, 60, 100, 100), SkPaint());
+    recorder.drawImageRect(make_checker_image(), SkRect::MakeXYWH(20, 20, 30, 30), nullptr);
+    recorder.drawRect(SkRect::MakeLTRB(5, 5, 55, 55), opaque);
+    SkRecordNoopOverdrawnDraws(&record);
+    assert_type<SkRecords::NoOp>(r, record, 10);
+    assert_type<SkRecords::DrawRect>(r, record, 11);
+    assert_type<SkRecords::DrawRect>(r, record, 12);
+    assert_type<SkRecords::NoOp>(r, record, 13);
+    assert_type<SkRecords::DrawRect>(r, record, 14);
+
+    // 15-24: Nothing is overwritten under an antialiased or non-rectangular clip, even in a
+    // nested save or layer, but it is again once that clip is restored away.
+    recorder.save();
+    recorder.clipPath(SkPath().addOval(SkRect::MakeWH(50, 50)), true);
+    recorder.drawRect(SkRect::MakeWH(20, 20), SkPaint());
+    recorder.drawRect(SkRect::MakeWH(30, 30), opaque);
+    recorder.saveLayer(nullptr, nullptr);
+    recorder.drawPaint(opaque);
+    recorder.restore();
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.drawRect(SkRect::MakeWH(30, 30), opaque);
+    SkRecordNoopOverdrawnDraws(&record);
+    assert_type<SkRecords::DrawRect>(r, record, 17);
+    assert_type<SkRecords::DrawRect>(r, record, 18);
+    assert_type<SkRecords::DrawPaint>(r, record, 20);
+    assert_type<SkRecords::NoOp>(r, record, 23);
+    assert_type<SkRecords::DrawRect>(r, record, 24);
+
+    assert_draws_same(r, [](SkCanvas* canvas) {
+        SkPaint red, blue;
+        red.setColor(SK_ColorRED);
+        blue.setColor(SK_ColorBLUE);
+        canvas->clipRRect(SkRRect::MakeOval(SkRect::MakeXYWH(20, 20, 100, 60)), true);
+        canvas->drawRect(SkRect::MakeWH(150, 150), red);
+        canvas->drawRect(SkRect::MakeWH(200, 200), blue);
+        canvas->drawPaint(blue);
+        canvas->save();
+            canvas->clipRect(SkRect::MakeXYWH(40.5f, 30.5f, 50, 50), true);
+            canvas->drawPaint(red);
+            canvas->drawPaint(blue);
+        canvas->restore();
+    }, SkRecordNoopOverdrawnDraws);
+
+    assert_draws_same(r, [](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeWH(200, 200), paint);
+        canvas->save();
+            canvas->translate(10, 10);
+            canvas->clipRect(SkRect::MakeWH(100, 100));
+            paint.setAntiAlias(true);
+            canvas->drawCircle(50, 50, 70, paint);
+            canvas->saveLayer(nullptr, nullptr);
+                canvas->drawCircle(20, 20, 30, paint);
+            canvas->restore();
+            canvas->drawColor(SK_ColorRED);
+        canvas->restore();
+        canvas->scale(2, 2);
+        canvas->drawImage(make_checker_image(), 100, 100);
+        canvas->drawRect(SkRect::MakeXYWH(99, 99, 10, 10), SkPaint());
+    }, SkRecordNoopOverdrawnDraws);
+}
+
+DEF_TEST(RecordOpts_MergeDrawImageRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    sk_sp<SkImage> image = make_checker_image();
+    SkPaint paint, other;
+    paint.setAlphaf(0.5f);
+    other.setColorFilter(SkColorFilters::Blend(SK_ColorRED, SkBlendMode::kModulate));
+
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 0, 10, 10), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 0, 2, 2), SkRect::MakeXYWH(10, 0, 10, 10),
+                           &paint, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawRect(SkRect::MakeWH(1, 1), SkPaint());
+    recorder.drawImageRect(image, SkRect::MakeXYWH(20, 0, 10, 10), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(30, 0, 10, 10), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(40, 0, 10, 10), &other);
+    record.replace<SkRecords::NoOp>(2);  // NoOps should be allowed.
+
+    SkRecordMergeDrawImageRects(&record);
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    if (set) {
+        REPORTER_ASSERT(r, set->count == 4);
+        REPORTER_ASSERT(r, *set->paint == paint);
+        REPORTER_ASSERT(r, set->set[1].fSrcRect == SkRect::MakeWH(2, 2));
+        REPORTER_ASSERT(r, set->set[2].fDstRect == SkRect::MakeXYWH(20, 0, 10, 10));
+    }
+    for (int i = 1; i < 5; i++) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::DrawImageRect>(r, record, 5);
+
+    assert_draws_same(r, [](SkCanvas* canvas) {
+        sk_sp<SkImage> image = make_checker_image();
+        SkPaint paint;
+        paint.setAlphaf(0.75f);
+        paint.setFilterQuality(kLow_SkFilterQuality);
+        for (int i = 0; i < 4; i++) {
+            canvas->drawImageRect(image, SkRect::MakeXYWH(i * 40, 0, 40, 40), &paint);
+        }
+        paint.setAntiAlias(true);
+        canvas->rotate(10);
+        for (int i = 0; i < 4; i++) {
+            canvas->drawImageRect(image, SkRect::MakeXYWH(2, 2, 4, 4),
+                                  SkRect::MakeXYWH(i * 40 + 40, 60, 40, 40), &paint);
+        }
+    }, SkRecordMergeDrawImageRects);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantClipRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeLTRB(10, 10, 100, 100));
+    recorder.clipRect(SkRect::MakeWH(200, 200));                    // 1: redundant
+    recorder.save();
+        recorder.translate(5, 5);
+        recorder.clipRect(SkRect::MakeWH(100, 100));                // 4: redundant
+        recorder.clipRect(SkRect::MakeWH(50, 50));
+        recorder.clipRect(SkRect::MakeWH(60, 60), true);            // 6: antialiased
+        recorder.scale(0.5f, 0.5f);
+        recorder.clipRect(SkRect::MakeWH(120, 120));                // 8: redundant
+    recorder.restore();
+    recorder.clipRect(SkRect::MakeWH(50, 50));                      // 10: cuts the clip
+    recorder.clipRect(SkRect::MakeWH(50, 50), SkClipOp::kDifference);
+    recorder.save();
+        recorder.rotate(45);
+        recorder.clipRect(SkRect::MakeWH(1000, 1000));              // 14: rotated
+    recorder.restore();
+
+    SkRecordNoopRedundantClipRects(&record);
+    assert_type<SkRecords::ClipRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 4);
+    assert_type<SkRecords::ClipRect>(r, record, 5);
+    assert_type<SkRecords::ClipRect>(r, record, 6);
+    assert_type<SkRecords::NoOp>(r, record, 8);
+    assert_type<SkRecords::ClipRect>(r, record, 10);
+    assert_type<SkRecords::ClipRect>(r, record, 11);
+    assert_type<SkRecords::ClipRect>(r, record, 14);
+}
+
 static void do_draw(SkCanvas* canvas, SkColor color, bool doLayer) {
     canvas->drawColor(SK_ColorWHITE);
 
@@ -97,6 +97,81 @@ DEF_TEST(Record_defrag, r) {
     assert_type<SkRecords::Restore >(r, record, 3);
 }
 
+// Moves any Translate command it sees by (1, 1).
+struct Nudge {
+    template <typename T> void operator()(T*) {}
+    void operator()(SkRecords::Translate* translate) {
+        translate->dx += 1;
+        translate->dy += 1;
+    }
+};
+
+static void assert_translate(skiatest::Reporter* r, const SkRecord& record, int index,
+                             SkScalar dx, SkScalar dy) {
+    if (auto translate = assert_type<SkRecords::Translate>(r, record, index)) {
+        REPORTER_ASSERT(r, translate->dx == dx && translate->dy == dy, "%d: (%g, %g)",
+                        index, translate->dx, translate->dy);
+    }
+}
+
+// Commands that fit in a pointer are stored in the record's own array, which moves as it grows
+// and is trimmed; they must come through all of that intact.
+DEF_TEST(Record_inline, r) {
+    SkRecord record;
+    APPEND(record, SkRecords::Save);
+    APPEND(record, SkRecords::Translate, 1, 2);
+    APPEND(record, SkRecords::NoOp);
+    APPEND(record, SkRecords::Flush);
+
+    // Mutated in place.
+    Nudge nudge;
+    record.mutate(1, nudge);
+    assert_translate(r, record, 1, 2, 3);
+
+    // Replaced, in both directions.
+    new (record.replace<SkRecords::NoOp>(1)) SkRecords::NoOp;
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    new (record.replace<SkRecords::Translate>(2)) SkRecords::Translate{3, 4};
+    assert_translate(r, record, 2, 3, 4);
+
+    // Carried along as the array is reallocated, many times over.
+    for (int i = 0; i < 1000; i++) {
+        APPEND(record, SkRecords::Translate, (SkScalar)i, (SkScalar)-i);
+    }
+    REPORTER_ASSERT(r, record.count() == 1004);
+    assert_type<SkRecords::Save >(r, record, 0);
+    assert_type<SkRecords::NoOp >(r, record, 1);
+    assert_translate(r, record, 2, 3, 4);
+    assert_type<SkRecords::Flush>(r, record, 3);
+    for (int i = 0; i < 1000; i++) {
+        assert_translate(r, record, 4 + i, (SkScalar)i, (SkScalar)-i);
+    }
+
+    // Moved down when the array is defragmented and trimmed.
+    record.defrag();
+    REPORTER_ASSERT(r, record.count() == 1003);
+    assert_type<SkRecords::Save >(r, record, 0);
+    assert_translate(r, record, 1, 3, 4);
+    assert_type<SkRecords::Flush>(r, record, 2);
+    assert_translate(r, record, 999 + 3, 999, -999);
+}
+
+// A record of nothing but NoOps is trimmed to nothing, and can still grow again afterwards.
+DEF_TEST(Record_defragToEmpty, r) {
+    SkRecord record;
+    for (int i = 0; i < 5; i++) {
+        APPEND(record, SkRecords::NoOp);
+    }
+    record.defrag();
+    REPORTER_ASSERT(r, record.count() == 0);
+
+    APPEND(record, SkRecords::Translate, 5, 6);
+    APPEND(record, SkRecords::Save);
+    REPORTER_ASSERT(r, record.count() == 2);
+    assert_translate(r, record, 0, 5, 6);
+    assert_type<SkRecords::Save>(r, record, 1);
+}
+
 #undef APPEND
 
 template <typename T>
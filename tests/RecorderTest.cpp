@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "tests/RecordTestUtils.h"
 #include "tests/Test.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
@@ -108,3 +111,58 @@ DEF_TEST(Recorder_drawImage_takeReference, reporter) {
     }
     REPORTER_ASSERT(reporter, image->unique());
 }
+
+DEF_TEST(Recorder_internPaths, r) {
+    // Each call makes a new path, with its own storage and generation ID.
+    auto triangle = [](SkScalar size) {
+        SkPath path;
+        path.moveTo(50, 50 - size);
+        path.lineTo(50 + size, 50 + size);
+        path.lineTo(50 - size, 50 + size);
+        return path;
+    };
+    auto pathID = [&](const SkRecord& record, int index) {
+        const SkRecords::DrawPath* draw = assert_type<SkRecords::DrawPath>(r, record, index);
+        return draw ? draw->path.getGenerationID() : 0;
+    };
+
+    for (bool intern : {false, true}) {
+        SkRecord record;
+        SkRecorder recorder(&record, 100, 100);
+        recorder.setInternPaths(intern);
+        recorder.drawPath(triangle(10), SkPaint());
+        recorder.clipPath(triangle(10));
+        recorder.drawPath(triangle(10), SkPaint());
+        recorder.drawPath(triangle(20), SkPaint());
+
+        auto clip = assert_type<SkRecords::ClipPath>(r, record, 1);
+        REPORTER_ASSERT(r, (pathID(record, 0) == clip->path.getGenerationID()) == intern);
+        REPORTER_ASSERT(r, (pathID(record, 0) == pathID(record, 2)) == intern);
+        REPORTER_ASSERT(r, pathID(record, 0) != pathID(record, 3));
+    }
+
+    // Interned paths, like repeated paints, are only serialized once.
+    sk_sp<SkData> data[2];
+    SkBitmap bitmaps[2];
+    for (bool intern : {false, true}) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(100, 100, nullptr,
+                                                   intern ? SkPictureRecorder::kInternPaths_RecordFlag
+                                                          : 0);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0x40ff0000);
+        for (int i = 0; i < 20; ++i) {
+            canvas->drawPath(triangle(5 + i % 4 * 10), paint);
+        }
+        data[intern] = recorder.finishRecordingAsPicture()->serialize();
+
+        bitmaps[intern].allocN32Pixels(100, 100);
+        bitmaps[intern].eraseColor(SK_ColorWHITE);
+        SkCanvas(bitmaps[intern]).drawPicture(SkPicture::MakeFromData(data[intern].get()));
+    }
+    REPORTER_ASSERT(r, data[true]->size() < data[false]->size(), "%zu >= %zu",
+                    data[true]->size(), data[false]->size());
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[true].getPixels(), bitmaps[false].getPixels(),
+                                   bitmaps[true].computeByteSize()));
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPicture.h"
+#include "include/utils/SkRetainedDrawable.h"
+#include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+namespace {
+// A drawable that is not an SkRetainedDrawable, whose color can change.
+class ColorDrawable final : public SkDrawable {
+public:
+    void setColor(SkColor color) {
+        fColor = color;
+        this->notifyDrawingChanged();
+    }
+
+protected:
+    SkRect onGetBounds() override { return SkRect::MakeWH(10, 10); }
+    void onDraw(SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(fColor);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    }
+
+private:
+    SkColor fColor = SK_ColorRED;
+};
+}  // namespace
+
+DEF_TEST(RetainedDrawable, r) {
+    sk_sp<SkRetainedDrawable> root  = SkRetainedDrawable::Make(SkRect::MakeWH(200, 200)),
+                              child = SkRetainedDrawable::Make(SkRect::MakeWH(50, 50));
+    sk_sp<ColorDrawable> other = sk_make_sp<ColorDrawable>();
+
+    auto recordChild = [&](const SkRect& rect, SkColor color) {
+        SkPaint paint;
+        paint.setColor(color);
+        child->beginRecording()->drawRect(rect, paint);
+        child->finishRecording();
+    };
+    recordChild(SkRect::MakeLTRB(10, 10, 20, 20), SK_ColorBLUE);
+
+    SkCanvas* canvas = root->beginRecording();
+    canvas->drawColor(SK_ColorWHITE);
+    canvas->translate(100, 100);
+    canvas->drawDrawable(child.get());
+    canvas->drawDrawable(child.get(), -100, 0);
+    canvas->drawDrawable(other.get(), 50, -100);
+    root->finishRecording();
+
+    REPORTER_ASSERT(r, root->detachDirtyRect() == SkRect::MakeWH(200, 200));
+    REPORTER_ASSERT(r, root->detachDirtyRect().isEmpty());
+
+    // Recording the child again dirties its old and new content, wherever it is drawn, without
+    // recording the root again.
+    const uint32_t rootID = root->getGenerationID();
+    recordChild(SkRect::MakeLTRB(30, 30, 40, 40), SK_ColorGREEN);
+    SkRect expected = SkRect::MakeLTRB(110, 110, 140, 140);
+    expected.join(SkRect::MakeLTRB(10, 110, 40, 140));
+    REPORTER_ASSERT(r, root->detachDirtyRect() == expected);
+    REPORTER_ASSERT(r, root->getGenerationID() == rootID);
+
+    child->invalidate(SkRect::MakeLTRB(1, 2, 3, 4));
+    REPORTER_ASSERT(r, root->detachDirtyRect() == SkRect::MakeLTRB(1, 102, 103, 104));
+
+    // Other drawables dirty their whole bounds when their generation ID changes.
+    other->setColor(SK_ColorBLACK);
+    REPORTER_ASSERT(r, root->detachDirtyRect() == SkRect::MakeLTRB(150, 0, 160, 10));
+    REPORTER_ASSERT(r, root->detachDirtyRect().isEmpty());
+
+    // The root draws its children as they are now, as do its snapshots.
+    SkBitmap actual, snapshot, reference;
+    for (SkBitmap* bitmap : {&actual, &snapshot, &reference}) {
+        bitmap->allocN32Pixels(200, 200);
+        bitmap->eraseColor(SK_ColorTRANSPARENT);
+    }
+    SkCanvas(actual).drawDrawable(root.get());
+    SkCanvas(snapshot).drawPicture(sk_sp<SkPicture>(root->newPictureSnapshot()));
+    {
+        SkCanvas canvas(reference);
+        canvas.drawColor(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setColor(SK_ColorGREEN);
+        canvas.drawRect(SkRect::MakeLTRB(130, 130, 140, 140), paint);
+        canvas.drawRect(SkRect::MakeLTRB(30, 130, 40, 140), paint);
+        paint.setColor(SK_ColorBLACK);
+        canvas.drawRect(SkRect::MakeLTRB(150, 0, 160, 10), paint);
+    }
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(actual, reference));
+    REPORTER_ASSERT(r, ToolUtils::equal_pixels(snapshot, reference));
+
+    // Recording the root again dirties its old and new content.
+    root->beginRecording()->drawRect(SkRect::MakeLTRB(0, 0, 10, 10), SkPaint());
+    root->finishRecording();
+    REPORTER_ASSERT(r, root->detachDirtyRect() == SkRect::MakeWH(200, 200));
+}
@@ -13,6 +13,8 @@
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/effects/SkPerlinNoiseShader.h"
+#include "src/core/SkNormalSource.h"
+#include "src/shaders/SkLightingShader.h"
 #include "tests/Test.h"
 
 static void check_isaimage(skiatest::Reporter* reporter, SkShader* shader,
@@ -68,3 +70,162 @@ DEF_TEST(ComposeShaderSingle, reporter) {
     rr.setRectRadii({0, 0, 0, 0}, rd);
     canvas.drawRRect(rr, p);
 }
+
+// Perlin noise is anchored to the shader's space, so translating the canvas by whole pixels
+// moves it by the same amount, whatever the span widths.
+DEF_TEST(PerlinNoiseShader_Translate, reporter) {
+    const SkISize tile = SkISize::Make(20, 15);
+    sk_sp<SkShader> shaders[] = {
+        SkPerlinNoiseShader::MakeFractalNoise(0.1f, 0.1f, 3, 0.0f),
+        SkPerlinNoiseShader::MakeTurbulence(0.05f, 0.2f, 4, 7.0f),
+        SkPerlinNoiseShader::MakeFractalNoise(0.1f, 0.05f, 5, 2.0f, &tile),
+    };
+    const int W = 37, H = 23, kDX = 5, kDY = 7;
+    for (const auto& shader : shaders) {
+        SkPaint paint;
+        paint.setShader(shader);
+
+        SkBitmap expected, translated;
+        expected.allocN32Pixels(W, H);
+        translated.allocN32Pixels(W + kDX, H + kDY);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        translated.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(expected).drawRect(SkRect::MakeWH(W, H), paint);
+        SkCanvas canvas(translated);
+        canvas.translate(kDX, kDY);
+        canvas.drawRect(SkRect::MakeWH(W, H), paint);
+
+        int mismatches = 0;
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                mismatches += *expected.getAddr32(x, y) != *translated.getAddr32(x + kDX, y + kDY);
+            }
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches, "%d mismatches", mismatches);
+    }
+}
+
+// Without octaves, fractal noise is (0.5, 0.5, 0.5, 0.5) before premultiplying, and turbulence is 0.
+DEF_TEST(PerlinNoiseShader_NoOctaves, reporter) {
+    SkBitmap bm;
+    bm.allocN32Pixels(9, 3);
+    SkPaint paint;
+
+    bm.eraseColor(SK_ColorRED);
+    paint.setShader(SkPerlinNoiseShader::MakeFractalNoise(0.1f, 0.1f, 0, 0.0f));
+    paint.setBlendMode(SkBlendMode::kSrc);
+    SkCanvas(bm).drawPaint(paint);
+    REPORTER_ASSERT(reporter, SkPreMultiplyARGB(128, 128, 128, 128) == *bm.getAddr32(4, 1),
+                    "%08x", *bm.getAddr32(4, 1));
+
+    bm.eraseColor(SK_ColorRED);
+    paint.setShader(SkPerlinNoiseShader::MakeTurbulence(0.1f, 0.1f, 0, 0.0f));
+    SkCanvas(bm).drawPaint(paint);
+    REPORTER_ASSERT(reporter, 0 == *bm.getAddr32(4, 1), "%08x", *bm.getAddr32(4, 1));
+}
+
+// Fractal noise and turbulence, drawn through their shader context and through raster pipeline,
+// against premultiplied 0xAARRGGBB values from the byte-per-channel implementation that the
+// perlin_noise stage replaced. That floored each channel to a byte before premultiplying, so the
+// stage may be off by one.
+DEF_TEST(PerlinNoiseShader_ReferenceValues, reporter) {
+    const SkISize tile = SkISize::Make(21, 17);
+    const sk_sp<SkShader> shaders[] = {
+        SkPerlinNoiseShader::MakeFractalNoise(0.05f, 0.08f, 4, 3.0f),
+        SkPerlinNoiseShader::MakeTurbulence(0.1f, 0.04f, 3, 11.0f),
+        SkPerlinNoiseShader::MakeFractalNoise(0.07f, 0.07f, 5, 0.0f, &tile),
+        SkPerlinNoiseShader::MakeTurbulence(0.06f, 0.06f, 2, 5.0f, &tile),
+    };
+    const SkIPoint points[] = {{0, 0}, {7, 3}, {19, 11}, {30, 22}, {41, 35}, {47, 39}};
+    const uint32_t expected[][2][SK_ARRAY_COUNT(points)] = {
+        {{ 0x73403b12, 0x753e2d23, 0x7a222e22, 0x7d444c47, 0x844b455f, 0xaf6e3f84 },
+         { 0x3a201e09, 0x3b1f1712, 0x3d111711, 0x3f222624, 0x42262330, 0x58372042 }},
+        {{ 0x22110507, 0x69311606, 0xa5530c26, 0x26130a04, 0x02000000, 0x42241a12 },
+         { 0x11090304, 0x35190b03, 0x532a0613, 0x130a0502, 0x01000000, 0x21120d09 }},
+        {{ 0x80263162, 0x92373b4c, 0x5d293e22, 0x78312d48, 0x613b1a3c, 0x45181629 },
+         { 0x40131931, 0x491c1e26, 0x2f151f11, 0x3c191724, 0x311e0d1e, 0x230c0b15 }},
+        {{ 0x0d030201, 0x19050403, 0x15020504, 0x0f010301, 0x3a1d0f0b, 0x512d0b0e },
+         { 0x07020101, 0x0d030202, 0x0b010302, 0x08010201, 0x1d0f0806, 0x29170607 }},
+    };
+    const uint8_t alphas[] = { 0xff, 0x80 };
+    // The legacy blitters only draw into kN32, so the other one is drawn with raster pipeline.
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType,
+        kN32_SkColorType == kBGRA_8888_SkColorType ? kRGBA_8888_SkColorType
+                                                   : kBGRA_8888_SkColorType,
+    };
+
+    for (size_t s = 0; s < SK_ARRAY_COUNT(shaders); ++s) {
+        for (size_t a = 0; a < SK_ARRAY_COUNT(alphas); ++a) {
+            for (SkColorType colorType : colorTypes) {
+                SkBitmap bm;
+                bm.allocPixels(SkImageInfo::Make(48, 40, colorType, kPremul_SkAlphaType));
+                SkCanvas canvas(bm);
+                canvas.translate(-3, 5);
+                canvas.scale(1.5f, 1.25f);
+                SkPaint paint;
+                paint.setShader(shaders[s]);
+                paint.setAlpha(alphas[a]);
+                paint.setBlendMode(SkBlendMode::kSrc);
+                canvas.drawPaint(paint);
+
+                SkBitmap pmcolors;
+                pmcolors.allocN32Pixels(bm.width(), bm.height());
+                REPORTER_ASSERT(reporter, bm.readPixels(pmcolors.pixmap()));
+                for (size_t i = 0; i < SK_ARRAY_COUNT(points); ++i) {
+                    SkPMColor pm = *pmcolors.getAddr32(points[i].x(), points[i].y());
+                    uint32_t actual = SkColorSetARGB(SkGetPackedA32(pm), SkGetPackedR32(pm),
+                                                     SkGetPackedG32(pm), SkGetPackedB32(pm));
+                    int diff = 0;
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        diff = SkTMax(diff, SkTAbs((int)((actual >> shift) & 0xff) -
+                                                   (int)((expected[s][a][i] >> shift) & 0xff)));
+                    }
+                    REPORTER_ASSERT(reporter, diff <= 1, "shader %zu alpha %02x (%d, %d): %08x",
+                                    s, alphas[a], points[i].x(), points[i].y(), actual);
+                }
+            }
+        }
+    }
+}
+
+// SkLightingShader shades its diffuse shader through a shader context, so noise must still have
+// one. Lit with only white ambient light, it should look just like an image of the same noise.
+DEF_TEST(PerlinNoiseShader_LightingDiffuse, reporter) {
+    SkLights::Builder builder;
+    builder.setAmbientLightColor(SkColor3f::Make(1, 1, 1));
+    sk_sp<SkLights> lights = builder.finish();
+
+    sk_sp<SkShader> noise[] = {
+        SkPerlinNoiseShader::MakeFractalNoise(0.1f, 0.1f, 3, 0.0f),
+        SkPerlinNoiseShader::MakeTurbulence(0.05f, 0.2f, 4, 7.0f),
+    };
+    for (const auto& shader : noise) {
+        SkBitmap image, expected, actual;
+        image.allocN32Pixels(32, 24);
+        expected.allocN32Pixels(32, 24);
+        actual.allocN32Pixels(32, 24);
+        image.eraseColor(SK_ColorTRANSPARENT);
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        actual.eraseColor(SK_ColorTRANSPARENT);
+
+        SkPaint paint;
+        paint.setShader(shader);
+        SkCanvas(image).drawPaint(paint);
+
+        paint.setShader(SkLightingShader::Make(image.makeShader(), SkNormalSource::MakeFlat(),
+                                               lights));
+        SkCanvas(expected).drawPaint(paint);
+        paint.setShader(SkLightingShader::Make(shader, SkNormalSource::MakeFlat(), lights));
+        SkCanvas(actual).drawPaint(paint);
+
+        int mismatches = 0;
+        for (int y = 0; y < 24; ++y) {
+            for (int x = 0; x < 32; ++x) {
+                mismatches += *expected.getAddr32(x, y) != *actual.getAddr32(x, y);
+            }
+        }
+        REPORTER_ASSERT(reporter, *expected.getAddr32(16, 12) != SK_ColorTRANSPARENT);
+        REPORTER_ASSERT(reporter, 0 == mismatches, "%d mismatches", mismatches);
+    }
+}
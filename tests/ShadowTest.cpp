@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkVertices.h"
 #include "include/utils/SkShadowUtils.h"
 #include "src/core/SkDrawShadowInfo.h"
@@ -175,3 +177,49 @@ DEF_TEST(ShadowBounds, reporter) {
     path.cubicTo(100, 50, 20, 100, 0, 0);
     check_bounds(reporter, path);
 }
+
+// Raster draws of a shadow whose vertices come from the tessellation cache blit a cached coverage
+// mask instead of shading the vertices. That must look the same, at any whole pixel offset.
+DEF_TEST(ShadowMaskCache, reporter) {
+    SkPath path;
+    path.addRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(0, 0, 90, 60), 6, 6));
+
+    auto draw = [&](SkScalar tx, bool isVolatile, SkColor spotColor) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(200, 150);
+        SkCanvas canvas(bitmap);
+        canvas.clear(SK_ColorWHITE);
+        canvas.translate(tx, 30);
+        // Volatile paths are always tessellated and shaded from scratch.
+        SkPath shadowPath = path;
+        shadowPath.setIsVolatile(isVolatile);
+        SkShadowUtils::DrawShadow(&canvas, shadowPath, {0, 0, 8}, {100, -100, 600}, 800,
+                                  0x40000000, spotColor,
+                                  SkShadowFlags::kTransparentOccluder_ShadowFlag);
+        return bitmap;
+    };
+    auto check = [&](const SkBitmap& a, const SkBitmap& b, int dx) {
+        int maxDiff = 0;
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = SkTMax(0, -dx); x < SkTMin(a.width(), a.width() - dx); ++x) {
+                SkColor ca = a.getColor(x, y),
+                        cb = b.getColor(x + dx, y);
+                maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetR(ca) - (int)SkColorGetR(cb)));
+                maxDiff = SkTMax(maxDiff, SkTAbs((int)SkColorGetA(ca) - (int)SkColorGetA(cb)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 3, "max difference %d", maxDiff);
+    };
+
+    for (SkColor spotColor : {SK_ColorTRANSPARENT, (SkColor)0x60000000}) {
+        SkBitmap shaded = draw(20, true, spotColor);
+        draw(20, false, spotColor);     // fills the tessellation cache
+        SkBitmap masked = draw(20, false, spotColor);
+        check(shaded, masked, 0);
+    }
+
+    // Ambient shadows are the same at every offset, so one mask serves them all.
+    SkBitmap masked = draw(20, false, SK_ColorTRANSPARENT);
+    check(masked, draw(37, false, SK_ColorTRANSPARENT), 17);
+    check(masked, draw(5, false, SK_ColorTRANSPARENT), -15);
+}
@@ -9,6 +9,7 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkStrokeRec.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkStroke.h"
 #include "tests/Test.h"
 
@@ -179,9 +180,109 @@ static void test_big_stroke(skiatest::Reporter* reporter) {
     paint.getFillPath(path, &strokeAndFillPath);
 }
 
+// Line-only paths take a separate, batched route through the stroker. Strokes polyline on its own,
+// which takes that route, and after a quad contour, which forces the general one, and checks that
+// the polyline's stroke is the same either way: it's the tail of the combined stroke.
+static void check_polyline(skiatest::Reporter* reporter, const SkPath& polyline,
+                           const SkPaint& paint) {
+    SkPath quad;
+    quad.moveTo(-50, -50);
+    quad.quadTo(-40, -70, -30, -50);
+
+    SkPath combined(quad);
+    combined.addPath(polyline);
+
+    SkPath quadStroke, polylineStroke, combinedStroke;
+    paint.getFillPath(quad, &quadStroke);
+    paint.getFillPath(polyline, &polylineStroke);
+    paint.getFillPath(combined, &combinedStroke);
+
+    const int offset = quadStroke.countPoints();
+    REPORTER_ASSERT(reporter,
+                    polylineStroke.countPoints() == combinedStroke.countPoints() - offset);
+    REPORTER_ASSERT(reporter,
+                    polylineStroke.countVerbs() ==
+                            combinedStroke.countVerbs() - quadStroke.countVerbs());
+    if (polylineStroke.countPoints() != combinedStroke.countPoints() - offset) {
+        return;
+    }
+    for (int i = 0; i < polylineStroke.countPoints(); ++i) {
+        REPORTER_ASSERT(reporter, polylineStroke.getPoint(i) == combinedStroke.getPoint(i + offset),
+                        "point %d differs", i);
+    }
+}
+
+static void test_polyline(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int iter = 0; iter < 80; ++iter) {
+        SkPath polyline;
+        polyline.moveTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+        int count = rand.nextRangeU(1, 50);
+        for (int i = 0; i < count; ++i) {
+            SkPoint last;
+            polyline.getLastPt(&last);
+            switch (rand.nextU() % 6) {
+                case 0:
+                    // Repeated points exercise the teeny line handling.
+                    polyline.lineTo(last);
+                    break;
+                case 1:
+                    // So do points that are the same within tolerance but not exactly.
+                    polyline.lineTo(last.fX, last.fY + 1e-5f);
+                    break;
+                default:
+                    polyline.lineTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+                    break;
+            }
+        }
+        if (iter & 1) {
+            polyline.close();
+        }
+
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(rand.nextRangeScalar(0.5f, 10));
+        paint.setStrokeCap((SkPaint::Cap)(iter % SkPaint::kCapCount));
+        paint.setStrokeJoin((SkPaint::Join)((iter / 3) % SkPaint::kJoinCount));
+        check_polyline(reporter, polyline, paint);
+    }
+
+    // A tail of lines that are each teeny, and get no closer to a tangent.
+    for (int cap = 0; cap < SkPaint::kCapCount; ++cap) {
+        for (bool close : { false, true }) {
+            SkPath polyline;
+            polyline.moveTo(0, 0);
+            polyline.lineTo(10, 0);
+            polyline.lineTo(10, 1e-5f);
+            polyline.lineTo(10, 2e-5f);
+            if (close) {
+                polyline.close();
+            }
+            SkPaint paint;
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(2);
+            paint.setStrokeCap((SkPaint::Cap)cap);
+            check_polyline(reporter, polyline, paint);
+        }
+    }
+
+    // Zero-length lines at the start of a contour still orient square caps.
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setStrokeCap(SkPaint::kSquare_Cap);
+    SkPath path, fillPath;
+    path.moveTo(0, 0);
+    path.lineTo(0, 0);
+    path.lineTo(10, 0);
+    paint.getFillPath(path, &fillPath);
+    REPORTER_ASSERT(reporter, equal(fillPath.getBounds(), SkRect::MakeLTRB(-1, -1, 11, 1)));
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
     test_big_stroke(reporter);
+    test_polyline(reporter);
 }
@@ -5,8 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPicture.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTime.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkPictureCommon.h"
@@ -19,6 +23,8 @@ static DEFINE_bool2(cullRect, c, true, "cullRect");
 static DEFINE_bool2(flags, f, true, "flags");
 static DEFINE_bool2(tags, t, true, "tags");
 static DEFINE_bool2(quiet, q, false, "quiet");
+static DEFINE_bool(timing, false, "Time deserializing and serializing, with and without threads");
+static DEFINE_int(threads, 0, "Threads to use for --timing, or 0 for one per core");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -31,6 +37,31 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+static void report_timings(const char* path) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(FLAGS_threads);
+    for (SkExecutor* e : {(SkExecutor*)nullptr, executor.get()}) {
+        SkDeserialProcs deserialProcs;
+        deserialProcs.fExecutor = e;
+        double start = SkTime::GetMSecs();
+        sk_sp<SkPicture> picture = SkPicture::MakeFromData(data.get(), &deserialProcs);
+        double deserialize = SkTime::GetMSecs() - start;
+        if (!picture) {
+            SkDebugf("Could not deserialize\n");
+            return;
+        }
+
+        SkSerialProcs serialProcs;
+        serialProcs.fExecutor = e;
+        start = SkTime::GetMSecs();
+        sk_sp<SkData> serialized = picture->serialize(&serialProcs);
+        double serialize = SkTime::GetMSecs() - start;
+
+        SkDebugf("%s: deserialize %.2f ms, serialize %.2f ms\n",
+                 e ? "Threaded" : "Single threaded", deserialize, serialize);
+    }
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::SetUsage("Prints information about an skp file");
     CommandLineFlags::Parse(argc, argv);
@@ -66,6 +97,10 @@ int main(int argc, char** argv) {
                  info.fCullRect.fRight, info.fCullRect.fBottom);
     }
 
+    if (FLAGS_timing && !FLAGS_quiet) {
+        report_timings(FLAGS_input[0]);
+    }
+
     bool hasData;
     if (!stream.readBool(&hasData)) { return kTruncatedFile; }
     if (!hasData) {
@@ -137,6 +172,11 @@ int main(int argc, char** argv) {
             }
             return kSuccess;       // TODO: need to store size in bytes
             break;
+        case SK_PICT_OP_INDEX_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_OP_INDEX_TAG %d\n", chunkSize);
+            }
+            break;
         case SK_PICT_BUFFER_SIZE_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_BUFFER_SIZE_TAG %d\n", chunkSize);